@@ -0,0 +1,436 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <cstddef>
+
+#ifdef _MSC_VER //Visual C++ compiler
+#include <intrin.h>
+#endif //_MSC_VER
+
+#include "LatencyHistogram.h"
+
+namespace easyTest
+{
+	//Maximum number of timing samples collected for one benchmark case
+	const size_t BENCHMARK_MAX_SAMPLES = 100;
+
+	struct BenchmarkResult
+	{
+		//All times are real times per iteration, in ns. Bytes and items per
+		//second are computed from the median time, they are 0 if the
+		//benchmark has not set any processed bytes or items per iteration.
+
+		size_t nbIterations;	//number of iterations of each sample
+		size_t nbSamples;		//0 if the benchmark has failed before completing any sample
+		double minTime;
+		double medianTime;
+		double meanTime;
+		double madTime;			//median absolute deviation
+		double maxTime;			//mean time of the slowest sample
+		double cpuTime;			//mean thread CPU time per iteration
+		double bytesPerSecond;
+		double itemsPerSecond;
+		double samples[BENCHMARK_MAX_SAMPLES];
+	};
+
+	//Repetitions of the body of latency asserts (ASSERT_P99_BELOW, etc...).
+	//Warm-up runs are executed first and never measured. When
+	//outlierThreshold is greater than 0, the runs lasting more than
+	//median + outlierThreshold * MAD (median absolute deviation) are
+	//discarded before computing the checked percentile, otherwise all runs
+	//are kept.
+	struct LatencyOptions
+	{
+		size_t nbWarmupRuns;
+		size_t nbRuns;
+		double outlierThreshold;
+	};
+
+	const LatencyOptions DEFAULT_LATENCY_OPTIONS = {5, 100, 0.0};
+
+	typedef void (*LatencyBody)(const void* pUserData);
+
+	//Complexity classes fitted to the times of range benchmark cases, from
+	//the lowest to the highest. ANY means that no complexity is expected or
+	//that the times cannot be fitted.
+	enum struct Complexity : unsigned char
+	{
+		O_1,
+		O_LOG_N,
+		O_N,
+		O_N_LOG_N,
+		O_N_SQUARED,
+		ANY
+	};
+
+	//Maximum number of input sizes measured by one range benchmark case
+	const size_t BENCHMARK_MAX_RANGES = 64;
+
+	//Measure of one input size of a range benchmark case, times are real
+	//times per iteration in ns
+	struct RangeMeasure
+	{
+		size_t range;
+		size_t nbIterations;	//number of iterations of each sample
+		size_t nbSamples;
+		double medianTime;
+		double meanTime;
+		double cpuTime;			//mean thread CPU time per iteration
+	};
+
+	struct ComplexityResult
+	{
+		//Median times are fitted to coefficient * f(range) for each
+		//complexity class f, the best fit is the class with the lowest RMS
+		//error. Each error is relative to the median time of its range.
+
+		size_t nbRanges;		//0 if the benchmark has failed before completing any range
+		RangeMeasure ranges[BENCHMARK_MAX_RANGES];
+		Complexity bestFit;		//ANY if less than 2 ranges have been measured
+		double coefficient;		//in ns
+		double cpuCoefficient;	//mean CPU times fitted with the best fit class, in ns
+		double rms;
+		Complexity expected;
+	};
+
+	//Maximum number of threads of a scaling benchmark case, which measures
+	//1, 2, 4 ... threads up to its maximum number of threads (at most
+	//BENCHMARK_MAX_THREAD_COUNTS thread counts)
+	const unsigned int BENCHMARK_MAX_THREADS = 1024;
+	const size_t BENCHMARK_MAX_THREAD_COUNTS = 11;
+
+	//Measure of one thread count of a scaling benchmark case, throughputs
+	//are in iterations per second
+	struct ScalingMeasure
+	{
+		unsigned int nbThreads;
+		size_t nbIterations;		//total of all threads
+		size_t minThreadIterations;
+		size_t maxThreadIterations;
+		double realTime;			//longest iteration loop of all threads, in ns
+		double cpuTime;				//mean thread CPU time per iteration, in ns
+		double throughput;			//sum of the throughputs of all threads
+		double threadThroughput;	//mean throughput of one thread
+		double efficiency;			//throughput / (nbThreads * throughput of 1 thread)
+		double fairness;			//minThreadIterations / maxThreadIterations
+	};
+
+	struct ScalingResult
+	{
+		size_t nbMeasures;			//0 if the benchmark has failed before completing any thread count
+		ScalingMeasure measures[BENCHMARK_MAX_THREAD_COUNTS];
+	};
+
+	//Cache state of the measured iterations of a benchmark case. COLD cases
+	//are measured twice: once with warm caches like any benchmark case, then
+	//with data caches evicted before each iteration.
+	enum struct CacheMode : unsigned char
+	{
+		WARM,
+		COLD
+	};
+
+	//Maximum number of rounds of an A/B benchmark case, each round running
+	//one batch of iterations of each of its two bodies
+	const size_t BENCHMARK_MAX_AB_ROUNDS = 50;
+
+	//A body of an A/B benchmark case is only reported as faster than the
+	//other one when the confidence interval of their time ratio excludes 1
+	enum struct ABVerdict : unsigned char
+	{
+		SAME,
+		A_FASTER,
+		B_FASTER
+	};
+
+	//Measure of one body of an A/B benchmark case, times are real times per
+	//iteration in ns
+	struct ABMeasure
+	{
+		const char* name;		//name of the benchmark case of the body
+		size_t nbIterations;	//number of iterations of each batch
+		double medianTime;
+		double meanTime;
+		double cpuTime;			//mean thread CPU time per iteration
+	};
+
+	struct ABResult
+	{
+		//Each round gives the ratio of the times per iteration of its two
+		//batches, B / A, so that ratios greater than 1 mean A is faster.
+		//The ratio is the median of all rounds, within a distribution-free
+		//95% confidence interval.
+
+		size_t nbRounds;		//0 if any of the bodies has failed before completing all rounds
+		ABMeasure a;
+		ABMeasure b;
+		double ratio;
+		double lowRatio;
+		double highRatio;
+		ABVerdict verdict;
+	};
+
+	class TestSuite;
+	class BenchmarkState;
+	struct ScalingSync;
+	struct ScalingThread;
+
+	typedef bool (*BenchmarkBody)(TestSuite* pSuite, const void* pUserData, BenchmarkState& state);
+
+	//State of one batch of benchmark iterations. The runner first calibrates
+	//the number of iterations so that a batch lasts long enough to be
+	//measured accurately, then it calls the benchmark body once per sample.
+	//The body must loop until keepRunning() returns false:
+	//
+	//    while (state.keepRunning())
+	//        doNotOptimize(computeSomething());
+	//
+	//Only the loop is timed: timing starts on the first keepRunning() call
+	//and stops when it returns false. Any work done before or after the loop
+	//is not measured.
+	class BenchmarkState final
+	{
+	public:
+		bool keepRunning()
+		{
+			if (m_nbRemaining)
+			{
+				m_nbRemaining--;
+				return true;
+			}
+
+			return nextStep();
+		}
+
+		//Excludes some per-iteration work (data reset for instance) from the
+		//measured time. Each call costs a few clock reads, so the excluded
+		//work should be much longer than that.
+		void pauseTiming();
+		void resumeTiming();
+
+		//0 for scaling benchmark cases, which run until a deadline
+		size_t getNbIterations() const
+		{
+			return m_nbIterations;
+		}
+
+		//Input size of a range benchmark case, 0 for other benchmark cases
+		size_t getRange() const
+		{
+			return m_range;
+		}
+
+		//Index of the calling thread and number of threads running the body
+		//of a scaling benchmark case, 0 and 1 for other benchmark cases
+		unsigned int getThreadIdx() const
+		{
+			return m_threadIdx;
+		}
+
+		unsigned int getNbThreads() const
+		{
+			return m_nbThreads;
+		}
+
+		void setBytesPerIteration(size_t nbBytes)
+		{
+			m_bytesPerIteration = nbBytes;
+		}
+
+		void setItemsPerIteration(size_t nbItems)
+		{
+			m_itemsPerIteration = nbItems;
+		}
+
+		//Records a latency (or any duration) in ns in the latency histogram
+		//of the benchmark case, whose percentiles are reported by all output
+		//formats. Only the samples of ordinary benchmark cases are recorded:
+		//calibration runs, range and scaling benchmark cases ignore it.
+		void recordLatency(long long time)
+		{
+			if (m_pLatencies)
+				m_pLatencies->record(time);
+		}
+
+		//Records the time of each iteration of the loop in the latency
+		//histogram, must be called before the loop. Each iteration then
+		//costs one more clock read, which is included in the recorded and
+		//measured times.
+		void recordIterationLatencies()
+		{
+			if (!m_bStarted)
+				m_bRecordIterations = (m_pLatencies != nullptr);
+		}
+
+		//Number of significant decimal digits of the latency histogram (see
+		//LatencyHistogram), must be the same in all runs of the body as
+		//changing it removes the recorded latencies
+		void setLatencyPrecision(int precision)
+		{
+			if (m_pLatencies)
+				m_pLatencies->setPrecision(precision);
+		}
+
+		//Calibrates and runs the benchmark body, then fills result.
+		//Returns false as soon as the body returns false or does not
+		//complete its iteration loop. The latencies recorded by the samples
+		//are added to pLatencies if it is not nullptr.
+		static bool run(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, BenchmarkResult& result, LatencyHistogram* pLatencies = nullptr);
+
+		//Calibrates and runs the benchmark body for each input size from
+		//minRange to maxRange (both included, multiplied by multiplier at
+		//each step), then fits the complexity of the median times. The
+		//benchmark target time is shared by all ranges. Returns false as
+		//soon as the body fails or if the range parameters are invalid
+		//(minRange is 0, maxRange is lower than minRange or multiplier is
+		//lower than 2). result.expected is not modified.
+		static bool runRange(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t minRange, size_t maxRange, size_t multiplier, ComplexityResult& result);
+
+		//Runs the benchmark body concurrently on 1, 2, 4 ... threads up to
+		//maxThreads (0 for the number of CPUs the calling thread may run
+		//on). For each thread count, the calling thread runs the body as
+		//thread 0 and extra threads are created for the others. All threads
+		//enter their loop through a spin barrier and stop on a shared
+		//deadline, the benchmark target time being shared by all thread
+		//counts. Returns false as soon as the body fails in any thread or if
+		//the threads cannot be created.
+		static bool runScaling(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, unsigned int maxThreads, ScalingResult& result);
+
+		//Runs the benchmark body with cold data caches and fills result. Each
+		//sample is one iteration, before which the data caches are evicted
+		//by streaming over a buffer larger than the last level cache. The
+		//eviction is not measured. The first iteration, which may include
+		//one-time initializations, is not kept. The benchmark target time
+		//bounds the number of samples, eviction included. Returns false as
+		//soon as the body fails or if the buffer cannot be allocated.
+		static bool runCold(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, BenchmarkResult& result);
+
+		//Runs bodyA and bodyB alternately by batches of iterations, one batch
+		//of each per round (A first in even rounds, B first in odd ones),
+		//and fills result. Both bodies are calibrated separately so that
+		//their batches are short and last about as long, then the calling
+		//thread is pinned to its current CPU until the last round, so that
+		//both bodies run on the same core and frequency or thermal drifts
+		//affect them the same way. The benchmark target time is shared by
+		//both bodies. Returns false as soon as any of the bodies fails.
+		static bool runAB(TestSuite* pSuite, BenchmarkBody bodyA, const char* nameA, BenchmarkBody bodyB, const char* nameB, const void* pUserData, ABResult& result);
+
+		//true once keepRunning() has returned false
+		bool isFinished() const
+		{
+			return m_bFinished;
+		}
+
+	private:
+		BenchmarkState(size_t nbIterations, size_t range) : m_nbIterations(nbIterations), m_range(range) {}
+		BenchmarkState(ScalingSync* pSync, unsigned int threadIdx, unsigned int nbThreads) : m_nbIterations(0), m_range(0), m_pSync(pSync), m_threadIdx(threadIdx), m_nbThreads(nbThreads) {}
+		BenchmarkState(const BenchmarkState&) = delete;
+		BenchmarkState& operator=(const BenchmarkState&) = delete;
+
+		bool nextStep();
+
+		//Iterations of scaling benchmark cases are handed out by batches
+		//which grow until the shared deadline is checked at a steady pace
+		bool nextScalingStep();
+
+		//Releases the other threads waiting for the calling one at the
+		//barriers of a scaling benchmark case when its body returns without
+		//completing its loop
+		void leaveScaling();
+
+		//Number of iterations of the batches lasting at least minSampleTime
+		//ns, sampleTime is set to the time of the last calibration batch.
+		//Returns 0 if the body fails.
+		static size_t calibrate(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t range, long long minSampleTime, long long& sampleTime);
+
+		//Calibration and samples of one benchmark run lasting about
+		//targetTime ns
+		static bool runSamples(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t range, long long targetTime, BenchmarkResult& result, LatencyHistogram* pLatencies);
+
+		const size_t m_nbIterations;
+		const size_t m_range;
+		size_t m_nbRemaining = 0;
+
+		bool m_bStarted = false;
+		bool m_bFinished = false;
+		bool m_bPaused = false;
+
+		long long m_startRealTime = 0;
+		long long m_startThreadTime = 0;
+		long long m_elapsedRealTime = 0;
+		long long m_elapsedThreadTime = 0;
+
+		size_t m_bytesPerIteration = 0;
+		size_t m_itemsPerIteration = 0;
+
+		//Latencies of the samples of ordinary benchmark cases only
+		LatencyHistogram* m_pLatencies = nullptr;
+		bool m_bRecordIterations = false;
+		size_t m_nbLatencyIterations = 0;
+		long long m_iterationStartTime = 0; //in measured time, pauses excluded
+
+		//Scaling benchmark cases only
+		ScalingSync* const m_pSync = nullptr;
+		const unsigned int m_threadIdx = 0;
+		const unsigned int m_nbThreads = 1;
+		size_t m_batchSize = 0;
+		size_t m_nbScalingIterations = 0;
+		long long m_lastCheckTime = 0;
+
+		//Cold cache benchmark cases only, evicted before the first iteration
+		unsigned char* m_evictionBuffer = nullptr;
+		size_t m_evictionSize = 0;
+
+		friend struct ScalingThread;
+	};
+
+	//doNotOptimize() forces the compiler to compute value as if it was used,
+	//and clobberMemory() forces all pending memory writes to be performed.
+	//Both prevent benchmarked code from being optimized away without adding
+	//any instruction.
+#ifdef __GNUC__ //GNU-compatible compilers: g++, mingw and clang
+	template<typename T> inline void doNotOptimize(const T& value)
+	{
+		__asm__ __volatile__("" : : "r,m"(value) : "memory");
+	}
+
+	template<typename T> inline void doNotOptimize(T& value)
+	{
+#ifdef __clang__
+		__asm__ __volatile__("" : "+r,m"(value) : : "memory");
+#else
+		__asm__ __volatile__("" : "+m,r"(value) : : "memory");
+#endif //__clang__
+	}
+
+	inline void clobberMemory()
+	{
+		__asm__ __volatile__("" : : : "memory");
+	}
+
+#elif defined(_MSC_VER) //Visual C++ compiler
+	void useCharPointer(const volatile char*);
+
+	template<typename T> inline void doNotOptimize(const T& value)
+	{
+		useCharPointer(&reinterpret_cast<const volatile char&>(value));
+		_ReadWriteBarrier();
+	}
+
+	inline void clobberMemory()
+	{
+		_ReadWriteBarrier();
+	}
+#endif //__GNUC__
+}
+
+#endif //_BENCHMARK_H_
@@ -0,0 +1,104 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _CASEMETRICS_H_
+#define _CASEMETRICS_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace easyTest
+{
+	//Maximum number of metrics recorded by one test case, further metrics
+	//are not recorded
+	const size_t MAX_CASE_METRICS = 16;
+
+	//Maximum size of a metric name, terminating null character included.
+	//Longer names are truncated.
+	const size_t MAX_METRIC_NAME_SIZE = 64;
+
+	struct CaseMetric
+	{
+		char name[MAX_METRIC_NAME_SIZE];
+		double value;
+	};
+
+	//Metrics published by one test case through RECORD_METRIC, in order of
+	//first record.
+	class CaseMetrics final
+	{
+	public:
+		CaseMetrics() = default;
+
+		void reset()
+		{
+			m_nbMetrics = 0;
+		}
+
+		size_t getNbMetrics() const
+		{
+			return m_nbMetrics;
+		}
+
+		const CaseMetric& getMetric(size_t idx) const
+		{
+			return m_metrics[idx];
+		}
+
+		//Sets the value of metric name, a metric recorded many times keeps
+		//its last value. Characters of name other than letters, digits,
+		//'_', '-', '.' and '/' are replaced by '_', so that names can be
+		//written as they are by all output formats. Returns false if name
+		//is empty, if value is not finite or if the table is full.
+		bool record(const char* name, double value)
+		{
+			if (!name || (name[0] == '\0') || !std::isfinite(value))
+				return false;
+
+			char safeName[MAX_METRIC_NAME_SIZE];
+			size_t len = 0;
+			for (; name[len] && (len < MAX_METRIC_NAME_SIZE - 1); ++len)
+			{
+				const char c = name[len];
+				const bool bSafe = ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))
+						|| (c == '_') || (c == '-') || (c == '.') || (c == '/');
+				safeName[len] = bSafe ? c : '_';
+			}
+
+			safeName[len] = '\0';
+
+			for (size_t i = 0; i < m_nbMetrics; ++i)
+			{
+				if (!std::strcmp(m_metrics[i].name, safeName))
+				{
+					m_metrics[i].value = value;
+					return true;
+				}
+			}
+
+			if (m_nbMetrics >= MAX_CASE_METRICS)
+				return false;
+
+			CaseMetric& metric = m_metrics[m_nbMetrics++];
+			std::memcpy(metric.name, safeName, len + 1);
+			metric.value = value;
+			return true;
+		}
+
+	private:
+		CaseMetrics(const CaseMetrics&) = delete;
+		CaseMetrics& operator=(const CaseMetrics&) = delete;
+
+		CaseMetric m_metrics[MAX_CASE_METRICS];
+		size_t m_nbMetrics = 0;
+	};
+}
+
+#endif //_CASEMETRICS_H_
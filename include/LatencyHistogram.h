@@ -0,0 +1,182 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _LATENCYHISTOGRAM_H_
+#define _LATENCYHISTOGRAM_H_
+
+#include <cstddef>
+
+#ifdef _MSC_VER //Visual C++ compiler
+#include <intrin.h>
+#endif //_MSC_VER
+
+namespace easyTest
+{
+	//Number of significant decimal digits kept by latency histograms
+	const int LATENCY_HISTOGRAM_MIN_PRECISION = 1;
+	const int LATENCY_HISTOGRAM_MAX_PRECISION = 3;
+	const int LATENCY_HISTOGRAM_DEFAULT_PRECISION = 2;
+
+	//Highest value recorded by default in latency histograms, greater values
+	//are recorded as this one
+	const long long LATENCY_HISTOGRAM_DEFAULT_MAX_VALUE = 3600000000000LL; //1 hour in ns
+
+	//HDR (high dynamic range) histogram of latencies, or of any positive
+	//integer values. Values are counted in buckets whose width grows with
+	//the value, so that any recorded value is known with the precision
+	//number of significant decimal digits whatever its magnitude. The counts
+	//are allocated once, on the first recorded value, and their size only
+	//depends on the precision and the maximum value (about 36 KiB with the
+	//default ones), so recording a value never allocates memory and costs a
+	//few instructions.
+	//
+	//Histograms with any layout can be merged, and serialized to a compact
+	//ASCII string which can be stored in a report and merged later, for
+	//instance to aggregate the results of several shards of a test run.
+	class LatencyHistogram final
+	{
+	public:
+		explicit LatencyHistogram(int precision = LATENCY_HISTOGRAM_DEFAULT_PRECISION, long long maxValue = LATENCY_HISTOGRAM_DEFAULT_MAX_VALUE);
+		~LatencyHistogram();
+
+		//Negative values are recorded as 0. Nothing is recorded if the
+		//counts cannot be allocated.
+		void record(long long value)
+		{
+			if (value < 0)
+				value = 0;
+			else if (value > m_maxValue)
+				value = m_maxValue;
+
+			if (!m_counts && !allocateCounts())
+				return;
+
+			m_counts[getIndex(value)]++;
+			m_totalCount++;
+			m_sum += static_cast<double>(value);
+
+			if (value < m_min)
+				m_min = value;
+
+			if (value > m_max)
+				m_max = value;
+		}
+
+		//Removes all recorded values, the counts are kept allocated
+		void reset();
+
+		//Changes the precision, clamped between LATENCY_HISTOGRAM_MIN_PRECISION
+		//and LATENCY_HISTOGRAM_MAX_PRECISION, and removes all recorded values
+		//if it is different from the current one
+		void setPrecision(int precision);
+
+		int getPrecision() const
+		{
+			return m_precision;
+		}
+
+		long long getMaxValue() const
+		{
+			return m_maxValue;
+		}
+
+		size_t getTotalCount() const
+		{
+			return m_totalCount;
+		}
+
+		//0 if no value has been recorded
+		long long getMin() const
+		{
+			return m_totalCount ? m_min : 0;
+		}
+
+		long long getMax() const
+		{
+			return m_max;
+		}
+
+		double getMean() const
+		{
+			return m_totalCount ? m_sum / m_totalCount : 0.0;
+		}
+
+		//Highest value equivalent to the value at percentile (between 0 and
+		//100) of the recorded values, never above the maximum recorded
+		//value. 0 if no value has been recorded.
+		long long getValueAtPercentile(double percentile) const;
+
+		//Adds all the values recorded by other. The values of a histogram
+		//with another layout are recorded again at the middle of their
+		//buckets. Returns false if the counts cannot be allocated.
+		bool merge(const LatencyHistogram& other);
+
+		//Writes the histogram as a null-terminated ASCII string (only digits
+		//and the '/', ':' and ',' separators) like snprintf(): the string is
+		//truncated to bufferSize - 1 characters and the returned value is
+		//its full length.
+		size_t serialize(char* buffer, size_t bufferSize) const;
+
+		//Replaces the layout and the values of the histogram by those of a
+		//serialized one. Returns false, leaving the histogram empty, if
+		//the string is invalid or if the counts cannot be allocated.
+		bool deserialize(const char* str);
+
+	private:
+		LatencyHistogram(const LatencyHistogram&) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+		//Index of the highest set bit of value, value must not be 0
+		static int getHighestBit(unsigned long long value)
+		{
+#if defined(__GNUC__)
+			return 63 - __builtin_clzll(value);
+#elif defined(_MSC_VER) //Visual C++ compiler
+			unsigned long idx = 0;
+			if (_BitScanReverse(&idx, static_cast<unsigned long>(value >> 32)))
+				return static_cast<int>(idx) + 32;
+
+			_BitScanReverse(&idx, static_cast<unsigned long>(value));
+			return static_cast<int>(idx);
+#endif //__GNUC__
+		}
+
+		//Bucket 0 holds subBucketCount unit wide sub-buckets, each next
+		//bucket holds subBucketCount / 2 sub-buckets twice wider than the
+		//previous ones
+		size_t getIndex(long long value) const
+		{
+			const int bucketIdx = getHighestBit(static_cast<unsigned long long>(value) | m_subBucketMask) - m_subBucketHalfCountMagnitude;
+			const size_t subBucketIdx = static_cast<size_t>(value >> bucketIdx);
+			return (static_cast<size_t>(bucketIdx + 1) << m_subBucketHalfCountMagnitude) + subBucketIdx - (m_subBucketMask + 1) / 2;
+		}
+
+		//Lowest value and width of the sub-bucket at index
+		long long getLowestValue(size_t index) const;
+		long long getBucketWidth(size_t index) const;
+
+		//Computes the layout from the precision and the maximum value
+		void initLayout(int precision, long long maxValue);
+		bool allocateCounts();
+
+		int m_precision = 0;
+		long long m_maxValue = 0;
+		int m_subBucketHalfCountMagnitude = 0;
+		unsigned long long m_subBucketMask = 0;
+		size_t m_nbCounts = 0;
+
+		size_t* m_counts = nullptr;
+		size_t m_totalCount = 0;
+		double m_sum = 0.0;
+		long long m_min = 0;
+		long long m_max = 0;
+	};
+}
+
+#endif //_LATENCYHISTOGRAM_H_
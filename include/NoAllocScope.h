@@ -0,0 +1,77 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _NOALLOCSCOPE_H_
+#define _NOALLOCSCOPE_H_
+
+#include <cstddef>
+
+namespace easyTest
+{
+	//Counts the heap allocations of the calling thread (operator new with
+	//new hooks, the whole malloc family with malloc hooks on Linux, nothing
+	//without allocation hooks) during the body of an ASSERT_NO_ALLOC or
+	//EXPECT_NO_ALLOC scope. The scope drives a for loop which runs the body
+	//once and then checks the count:
+	//
+	//    for (NoAllocScope scope; scope.next();)
+	//        if (scope.isChecking())
+	//            ...check scope.getNbAllocs()...
+	//        else
+	//            ...body...
+	//
+	//Leaving the body with break or return skips the check.
+	class NoAllocScope final
+	{
+	public:
+		NoAllocScope() = default;
+
+		~NoAllocScope()
+		{
+			if (m_step == 1)
+				end();
+		}
+
+		bool next()
+		{
+			if (m_step == 0)
+				begin();
+			else if (m_step == 1)
+				end();
+			else
+				return false;
+
+			m_step++;
+			return true;
+		}
+
+		bool isChecking() const
+		{
+			return (m_step == 2);
+		}
+
+		//Only valid once the body has been run
+		size_t getNbAllocs() const
+		{
+			return m_nbAllocs;
+		}
+
+	private:
+		NoAllocScope(const NoAllocScope&) = delete;
+		NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+		void begin();
+		void end();
+
+		unsigned char m_step = 0;
+		size_t m_nbAllocs = 0; //thread allocation count when the body starts, then number of allocations of the body
+	};
+}
+
+#endif //_NOALLOCSCOPE_H_
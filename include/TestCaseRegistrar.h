@@ -13,6 +13,11 @@
 namespace easyTest
 {
 	class TestSuite;
+	class BenchmarkState;
+	class BenchmarkRange;
+	class BenchmarkThreads;
+	enum struct CacheMode : unsigned char;
+
 	class TestCaseRegistrar
 	{
 	public:
@@ -29,6 +34,11 @@ namespace easyTest
 
 		virtual bool executeTest(TestSuite* pSuite) const = 0;
 
+		virtual bool isBenchmark() const
+		{
+			return false;
+		}
+
 	protected:
 		~TestCaseRegistrar() = default;
 
@@ -53,13 +63,93 @@ namespace easyTest
 			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
 		}
 
-		virtual bool executeTest(TestSuite* pSuite) const override final
+		//Implemented in TestSuite.h as it needs the full TestSuite definition
+		virtual bool executeTest(TestSuite* pSuite) const override final;
+
+	private:
+		TestCaseFunc m_testFunc = nullptr;
+	};
+
+	template<class C> class BenchmarkCaseReg final : TestCaseRegistrar
+	{
+	public:
+		typedef bool (C::*BenchmarkCaseFunc)(BenchmarkState&);
+
+		BenchmarkCaseReg(const char* testName, BenchmarkCaseFunc benchFunc) : TestCaseRegistrar(testName)
+		{
+			if (benchFunc)
+				m_benchFunc = benchFunc;
+
+			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
+		}
+
+		//Range benchmark case, pRange must outlive the registrar
+		BenchmarkCaseReg(const char* testName, BenchmarkCaseFunc benchFunc, const BenchmarkRange* pRange) : TestCaseRegistrar(testName)
 		{
-			return (m_testFunc && pSuite) ? (static_cast<C*>(pSuite)->*m_testFunc)() : false;
+			if (benchFunc)
+				m_benchFunc = benchFunc;
+
+			m_pRange = pRange;
+			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
+		}
+
+		//Scaling benchmark case, pThreads must outlive the registrar
+		BenchmarkCaseReg(const char* testName, BenchmarkCaseFunc benchFunc, const BenchmarkThreads* pThreads) : TestCaseRegistrar(testName)
+		{
+			if (benchFunc)
+				m_benchFunc = benchFunc;
+
+			m_pThreads = pThreads;
+			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
+		}
+
+		//Benchmark case measured with cold caches too if cache is
+		//CacheMode::COLD
+		BenchmarkCaseReg(const char* testName, BenchmarkCaseFunc benchFunc, CacheMode cache) : TestCaseRegistrar(testName)
+		{
+			if (benchFunc)
+				m_benchFunc = benchFunc;
+
+			m_cache = cache;
+			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
+		}
+
+		//A/B benchmark case comparing the bodies of two benchmark cases of
+		//the same suite, named nameA and nameB
+		BenchmarkCaseReg(const char* testName, BenchmarkCaseFunc benchFuncA, const char* nameA, BenchmarkCaseFunc benchFuncB, const char* nameB) : TestCaseRegistrar(testName)
+		{
+			if (benchFuncA && benchFuncB)
+			{
+				m_benchFunc = benchFuncA;
+				m_benchFuncB = benchFuncB;
+			}
+
+			m_nameA = nameA;
+			m_nameB = nameB;
+			SpecTestSuite<C>::getTestRefList().addRegistrarRef(this);
+		}
+
+		//Implemented in TestSuite.h as it needs the full TestSuite definition
+		virtual bool executeTest(TestSuite* pSuite) const override final;
+
+		virtual bool isBenchmark() const override final
+		{
+			return true;
 		}
 
 	private:
-		TestCaseFunc m_testFunc = nullptr;
+		static bool runBody(TestSuite* pSuite, const void* pUserData, BenchmarkState& state);
+		static bool runBodyB(TestSuite* pSuite, const void* pUserData, BenchmarkState& state);
+
+		BenchmarkCaseFunc m_benchFunc = nullptr;
+		const BenchmarkRange* m_pRange = nullptr;
+		const BenchmarkThreads* m_pThreads = nullptr;
+		CacheMode m_cache = CacheMode(); //WARM
+
+		//A/B benchmark cases only, body A being m_benchFunc
+		BenchmarkCaseFunc m_benchFuncB = nullptr;
+		const char* m_nameA = "";
+		const char* m_nameB = "";
 	};
 }
 
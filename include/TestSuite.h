@@ -14,22 +14,27 @@
 
 #include "TestCaseRegistrar.h"
 #include "RegistrarRefStorage.h"
+#include "Benchmark.h"
+#include "NoAllocScope.h"
+#include "TimedScope.h"
+#include "CaseMetrics.h"
+
+#ifdef __GNUC__ //GNU-compatible compilers: g++, mingw and clang
+#define EASYTEST_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER) //Visual C++ compiler
+#define EASYTEST_COLD __declspec(noinline)
+#endif //__GNUC__
 
 namespace easyTest
 {
 	class SrcInfo final
 	{
 	public:
-		SrcInfo(const char* file, const char* function, int line)
+		constexpr SrcInfo(const char* file, const char* function, int line) :
+			m_file(file ? file : ""),
+			m_function(function ? function : ""),
+			m_line((line > 0) ? static_cast<unsigned int>(line) : 0)
 		{
-			if (file)
-				m_file = file;
-
-			if (function)
-				m_function = function;
-
-			if (line > 0)
-				m_line = line;
 		}
 
 		const char* getFile() const
@@ -51,9 +56,9 @@ namespace easyTest
 		SrcInfo(const SrcInfo&) = delete;
 		SrcInfo& operator=(const SrcInfo&) = delete;
 
-		const char* m_file = "";
-		const char* m_function = "";
-		unsigned int m_line = 0;
+		const char* const m_file;
+		const char* const m_function;
+		const unsigned int m_line;
 	};
 
 	enum struct AssertType : unsigned char
@@ -86,10 +91,152 @@ namespace easyTest
 		//All data asserts return false if any of the parameters is nullptr or
 		//sizeInBytes is 0
 		HAVE_SAME_DATA,
-		HAVE_DIFFERENT_DATA
+		HAVE_DIFFERENT_DATA,
+
+		//Golden file asserts return false if the golden file path is nullptr
+		//or if data is nullptr while sizeInBytes is not 0
+		MATCH_GOLDEN_FILE,
+
+		//Digest asserts return false if data is nullptr while sizeInBytes is
+		//not 0 or if the expected digest is not a valid hexadecimal digest
+		HAS_DATA_DIGEST,
+		HAS_DATA_TREE_DIGEST,
+
+		//Latency asserts run their body repeatedly (see LatencyOptions) and
+		//compare a percentile of the measured times with a budget in ns
+		P99_BELOW,
+		MEDIAN_BELOW,
+		P99_CPU_TIME_BELOW,
+		MEDIAN_CPU_TIME_BELOW,
+
+		//No heap allocation in the body of an ASSERT_NO_ALLOC scope
+		NO_ALLOC,
+
+		//The best fit complexity of a range benchmark case is not greater
+		//than the expected one (see BENCHMARK_RANGE_IMPL)
+		HAS_COMPLEXITY
+	};
+
+	//Static description of one assert location in the source code. ASSERT_*
+	//and EXPECT_* macros declare one constant-initialized instance per
+	//expansion, so that successful asserts never have to build or pass any
+	//of this information. varBName is nullptr for unary asserts.
+	class AssertSite final
+	{
+	public:
+		constexpr AssertSite(const char* file, const char* function, int line, AssertType type, const char* varAName, const char* varBName) :
+			m_info(file, function, line),
+			m_type(type),
+			m_varAName(varAName ? varAName : ""),
+			m_varBName(varBName)
+		{
+		}
+
+		const SrcInfo& getInfo() const
+		{
+			return m_info;
+		}
+
+		AssertType getType() const
+		{
+			return m_type;
+		}
+
+		const char* getVarAName() const
+		{
+			return m_varAName;
+		}
+
+		const char* getVarBName() const
+		{
+			return m_varBName;
+		}
+
+	private:
+		AssertSite(const AssertSite&) = delete;
+		AssertSite& operator=(const AssertSite&) = delete;
+
+		const SrcInfo m_info;
+		const AssertType m_type;
+		const char* const m_varAName;
+		const char* const m_varBName;
+	};
+
+	//Input sizes and expected complexity of a range benchmark case, declared
+	//as a constant-initialized static record by BENCHMARK_RANGE_IMPL. Its
+	//assert site locates the complexity check.
+	class BenchmarkRange final
+	{
+	public:
+		constexpr BenchmarkRange(const char* file, const char* benchName, int line, size_t minRange, size_t maxRange, size_t multiplier, Complexity expected) :
+			m_site(file, benchName, line, AssertType::HAS_COMPLEXITY, benchName, nullptr),
+			m_minRange(minRange),
+			m_maxRange(maxRange),
+			m_multiplier(multiplier),
+			m_expected(expected)
+		{
+		}
+
+		const AssertSite& getSite() const
+		{
+			return m_site;
+		}
+
+		size_t getMinRange() const
+		{
+			return m_minRange;
+		}
+
+		size_t getMaxRange() const
+		{
+			return m_maxRange;
+		}
+
+		size_t getMultiplier() const
+		{
+			return m_multiplier;
+		}
+
+		Complexity getExpected() const
+		{
+			return m_expected;
+		}
+
+	private:
+		BenchmarkRange(const BenchmarkRange&) = delete;
+		BenchmarkRange& operator=(const BenchmarkRange&) = delete;
+
+		const AssertSite m_site;
+		const size_t m_minRange;
+		const size_t m_maxRange;
+		const size_t m_multiplier;
+		const Complexity m_expected;
+	};
+
+	//Maximum number of threads of a scaling benchmark case, declared as a
+	//constant-initialized static record by BENCHMARK_THREADS_IMPL
+	class BenchmarkThreads final
+	{
+	public:
+		constexpr explicit BenchmarkThreads(unsigned int maxThreads) : m_maxThreads(maxThreads)
+		{
+		}
+
+		//0 for the number of CPUs the runner thread may run on
+		unsigned int getMaxThreads() const
+		{
+			return m_maxThreads;
+		}
+
+	private:
+		BenchmarkThreads(const BenchmarkThreads&) = delete;
+		BenchmarkThreads& operator=(const BenchmarkThreads&) = delete;
+
+		const unsigned int m_maxThreads;
 	};
 
 	class ITestListener;
+	class TestRunner;
 
 	class TestSuite
 	{
@@ -106,6 +253,14 @@ namespace easyTest
 	protected:
 		void trace(const SrcInfo& info, const char* format, ...) const;
 
+		//Called by EXPECT_* macros when the assertion fails: the failure has
+		//already been reported and the test case goes on, but it will be
+		//marked as failed when it returns.
+		void setExpectFailure()
+		{
+			m_nbExpectFailures++;
+		}
+
 		bool isTrue(bool var, const char* varName, const SrcInfo& info) const
 		{
 			return unaryAssert(var, info, AssertType::IS_TRUE, varName);
@@ -163,12 +318,16 @@ namespace easyTest
 
 		template<typename T> bool areStringEqual(const T* a, const T* b, const char* aName, const char* bName, const SrcInfo& info) const
 		{
-			return binaryAssert((a && b && strEqual(a, b)), info, AssertType::ARE_STRING_EQUAL, aName, bName);
+			if (!a || !b)
+				return binaryAssert(false, info, AssertType::ARE_STRING_EQUAL, aName, bName);
+
+			const size_t mismatchIdx = strMismatch(a, b);
+			return stringAssert((mismatchIdx == NO_STRING_MISMATCH), info, AssertType::ARE_STRING_EQUAL, aName, bName, a, b, sizeof(T), mismatchIdx);
 		}
 
 		template<typename T> bool areStringDifferent(const T* a, const T* b, const char* aName, const char* bName, const SrcInfo& info) const
 		{
-			return binaryAssert((a && b && !strEqual(a, b)), info, AssertType::ARE_STRING_DIFFERENT, aName, bName);
+			return binaryAssert((a && b && (strMismatch(a, b) != NO_STRING_MISMATCH)), info, AssertType::ARE_STRING_DIFFERENT, aName, bName);
 		}
 
 		template<typename T> bool areAlmostEqual(const T& a, const T& b, const T& precision, const char* aName, const char* bName, const SrcInfo& info) const
@@ -195,7 +354,7 @@ namespace easyTest
 
 		bool haveSameData(const void* a, const void* b, size_t sizeInBytes, const char* aName, const char* bName, const SrcInfo& info) const
 		{
-			return binaryAssert((a && b && sizeInBytes && !std::memcmp(a, b, sizeInBytes)), info, AssertType::HAVE_SAME_DATA, aName, bName);
+			return dataAssert((a && b && sizeInBytes && !std::memcmp(a, b, sizeInBytes)), info, AssertType::HAVE_SAME_DATA, aName, bName, a, b, sizeInBytes);
 		}
 
 		bool haveDifferentData(const void* a, const void* b, size_t sizeInBytes, const char* aName, const char* bName, const SrcInfo& info) const
@@ -203,27 +362,329 @@ namespace easyTest
 			return binaryAssert((a && b && sizeInBytes && std::memcmp(a, b, sizeInBytes)), info, AssertType::HAVE_DIFFERENT_DATA, aName, bName);
 		}
 
-	private:
-		TestSuite(const TestSuite&) = delete;
-		TestSuite& operator=(const TestSuite&) = delete;
+		bool matchesGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, const char* varName, const SrcInfo& info) const;
+		bool hasDataDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const char* varName, const SrcInfo& info) const;
+		bool hasDataTreeDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const char* varName, const SrcInfo& info) const;
 
-		template<typename T> static bool strEqual(const T* strA, const T* strB)
+		//Same asserts as above, but all the source information comes from a
+		//static AssertSite record. On success, they only count the assert and
+		//test the condition, any failure is reported out of line.
+		bool isTrue(bool var, const AssertSite& site) const
 		{
-			while (*strA == *strB++)
+			m_nbAsserts++;
+			return var ? true : reportFailure(site);
+		}
+
+		bool isFalse(bool var, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return !var ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isNaN(const T& var, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return std::isnan(var) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isInfinite(const T& var, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return std::isinf(var) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isFinite(const T& var, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return std::isfinite(var) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isLessThan(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a < b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isLessOrEqual(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a <= b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isGreaterThan(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a > b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool isGreaterOrEqual(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a >= b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool areEqual(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a == b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool areDifferent(const T& a, const T& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a != b) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool areStringEqual(const T* a, const T* b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			if (!a || !b)
+				return reportFailure(site);
+
+			const size_t mismatchIdx = strMismatch(a, b);
+			return (mismatchIdx == NO_STRING_MISMATCH) ? true : reportStringFailure(site, a, b, sizeof(T), mismatchIdx);
+		}
+
+		template<typename T> bool areStringDifferent(const T* a, const T* b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a && b && (strMismatch(a, b) != NO_STRING_MISMATCH)) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool areAlmostEqual(const T& a, const T& b, const T& precision, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (std::abs(b - a) <= std::abs(precision)) ? true : reportFailure(site);
+		}
+
+		template<typename T> bool areVeryDifferent(const T& a, const T& b, const T& precision, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (std::abs(b - a) > std::abs(precision)) ? true : reportFailure(site);
+		}
+
+		template<typename A, typename B> bool areBitwiseEqual(const A& a, const B& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return ((sizeof(A) == sizeof(B)) && !std::memcmp(&a, &b, sizeof(A))) ? true : reportFailure(site);
+		}
+
+		template<typename A, typename B> bool areBitwiseDifferent(const A& a, const B& b, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return ((sizeof(A) != sizeof(B)) || std::memcmp(&a, &b, sizeof(A))) ? true : reportFailure(site);
+		}
+
+		bool haveSameData(const void* a, const void* b, size_t sizeInBytes, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a && b && sizeInBytes && !std::memcmp(a, b, sizeInBytes)) ? true : reportDataFailure(site, a, b, sizeInBytes);
+		}
+
+		bool haveDifferentData(const void* a, const void* b, size_t sizeInBytes, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return (a && b && sizeInBytes && std::memcmp(a, b, sizeInBytes)) ? true : reportFailure(site);
+		}
+
+		//Golden files are compared out of line, the file access largely
+		//outweighs the call.
+		bool matchesGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, const AssertSite& site) const;
+
+		//Same for digests, hashing the data largely outweighs the call
+		bool hasDataDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const AssertSite& site) const;
+		bool hasDataTreeDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const AssertSite& site) const;
+
+		//Latency asserts: the metric is given by the type of site and body is
+		//any callable object without parameters. maxTime is in ns.
+		template<typename F> bool meetsLatencyBudget(const F& body, long long maxTime, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return latencyAssert(&callLatencyBody<F>, &body, maxTime, site);
+		}
+
+		//Checks the allocation count of a scope once its body has been run
+		bool isAllocFree(const NoAllocScope& scope, const AssertSite& site) const
+		{
+			m_nbAsserts++;
+			return !scope.getNbAllocs() ? true : reportFailure(site);
+		}
+
+		//Options used by the next latency asserts of the current test case,
+		//they are reset to DEFAULT_LATENCY_OPTIONS by the TestRunner before
+		//each test case (so they can be set in setupFixture()).
+		void setLatencyOptions(size_t nbWarmupRuns, size_t nbRuns, double outlierThreshold)
+		{
+			m_latencyOptions.nbWarmupRuns = nbWarmupRuns;
+			m_latencyOptions.nbRuns = nbRuns;
+			m_latencyOptions.outlierThreshold = outlierThreshold;
+		}
+
+		const LatencyOptions& getLatencyOptions() const
+		{
+			return m_latencyOptions;
+		}
+
+		//Timings of the TIMED_SCOPE sites of the current test case, reset by
+		//the TestRunner before each test case
+		ScopeTimings& getScopeTimings()
+		{
+			return m_scopeTimings;
+		}
+
+		//Metrics published by the current test case, reset by the
+		//TestRunner before each test case
+		CaseMetrics& getMetrics()
+		{
+			return m_metrics;
+		}
+
+		//All strMismatch functions return the index of the first character
+		//which differs between strA and strB, or NO_STRING_MISMATCH if both
+		//strings are equal. Standard character types are compared using SIMD
+		//instructions when available, any other character type falls back
+		//to the generic scalar comparison.
+		static const size_t NO_STRING_MISMATCH = static_cast<size_t>(-1);
+
+		static size_t strMismatch(const char* strA, const char* strB);
+		static size_t strMismatch(const wchar_t* strA, const wchar_t* strB);
+		static size_t strMismatch(const char16_t* strA, const char16_t* strB);
+		static size_t strMismatch(const char32_t* strA, const char32_t* strB);
+
+		template<typename T> static size_t strMismatch(const T* strA, const T* strB)
+		{
+			for (size_t i = 0;; ++i)
 			{
-				if (*strA++ == 0)
-					return true;
-			}
+				if (strA[i] != strB[i])
+					return i;
 
-			return false;
+				if (strA[i] == 0)
+					return NO_STRING_MISMATCH;
+			}
 		}
 
+	private:
+		TestSuite(const TestSuite&) = delete;
+		TestSuite& operator=(const TestSuite&) = delete;
+
 		bool unaryAssert(bool condition, const SrcInfo& info, AssertType type, const char* varName) const;
 		bool binaryAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName) const;
 
+		//strA and strB must not be nullptr, charSize is the size in bytes of
+		//one character and mismatchIdx is the index of the first different
+		//character (only used if condition is false).
+		bool stringAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const;
+		void notifyStringFailure(const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const;
+
+		//dataA or dataB may be nullptr and sizeInBytes may be 0, in which case
+		//the failure is reported as a simple binary assert failure.
+		bool dataAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* dataA, const void* dataB, size_t sizeInBytes) const;
+		void notifyDataFailure(const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* dataA, const void* dataB, size_t sizeInBytes) const;
+
+		//Compares data with the golden file (or updates it in update mode)
+		//and notifies any failure, the assert must already be counted.
+		bool goldenAssert(const void* data, size_t sizeInBytes, const char* goldenPath, const SrcInfo& info, const char* varName) const;
+
+		//Computes the data digest (or tree digest) and notifies any failure,
+		//the assert must already be counted.
+		bool digestAssert(const void* data, size_t sizeInBytes, const char* expectedDigest, const SrcInfo& info, AssertType type, const char* varName) const;
+
+		template<typename F> static void callLatencyBody(const void* pBody)
+		{
+			(*static_cast<const F*>(pBody))();
+		}
+
+		//Measures the body runs and notifies any failure, the assert must
+		//already be counted.
+		bool latencyAssert(LatencyBody body, const void* pBody, long long maxTime, const AssertSite& site) const;
+
+		//Failure paths of AssertSite based asserts, they always return false
+		//and never count the assert (already done by the caller).
+		EASYTEST_COLD bool reportFailure(const AssertSite& site) const;
+		EASYTEST_COLD bool reportStringFailure(const AssertSite& site, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const;
+		EASYTEST_COLD bool reportDataFailure(const AssertSite& site, const void* dataA, const void* dataB, size_t sizeInBytes) const;
+
 		ITestListener* m_pTestListener = nullptr;
 		unsigned int m_workerThreadIdx = 0;
+
+		//A test suite instance is only used by one worker thread at a time,
+		//so the per test case state below (counters, results, timed scopes
+		//and metrics) needs neither synchronization nor allocation. This
+		//only holds for the thread running the test case: extra threads of
+		//BENCHMARK_THREADS bodies must not assert, expect, time scopes or
+		//record metrics, only thread 0 may.
+
+		//Reset by TestCaseReg::executeTest() before each test case
+		unsigned int m_nbExpectFailures = 0;
+
+		//Number of asserts executed (successful or not) since the last reset
+		//by the TestRunner, which is done before each test case
+		mutable size_t m_nbAsserts = 0;
+
+		//Calibrates and runs a benchmark case body, the result is kept for
+		//the TestRunner until the next test case.
+		bool runBenchmark(BenchmarkBody body, const void* pUserData);
+
+		//Result of the last benchmark case, only valid when
+		//m_bHasBenchmarkResult is true (reset by the TestRunner before each
+		//test case).
+		bool m_bHasBenchmarkResult = false;
+		BenchmarkResult m_benchmarkResult;
+
+		//Latencies recorded by the last benchmark case (reset by the
+		//TestRunner before each test case)
+		LatencyHistogram m_latencyHistogram;
+
+		//Runs a range benchmark case body for all its input sizes and
+		//checks its complexity, the result is kept for the TestRunner until
+		//the next test case.
+		bool runBenchmarkRange(BenchmarkBody body, const void* pUserData, const BenchmarkRange& range);
+
+		//Result of the last range benchmark case, only valid when
+		//m_bHasComplexityResult is true (reset by the TestRunner before each
+		//test case).
+		bool m_bHasComplexityResult = false;
+		ComplexityResult m_complexityResult;
+
+		//Runs a scaling benchmark case body on 1, 2, 4 ... threads, the
+		//result is kept for the TestRunner until the next test case.
+		bool runBenchmarkScaling(BenchmarkBody body, const void* pUserData, const BenchmarkThreads& threads);
+
+		//Result of the last scaling benchmark case, only valid when
+		//m_bHasScalingResult is true (reset by the TestRunner before each
+		//test case).
+		bool m_bHasScalingResult = false;
+		ScalingResult m_scalingResult;
+
+		//Runs a benchmark case body with warm caches, like runBenchmark(),
+		//then with cold caches. Both results are kept for the TestRunner
+		//until the next test case.
+		bool runBenchmarkCold(BenchmarkBody body, const void* pUserData);
+
+		//Cold cache result of the last benchmark case, only valid when
+		//m_bHasColdResult is true (reset by the TestRunner before each test
+		//case).
+		bool m_bHasColdResult = false;
+		BenchmarkResult m_coldResult;
+
+		//Runs the bodies of an A/B benchmark case alternately, the result is
+		//kept for the TestRunner until the next test case.
+		bool runBenchmarkAB(BenchmarkBody bodyA, const char* nameA, BenchmarkBody bodyB, const char* nameB, const void* pUserData);
+
+		//Result of the last A/B benchmark case, only valid when
+		//m_bHasABResult is true (reset by the TestRunner before each test
+		//case).
+		bool m_bHasABResult = false;
+		ABResult m_abResult;
+
+		LatencyOptions m_latencyOptions = DEFAULT_LATENCY_OPTIONS;
+		ScopeTimings m_scopeTimings;
+		CaseMetrics m_metrics;
+
 		template<class C> friend class TestSuiteReg;
+		template<class C> friend class TestCaseReg;
+		template<class C> friend class BenchmarkCaseReg;
+		friend class TestRunner;
 	};
 
 	template<class C> class TestSuiteReg;
@@ -252,8 +713,61 @@ namespace easyTest
 		}
 
 		friend TestCaseReg<C>::TestCaseReg(const char*, typename TestCaseReg<C>::TestCaseFunc);
+		friend BenchmarkCaseReg<C>::BenchmarkCaseReg(const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc);
+		friend BenchmarkCaseReg<C>::BenchmarkCaseReg(const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc, const BenchmarkRange*);
+		friend BenchmarkCaseReg<C>::BenchmarkCaseReg(const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc, const BenchmarkThreads*);
+		friend BenchmarkCaseReg<C>::BenchmarkCaseReg(const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc, CacheMode);
+		friend BenchmarkCaseReg<C>::BenchmarkCaseReg(const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc, const char*, typename BenchmarkCaseReg<C>::BenchmarkCaseFunc, const char*);
 		friend size_t TestSuiteReg<C>::getTestCaseCount() const;
+		friend size_t TestSuiteReg<C>::getBenchmarkCaseCount() const;
 	};
+
+	template<class C> bool TestCaseReg<C>::executeTest(TestSuite* pSuite) const
+	{
+		if (!m_testFunc || !pSuite)
+			return false;
+
+		//A test case fails if it returns false or if any of its EXPECT_*
+		//assertions has failed.
+		pSuite->m_nbExpectFailures = 0;
+		const bool bSuccess = (static_cast<C*>(pSuite)->*m_testFunc)();
+		return (bSuccess && !pSuite->m_nbExpectFailures);
+	}
+
+	template<class C> bool BenchmarkCaseReg<C>::executeTest(TestSuite* pSuite) const
+	{
+		if (!m_benchFunc || !pSuite)
+			return false;
+
+		//The body is called many times, any failed EXPECT_* assertion in
+		//any of these calls makes the benchmark case fail.
+		pSuite->m_nbExpectFailures = 0;
+		bool bSuccess = false;
+		if (m_pRange)
+			bSuccess = pSuite->runBenchmarkRange(&runBody, this, *m_pRange);
+		else if (m_pThreads)
+			bSuccess = pSuite->runBenchmarkScaling(&runBody, this, *m_pThreads);
+		else if (m_benchFuncB)
+			bSuccess = pSuite->runBenchmarkAB(&runBody, m_nameA, &runBodyB, m_nameB, this);
+		else if (m_cache == CacheMode::COLD)
+			bSuccess = pSuite->runBenchmarkCold(&runBody, this);
+		else
+			bSuccess = pSuite->runBenchmark(&runBody, this);
+
+		return (bSuccess && !pSuite->m_nbExpectFailures);
+	}
+
+	template<class C> bool BenchmarkCaseReg<C>::runBody(TestSuite* pSuite, const void* pUserData, BenchmarkState& state)
+	{
+		const BenchmarkCaseReg<C>* pReg = static_cast<const BenchmarkCaseReg<C>*>(pUserData);
+		return (static_cast<C*>(pSuite)->*(pReg->m_benchFunc))(state);
+	}
+
+	template<class C> bool BenchmarkCaseReg<C>::runBodyB(TestSuite* pSuite, const void* pUserData, BenchmarkState& state)
+	{
+		const BenchmarkCaseReg<C>* pReg = static_cast<const BenchmarkCaseReg<C>*>(pUserData);
+		return (static_cast<C*>(pSuite)->*(pReg->m_benchFuncB))(state);
+	}
 }
 
 #endif //_TESTSUITE_H_
@@ -34,6 +34,12 @@ namespace easyTest
 
 		virtual size_t getTestCaseCount() const = 0;
 
+		//Number of benchmark cases among the test cases
+		virtual size_t getBenchmarkCaseCount() const
+		{
+			return 0;
+		}
+
 		virtual TestSuite* createTestSuite(ITestListener* pTestListener, unsigned int workerThreadIdx) const = 0;
 		virtual void deleteTestSuite(TestSuite* p) const = 0;
 
@@ -48,6 +54,9 @@ namespace easyTest
 		}
 
 	protected:
+		//Registrars built with this constructor are not added to the test
+		//suites list, they are only used internally by the runner
+		TestSuiteRegistrar() = default;
 		~TestSuiteRegistrar() = default;
 
 	private:
@@ -71,11 +80,30 @@ namespace easyTest
 	public:
 		TestSuiteReg(const char* testSuiteName) : TestSuiteRegistrar(testSuiteName) {}
 
+		//Registrar which is not added to the test suites list, for test
+		//suites only run by a runner given an explicit list
+		TestSuiteReg() = default;
+
 		virtual size_t getTestCaseCount() const override final
 		{
 			return SpecTestSuite<C>::getTestRefList().getRegistrarCount();
 		}
 
+		virtual size_t getBenchmarkCaseCount() const override final
+		{
+			const TestCaseRegistrar** testCaseList = SpecTestSuite<C>::getTestRefList().getRegistrarList();
+			const size_t nbTestCases = SpecTestSuite<C>::getTestRefList().getRegistrarCount();
+
+			size_t nbBenchmarkCases = 0;
+			for (size_t i = 0; i < nbTestCases; ++i)
+			{
+				if (testCaseList[i] && testCaseList[i]->isBenchmark())
+					nbBenchmarkCases++;
+			}
+
+			return nbBenchmarkCases;
+		}
+
 		virtual TestSuite* createTestSuite(ITestListener* pTestListener, unsigned int workerThreadIdx) const override final
 		{
 			TestSuite* pSuite = new(std::nothrow) C();
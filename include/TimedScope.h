@@ -0,0 +1,134 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _TIMEDSCOPE_H_
+#define _TIMEDSCOPE_H_
+
+#include <cstddef>
+
+namespace easyTest
+{
+	//Maximum number of TIMED_SCOPE sites recorded for one test case, further
+	//sites are not recorded
+	const size_t MAX_TIMED_SCOPES = 16;
+
+	//Name of a TIMED_SCOPE site, declared as a constant-initialized static
+	//record whose address identifies the site
+	class TimedScopeSite final
+	{
+	public:
+		constexpr TimedScopeSite(const char* name) : m_name(name ? name : "")
+		{
+		}
+
+		const char* getName() const
+		{
+			return m_name;
+		}
+
+	private:
+		TimedScopeSite(const TimedScopeSite&) = delete;
+		TimedScopeSite& operator=(const TimedScopeSite&) = delete;
+
+		const char* const m_name;
+	};
+
+	//Accumulated times of one site, in ns. Nested scopes are timed
+	//independently, the time of an outer scope includes the inner ones.
+	struct ScopeTiming
+	{
+		const TimedScopeSite* pSite;
+		size_t nbCalls;
+		long long realTime;
+		long long threadTime;
+	};
+
+	//Timings of the TIMED_SCOPE sites run by one test case, in order of first
+	//run. Sites are looked up by address.
+	class ScopeTimings final
+	{
+	public:
+		ScopeTimings() = default;
+
+		void reset()
+		{
+			m_nbScopes = 0;
+		}
+
+		size_t getNbScopes() const
+		{
+			return m_nbScopes;
+		}
+
+		const ScopeTiming& getScope(size_t idx) const
+		{
+			return m_scopes[idx];
+		}
+
+		//Returns the timing of site, added to the table on its first run.
+		//Returns nullptr if the site is not in the table and the table is
+		//full.
+		ScopeTiming* find(const TimedScopeSite* pSite)
+		{
+			for (size_t i = 0; i < m_nbScopes; ++i)
+			{
+				if (m_scopes[i].pSite == pSite)
+					return &m_scopes[i];
+			}
+
+			if (m_nbScopes >= MAX_TIMED_SCOPES)
+				return nullptr;
+
+			ScopeTiming& timing = m_scopes[m_nbScopes++];
+			timing.pSite = pSite;
+			timing.nbCalls = 0;
+			timing.realTime = timing.threadTime = 0;
+			return &timing;
+		}
+
+	private:
+		ScopeTimings(const ScopeTimings&) = delete;
+		ScopeTimings& operator=(const ScopeTimings&) = delete;
+
+		ScopeTiming m_scopes[MAX_TIMED_SCOPES];
+		size_t m_nbScopes = 0;
+	};
+
+	//Adds the real and thread CPU times elapsed between its construction and
+	//its destruction to the timing of its site. It must be destroyed by the
+	//thread which has created it.
+	class TimedScope final
+	{
+	public:
+		TimedScope(ScopeTimings& timings, const TimedScopeSite& site) : m_pTiming(timings.find(&site))
+		{
+			if (m_pTiming)
+				start();
+		}
+
+		~TimedScope()
+		{
+			if (m_pTiming)
+				stop();
+		}
+
+	private:
+		TimedScope(const TimedScope&) = delete;
+		TimedScope& operator=(const TimedScope&) = delete;
+
+		void start();
+		void stop();
+
+		ScopeTiming* const m_pTiming;
+		long long m_startRealTime = 0;
+		long long m_startThreadTime = 0;
+	};
+}
+
+#endif //_TIMEDSCOPE_H_
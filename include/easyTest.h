@@ -36,40 +36,195 @@
 	static const easyTest::TestCaseReg<suiteName> s_##suiteName##_##testName##_Reg(#testName, &suiteName::testName);\
 	bool suiteName::testName()
 
+//A benchmark case is run many times, see BenchmarkState in Benchmark.h. Its
+//body gets a BenchmarkState& parameter named state and, like any test case,
+//it must return true on success and false on failure.
+#define BENCHMARK_CASE(name) public: bool name(easyTest::BenchmarkState& state)
+
+#define BENCHMARK_IMPL(suiteName, benchName)\
+	static const easyTest::BenchmarkCaseReg<suiteName> s_##suiteName##_##benchName##_Reg(#benchName, &suiteName::benchName);\
+	bool suiteName::benchName(easyTest::BenchmarkState& state)
+
+//A range benchmark case is declared with BENCHMARK_CASE and measured once per
+//input size, from minRange to maxRange (both included) multiplied by
+//multiplier at each step. Its body gets the current input size with
+//state.getRange(). The measured times are fitted to complexity classes and
+//the case fails if the best fit is greater than complexity: O_1, O_LOG_N,
+//O_N, O_N_LOG_N, O_N_SQUARED, or ANY for no check.
+#define BENCHMARK_RANGE_IMPL(suiteName, benchName, minRange, maxRange, multiplier, complexity)\
+	static const easyTest::BenchmarkRange s_##suiteName##_##benchName##_Range(__FILE__, #benchName, __LINE__, minRange, maxRange, multiplier, easyTest::Complexity::complexity);\
+	static const easyTest::BenchmarkCaseReg<suiteName> s_##suiteName##_##benchName##_Reg(#benchName, &suiteName::benchName, &s_##suiteName##_##benchName##_Range);\
+	bool suiteName::benchName(easyTest::BenchmarkState& state)
+
+//A scaling benchmark case is declared with BENCHMARK_CASE and its body runs
+//concurrently on 1, 2, 4 ... threads up to maxThreads (0 for the number of
+//CPUs the runner thread may run on), each thread looping until a shared
+//deadline. Its body gets the index of the calling thread with
+//state.getThreadIdx() and the number of threads with state.getNbThreads().
+//Assertions must only be used by thread 0.
+#define BENCHMARK_THREADS_IMPL(suiteName, benchName, maxThreads)\
+	static const easyTest::BenchmarkThreads s_##suiteName##_##benchName##_Threads(maxThreads);\
+	static const easyTest::BenchmarkCaseReg<suiteName> s_##suiteName##_##benchName##_Reg(#benchName, &suiteName::benchName, &s_##suiteName##_##benchName##_Threads);\
+	bool suiteName::benchName(easyTest::BenchmarkState& state)
+
+//A cold cache benchmark case is declared with BENCHMARK_CASE and measured
+//twice: with warm caches like any benchmark case, then with its data caches
+//evicted before each iteration, so that the time of a first call after idle
+//is reported next to the steady-state one.
+#define BENCHMARK_COLD_IMPL(suiteName, benchName)\
+	static const easyTest::BenchmarkCaseReg<suiteName> s_##suiteName##_##benchName##_Reg(#benchName, &suiteName::benchName, easyTest::CacheMode::COLD);\
+	bool suiteName::benchName(easyTest::BenchmarkState& state)
+
+//An A/B benchmark case compares the bodies of two benchmark cases of the
+//same suite, declared with BENCHMARK_CASE and implemented with BENCHMARK_IMPL
+//(they are also measured as ordinary benchmark cases). Both bodies run in
+//alternating short batches on the same worker thread, pinned to one CPU, so
+//that frequency and thermal drifts affect both the same way. The case is
+//named nameA_vs_nameB and reports the median ratio of the paired batch times
+//with its 95% confidence interval, and which body is faster.
+#define BENCHMARK_AB(suiteName, nameA, nameB)\
+	static const easyTest::BenchmarkCaseReg<suiteName> s_##suiteName##_##nameA##_vs_##nameB##_Reg(#nameA "_vs_" #nameB, &suiteName::nameA, #nameA, &suiteName::nameB, #nameB)
+
 #define SRC_INFO() easyTest::SrcInfo(__FILE__, __func__, __LINE__)
 
+#define EASYTEST_CONCAT_IMPL(a, b) a##b
+#define EASYTEST_CONCAT(a, b) EASYTEST_CONCAT_IMPL(a, b)
+
+//TIMED_SCOPE(name) adds the real and thread CPU times of the rest of the
+//enclosing block to the times of its site, name being a string literal. All
+//output formats report the number of runs and total times of each site run by
+//the test case. Sites are identified by their own constant-initialized static
+//record, not by name, and must only be run by the thread running the test
+//case.
+#define TIMED_SCOPE(name)\
+	static const easyTest::TimedScopeSite EASYTEST_CONCAT(s_timedScopeSite, __LINE__)(name);\
+	const easyTest::TimedScope EASYTEST_CONCAT(easyTestTimedScope, __LINE__)(getScopeTimings(), EASYTEST_CONCAT(s_timedScopeSite, __LINE__))
+
+//RECORD_METRIC(name, value) publishes a domain metric of the test case (a
+//compression ratio, a number of rows per second...), written by all output
+//formats and saved in baseline files. A metric recorded many times keeps its
+//last value, and must only be recorded by the thread running the test case.
+#define RECORD_METRIC(name, value) getMetrics().record(name, static_cast<double>(value))
+
 #define TRACE(str) trace(SRC_INFO(), str)
 #define TRACE_FORMAT(format, ...) trace(SRC_INFO(), format, __VA_ARGS__)
 
-#define ASSERT_TRUE(var) if (!isTrue(var, #var, SRC_INFO())) return false
-#define ASSERT_FALSE(var) if (!isFalse(var, #var, SRC_INFO())) return false
+//Each assert declares its own constant-initialized AssertSite record named
+//s_assertSite, which is passed to the check call. On success, no source
+//information is built nor passed and onFailure is never executed.
+#define EASYTEST_CHECK(check, type, aName, bName, onFailure)\
+	do\
+	{\
+		static const easyTest::AssertSite s_assertSite(__FILE__, __func__, __LINE__, easyTest::AssertType::type, aName, bName);\
+		if (!(check))\
+			onFailure;\
+	} while (false)
 
-#define ASSERT_NAN(var) if (!isNaN(var, #var, SRC_INFO())) return false
-#define ASSERT_INFINITE(var) if (!isInfinite(var, #var, SRC_INFO())) return false
-#define ASSERT_FINITE(var) if (!isFinite(var, #var, SRC_INFO())) return false
+#define ASSERT_TRUE(var) EASYTEST_CHECK(isTrue(var, s_assertSite), IS_TRUE, #var, nullptr, return false)
+#define ASSERT_FALSE(var) EASYTEST_CHECK(isFalse(var, s_assertSite), IS_FALSE, #var, nullptr, return false)
 
-#define ASSERT_LESS_THAN(a, b) if (!isLessThan(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_LESS_OR_EQUAL(a, b) if (!isLessOrEqual(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_GREATER_THAN(a, b) if (!isGreaterThan(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_GREATER_OR_EQUAL(a, b) if (!isGreaterOrEqual(a, b, #a, #b, SRC_INFO())) return false
+#define ASSERT_NAN(var) EASYTEST_CHECK(isNaN(var, s_assertSite), IS_NAN, #var, nullptr, return false)
+#define ASSERT_INFINITE(var) EASYTEST_CHECK(isInfinite(var, s_assertSite), IS_INFINITE, #var, nullptr, return false)
+#define ASSERT_FINITE(var) EASYTEST_CHECK(isFinite(var, s_assertSite), IS_FINITE, #var, nullptr, return false)
 
-#define ASSERT_EQUAL(a, b) if (!areEqual(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_DIFFERENT(a, b) if (!areDifferent(a, b, #a, #b, SRC_INFO())) return false
+#define ASSERT_LESS_THAN(a, b) EASYTEST_CHECK(isLessThan(a, b, s_assertSite), IS_LESS_THAN, #a, #b, return false)
+#define ASSERT_LESS_OR_EQUAL(a, b) EASYTEST_CHECK(isLessOrEqual(a, b, s_assertSite), IS_LESS_OR_EQUAL, #a, #b, return false)
+#define ASSERT_GREATER_THAN(a, b) EASYTEST_CHECK(isGreaterThan(a, b, s_assertSite), IS_GREATER_THAN, #a, #b, return false)
+#define ASSERT_GREATER_OR_EQUAL(a, b) EASYTEST_CHECK(isGreaterOrEqual(a, b, s_assertSite), IS_GREATER_OR_EQUAL, #a, #b, return false)
+
+#define ASSERT_EQUAL(a, b) EASYTEST_CHECK(areEqual(a, b, s_assertSite), ARE_EQUAL, #a, #b, return false)
+#define ASSERT_DIFFERENT(a, b) EASYTEST_CHECK(areDifferent(a, b, s_assertSite), ARE_DIFFERENT, #a, #b, return false)
 
 //All string asserts return false if any of the parameters is nullptr
-#define ASSERT_STRING_EQUAL(a, b) if (!areStringEqual(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_STRING_DIFFERENT(a, b) if (!areStringDifferent(a, b, #a, #b, SRC_INFO())) return false
+#define ASSERT_STRING_EQUAL(a, b) EASYTEST_CHECK(areStringEqual(a, b, s_assertSite), ARE_STRING_EQUAL, #a, #b, return false)
+#define ASSERT_STRING_DIFFERENT(a, b) EASYTEST_CHECK(areStringDifferent(a, b, s_assertSite), ARE_STRING_DIFFERENT, #a, #b, return false)
 
-#define ASSERT_ALMOST_EQUAL(a, b, precision) if (!areAlmostEqual(a, b, precision, #a, #b, SRC_INFO())) return false
-#define ASSERT_VERY_DIFFERENT(a, b, precision) if (!areVeryDifferent(a, b, precision, #a, #b, SRC_INFO())) return false
+#define ASSERT_ALMOST_EQUAL(a, b, precision) EASYTEST_CHECK(areAlmostEqual(a, b, precision, s_assertSite), ARE_ALMOST_EQUAL, #a, #b, return false)
+#define ASSERT_VERY_DIFFERENT(a, b, precision) EASYTEST_CHECK(areVeryDifferent(a, b, precision, s_assertSite), ARE_VERY_DIFFERENT, #a, #b, return false)
 
-#define ASSERT_BITWISE_EQUAL(a, b) if (!areBitwiseEqual(a, b, #a, #b, SRC_INFO())) return false
-#define ASSERT_BITWISE_DIFFERENT(a, b) if (!areBitwiseDifferent(a, b, #a, #b, SRC_INFO())) return false
+#define ASSERT_BITWISE_EQUAL(a, b) EASYTEST_CHECK(areBitwiseEqual(a, b, s_assertSite), ARE_BITWISE_EQUAL, #a, #b, return false)
+#define ASSERT_BITWISE_DIFFERENT(a, b) EASYTEST_CHECK(areBitwiseDifferent(a, b, s_assertSite), ARE_BITWISE_DIFFERENT, #a, #b, return false)
 
 //All data asserts return false if any of the parameters is nullptr or
 //sizeInBytes is 0
-#define ASSERT_SAME_DATA(a, b, sizeInBytes) if (!haveSameData(a, b, sizeInBytes, #a, #b, SRC_INFO())) return false
-#define ASSERT_DIFFERENT_DATA(a, b, sizeInBytes) if (!haveDifferentData(a, b, sizeInBytes, #a, #b, SRC_INFO())) return false
+#define ASSERT_SAME_DATA(a, b, sizeInBytes) EASYTEST_CHECK(haveSameData(a, b, sizeInBytes, s_assertSite), HAVE_SAME_DATA, #a, #b, return false)
+#define ASSERT_DIFFERENT_DATA(a, b, sizeInBytes) EASYTEST_CHECK(haveDifferentData(a, b, sizeInBytes, s_assertSite), HAVE_DIFFERENT_DATA, #a, #b, return false)
+
+//Compares sizeInBytes bytes of data with the content of the goldenPath file.
+//When the runner is started with --update-golden, a golden file which does not
+//match is replaced by data and the assert succeeds.
+#define ASSERT_MATCHES_GOLDEN(data, sizeInBytes, goldenPath) EASYTEST_CHECK(matchesGoldenFile(data, sizeInBytes, goldenPath, s_assertSite), MATCH_GOLDEN_FILE, #data, nullptr, return false)
+
+//Compares the XXH64 digest of sizeInBytes bytes of data (same digest as the
+//xxhsum tool) with expectedDigest, a string of hexadecimal digits. Failures
+//always report the actual digest. The TREE variant hashes large data in
+//parallel, its digest only equals the XXH64 digest when data is not larger
+//than 4 MB.
+#define ASSERT_DATA_DIGEST(data, sizeInBytes, expectedDigest) EASYTEST_CHECK(hasDataDigest(data, sizeInBytes, expectedDigest, s_assertSite), HAS_DATA_DIGEST, #data, nullptr, return false)
+#define ASSERT_DATA_TREE_DIGEST(data, sizeInBytes, expectedDigest) EASYTEST_CHECK(hasDataTreeDigest(data, sizeInBytes, expectedDigest, s_assertSite), HAS_DATA_TREE_DIGEST, #data, nullptr, return false)
+
+//Latency asserts run body (any statement list without top-level comma, or
+//wrapped in parentheses) repeatedly and check that the p99 or median of its
+//real time or thread CPU time is not greater than maxTime (in ns). Warm-up
+//runs, number of measured runs and outlier removal are set by
+//setLatencyOptions() (see LatencyOptions in Benchmark.h).
+#define ASSERT_P99_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), P99_BELOW, #body, nullptr, return false)
+#define ASSERT_MEDIAN_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), MEDIAN_BELOW, #body, nullptr, return false)
+#define ASSERT_P99_CPU_TIME_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), P99_CPU_TIME_BELOW, #body, nullptr, return false)
+#define ASSERT_MEDIAN_CPU_TIME_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), MEDIAN_CPU_TIME_BELOW, #body, nullptr, return false)
+
+//ASSERT_NO_ALLOC { ...body... } runs its body once and fails if the body has
+//allocated heap memory on the current thread (see NoAllocScope.h). The body is
+//a normal block: leaving it with break or return skips the check.
+#define EASYTEST_NO_ALLOC_SCOPE(macroName, onFailure)\
+	for (easyTest::NoAllocScope easyTestNoAllocScope; easyTestNoAllocScope.next();)\
+		if (easyTestNoAllocScope.isChecking())\
+			EASYTEST_CHECK(isAllocFree(easyTestNoAllocScope, s_assertSite), NO_ALLOC, #macroName " scope", nullptr, onFailure);\
+		else
+
+#define ASSERT_NO_ALLOC EASYTEST_NO_ALLOC_SCOPE(ASSERT_NO_ALLOC, return false)
+
+//EXPECT_* macros check the same conditions as their ASSERT_* counterparts and
+//report failures the same way, but the test case goes on after a failure. The
+//test case is marked as failed when it returns.
+#define EXPECT_TRUE(var) EASYTEST_CHECK(isTrue(var, s_assertSite), IS_TRUE, #var, nullptr, setExpectFailure())
+#define EXPECT_FALSE(var) EASYTEST_CHECK(isFalse(var, s_assertSite), IS_FALSE, #var, nullptr, setExpectFailure())
+
+#define EXPECT_NAN(var) EASYTEST_CHECK(isNaN(var, s_assertSite), IS_NAN, #var, nullptr, setExpectFailure())
+#define EXPECT_INFINITE(var) EASYTEST_CHECK(isInfinite(var, s_assertSite), IS_INFINITE, #var, nullptr, setExpectFailure())
+#define EXPECT_FINITE(var) EASYTEST_CHECK(isFinite(var, s_assertSite), IS_FINITE, #var, nullptr, setExpectFailure())
+
+#define EXPECT_LESS_THAN(a, b) EASYTEST_CHECK(isLessThan(a, b, s_assertSite), IS_LESS_THAN, #a, #b, setExpectFailure())
+#define EXPECT_LESS_OR_EQUAL(a, b) EASYTEST_CHECK(isLessOrEqual(a, b, s_assertSite), IS_LESS_OR_EQUAL, #a, #b, setExpectFailure())
+#define EXPECT_GREATER_THAN(a, b) EASYTEST_CHECK(isGreaterThan(a, b, s_assertSite), IS_GREATER_THAN, #a, #b, setExpectFailure())
+#define EXPECT_GREATER_OR_EQUAL(a, b) EASYTEST_CHECK(isGreaterOrEqual(a, b, s_assertSite), IS_GREATER_OR_EQUAL, #a, #b, setExpectFailure())
+
+#define EXPECT_EQUAL(a, b) EASYTEST_CHECK(areEqual(a, b, s_assertSite), ARE_EQUAL, #a, #b, setExpectFailure())
+#define EXPECT_DIFFERENT(a, b) EASYTEST_CHECK(areDifferent(a, b, s_assertSite), ARE_DIFFERENT, #a, #b, setExpectFailure())
+
+#define EXPECT_STRING_EQUAL(a, b) EASYTEST_CHECK(areStringEqual(a, b, s_assertSite), ARE_STRING_EQUAL, #a, #b, setExpectFailure())
+#define EXPECT_STRING_DIFFERENT(a, b) EASYTEST_CHECK(areStringDifferent(a, b, s_assertSite), ARE_STRING_DIFFERENT, #a, #b, setExpectFailure())
+
+#define EXPECT_ALMOST_EQUAL(a, b, precision) EASYTEST_CHECK(areAlmostEqual(a, b, precision, s_assertSite), ARE_ALMOST_EQUAL, #a, #b, setExpectFailure())
+#define EXPECT_VERY_DIFFERENT(a, b, precision) EASYTEST_CHECK(areVeryDifferent(a, b, precision, s_assertSite), ARE_VERY_DIFFERENT, #a, #b, setExpectFailure())
+
+#define EXPECT_BITWISE_EQUAL(a, b) EASYTEST_CHECK(areBitwiseEqual(a, b, s_assertSite), ARE_BITWISE_EQUAL, #a, #b, setExpectFailure())
+#define EXPECT_BITWISE_DIFFERENT(a, b) EASYTEST_CHECK(areBitwiseDifferent(a, b, s_assertSite), ARE_BITWISE_DIFFERENT, #a, #b, setExpectFailure())
+
+#define EXPECT_SAME_DATA(a, b, sizeInBytes) EASYTEST_CHECK(haveSameData(a, b, sizeInBytes, s_assertSite), HAVE_SAME_DATA, #a, #b, setExpectFailure())
+#define EXPECT_DIFFERENT_DATA(a, b, sizeInBytes) EASYTEST_CHECK(haveDifferentData(a, b, sizeInBytes, s_assertSite), HAVE_DIFFERENT_DATA, #a, #b, setExpectFailure())
+
+#define EXPECT_MATCHES_GOLDEN(data, sizeInBytes, goldenPath) EASYTEST_CHECK(matchesGoldenFile(data, sizeInBytes, goldenPath, s_assertSite), MATCH_GOLDEN_FILE, #data, nullptr, setExpectFailure())
+
+#define EXPECT_DATA_DIGEST(data, sizeInBytes, expectedDigest) EASYTEST_CHECK(hasDataDigest(data, sizeInBytes, expectedDigest, s_assertSite), HAS_DATA_DIGEST, #data, nullptr, setExpectFailure())
+#define EXPECT_DATA_TREE_DIGEST(data, sizeInBytes, expectedDigest) EASYTEST_CHECK(hasDataTreeDigest(data, sizeInBytes, expectedDigest, s_assertSite), HAS_DATA_TREE_DIGEST, #data, nullptr, setExpectFailure())
+
+#define EXPECT_P99_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), P99_BELOW, #body, nullptr, setExpectFailure())
+#define EXPECT_MEDIAN_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), MEDIAN_BELOW, #body, nullptr, setExpectFailure())
+#define EXPECT_P99_CPU_TIME_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), P99_CPU_TIME_BELOW, #body, nullptr, setExpectFailure())
+#define EXPECT_MEDIAN_CPU_TIME_BELOW(body, maxTime) EASYTEST_CHECK(meetsLatencyBudget([&]() { body; }, maxTime, s_assertSite), MEDIAN_CPU_TIME_BELOW, #body, nullptr, setExpectFailure())
+
+#define EXPECT_NO_ALLOC EASYTEST_NO_ALLOC_SCOPE(EXPECT_NO_ALLOC, setExpectFailure())
 
 /**
  * Usage:
@@ -18,6 +18,25 @@ namespace easyTest
 	namespace stats
 	{
 		class CodeTimer;
+		class PerfCounters;
+		class AllocTracker;
+		class ResourceUsage;
+		class IoUsage;
+		struct BenchEnvironment;
+	}
+
+	struct BenchmarkResult;
+	struct ComplexityResult;
+	struct ScalingResult;
+	struct ABResult;
+	class ScopeTimings;
+	class CaseMetrics;
+	class LatencyHistogram;
+
+	namespace compare
+	{
+		struct DataDiffReport;
+		enum struct GoldenStatus : unsigned char;
 	}
 	class SrcInfo;
 	enum struct AssertType : unsigned char;
@@ -39,6 +58,9 @@ namespace easyTest
 		unsigned int nbMaxWorkerThreads;
 		size_t nbTotalSuites;
 		size_t nbTotalTestCases;
+		const stats::CodeTimer* pCaseOverhead; //fixed framework overhead included in each test case timer, nullptr if it cannot be measured
+		bool bOverheadSubtracted; //true if pCaseOverhead is subtracted from all test case timers
+		const stats::BenchEnvironment* pEnvironment; //machine state, nullptr if no benchmark case is run
 	};
 
 	struct TestRunnerFinishEvent
@@ -51,6 +73,7 @@ namespace easyTest
 		size_t nbTotalSuites;
 		size_t nbSuccessSuites;
 		size_t nbFailedSuites;
+		size_t nbAsserts;
 		const stats::CodeTimer* pTimer;
 	};
 
@@ -81,6 +104,7 @@ namespace easyTest
 		size_t nbTotalCases;
 		size_t nbSuccessCases;
 		size_t nbFailedCases;
+		size_t nbAsserts;
 		const stats::CodeTimer* pTimer;
 	};
 
@@ -99,7 +123,21 @@ namespace easyTest
 		const char* testSuiteName;
 		const char* testCaseName;
 		bool bSuccess;
+		size_t nbAsserts;
 		const stats::CodeTimer* pTimer;
+		const stats::ResourceUsage* pUsage;
+		const stats::IoUsage* pIo; //nullptr if I/O accounting is not enabled
+		bool bIoLimitExceeded; //the test case has failed because of its I/O, see --max-io-per-case
+		const BenchmarkResult* pBenchmark; //nullptr if the test case is not a benchmark or has not completed any sample
+		const BenchmarkResult* pColdBenchmark; //nullptr if the test case is not a cold cache benchmark or has not completed any cold sample
+		const ComplexityResult* pComplexity; //nullptr if the test case is not a range benchmark or has not completed any range
+		const ScalingResult* pScaling; //nullptr if the test case is not a scaling benchmark or has not completed any thread count
+		const ABResult* pAB; //nullptr if the test case is not an A/B benchmark or has not completed all its rounds
+		const ScopeTimings* pScopes; //nullptr if the test case has not run any TIMED_SCOPE site
+		const CaseMetrics* pMetrics; //nullptr if the test case has not recorded any metric
+		const LatencyHistogram* pLatencies; //nullptr if the test case has not recorded any latency
+		const stats::PerfCounters* pCounters; //nullptr if performance counters are not enabled
+		const stats::AllocTracker* pAllocs; //nullptr if allocation tracking is not enabled
 	};
 
 	union TestEvent
@@ -114,6 +152,33 @@ namespace easyTest
 		TestCaseFinishEvent testCaseFinish;
 	};
 
+	enum struct BaselineVerdict : unsigned char
+	{
+		UNCHANGED,			//No significant difference with the baseline
+		REGRESSION,			//Significantly slower than the baseline
+		IMPROVEMENT,		//Significantly faster than the baseline
+		NOT_ENOUGH_SAMPLES,	//Too few samples in the baseline or in this run
+		NEW_TEST			//Test case not found in the baseline
+	};
+
+	struct BaselineComparison
+	{
+		//Times are in ns: real times of ordinary test cases or real times per
+		//iteration of benchmark cases. relativeChange is the relative
+		//difference of medians (0.1 for 10% slower than the baseline) and
+		//pValue the two-sided Mann-Whitney U test p-value, both are only
+		//meaningful with UNCHANGED, REGRESSION and IMPROVEMENT verdicts.
+
+		const char* testName; //"suite::case"
+		BaselineVerdict verdict;
+		size_t nbBaselineSamples;
+		size_t nbSamples;
+		double baselineMedian;
+		double median;
+		double relativeChange;
+		double pValue;
+	};
+
 	enum struct RTErrorType : unsigned char
 	{
 		UNDEFINED_RTERROR,			//Undefined runtime error
@@ -159,6 +224,46 @@ namespace easyTest
 		//Always called from a TestSuite exectution worker-thread
 		virtual void onBinaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName) = 0;
 
+		//Called instead of onBinaryAssertFailure() when a string assert fails
+		//on two valid strings. mismatchIdx is the index of the first
+		//different character and contextA/contextB are bounded, printable and
+		//escaped excerpts of both strings around this index.
+		//Always called from a TestSuite exectution worker-thread
+		virtual void onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB) = 0;
+
+		//Called instead of onBinaryAssertFailure() when a same data assert
+		//fails on two valid memory blocks. report gives the number of
+		//differing bytes and details the first differing regions.
+		//Always called from a TestSuite exectution worker-thread
+		virtual void onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report) = 0;
+
+		//Called instead of onUnaryAssertFailure() when a golden file assert
+		//fails on valid parameters. status is never MATCH nor UPDATED and
+		//goldenSize is 0 if the golden file cannot be read. pReport is only
+		//specified with the DATA_MISMATCH status, it is nullptr otherwise.
+		//Always called from a TestSuite exectution worker-thread
+		virtual void onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport) = 0;
+
+		//Called instead of onUnaryAssertFailure() when a digest assert fails
+		//on valid data. expectedDigest is the digest string given to the
+		//assert (possibly invalid) and actualDigest is the computed digest
+		//formatted as 16 hexadecimal digits.
+		//Always called from a TestSuite exectution worker-thread
+		virtual void onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest) = 0;
+
+		//Called instead of onUnaryAssertFailure() when a latency assert goes
+		//over its budget. bodyName is the measured code, maxTime the budget
+		//and measuredTime the checked percentile (both in ns), computed over
+		//nbRuns runs minus nbOutliers discarded ones.
+		//Always called from a TestSuite exectution worker-thread
+		virtual void onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers) = 0;
+
+		//Sent for each executed test case when the runner compares timings
+		//with a baseline, after all worker-threads termination and right
+		//before the TESTRUNNER_FINISH event.
+		//Always called from the TestRunner control thread
+		virtual void onBaselineComparison(const BaselineComparison& comparison) = 0;
+
 		//The parameter exceptionDetails is only specified with the
 		//CPP_EXCEPTION type, it is nullptr for all other error types.
 		//Always called from a TestSuite exectution worker-thread
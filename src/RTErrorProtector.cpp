@@ -98,6 +98,12 @@ namespace
 		signalHandler.sa_sigaction = &signalInterceptorHandler;
 		signalHandler.sa_flags = SA_SIGINFO;
 
+		//The samples of the profiler are blocked while handling runtime
+		//errors, its handler must never run on the alternate signal stack
+		//or over a broken stack
+		sigemptyset(&signalHandler.sa_mask);
+		sigaddset(&signalHandler.sa_mask, SIGPROF);
+
 		if (m_signal == SIGSEGV)
 		{
 			//SIGSEGV signal may be emitted in response to a stack overflow
@@ -350,11 +356,17 @@ namespace
 namespace easyTest
 {
 	bool RTErrorProtector::s_hasProtectors = false;
+	std::atomic_uint RTErrorProtector::s_nbNestedProtectors = ATOMIC_VAR_INIT(0);
 
 	bool RTErrorProtector::initProtectors()
 	{
+		//A nested call keeps the installed protectors, s_hasProtectors is
+		//left untouched while other worker-threads may be reading it
 		if (s_hasProtectors)
+		{
+			s_nbNestedProtectors++;
 			return true;
+		}
 
 #ifdef __linux__
 		for (size_t i = 0; i < s_nbSignalInterceptors; ++i)
@@ -380,6 +392,12 @@ namespace easyTest
 
 	void RTErrorProtector::shutProtectors()
 	{
+		unsigned int nbNested = s_nbNestedProtectors.load();
+		while (nbNested && !s_nbNestedProtectors.compare_exchange_weak(nbNested, nbNested - 1));
+
+		if (nbNested)
+			return;
+
 		if (s_hasProtectors)
 		{
 			std::set_terminate(s_defaultTerminateHandler);
@@ -10,6 +10,8 @@
 #ifndef _RTERRORPROTECTOR_H_
 #define _RTERRORPROTECTOR_H_
 
+#include <atomic>
+
 namespace easyTest
 {
 	class TestSuite;
@@ -23,7 +25,9 @@ namespace easyTest
 	public:
 		//initProtectors() MUST be called BEFORE any test suite worker-thread
 		//creation and shutProtectors() MUST be called AFTER all these worker
-		//threads have terminated.
+		//threads have terminated. Calls can be nested (a runner started by a
+		//test case), the protectors are only removed by the shutProtectors()
+		//call matching the first initProtectors() call.
 		static bool initProtectors();
 		static void shutProtectors();
 
@@ -50,6 +54,7 @@ namespace easyTest
 		TestSuite* m_pTestSuite = nullptr;
 
 		static bool s_hasProtectors;
+		static std::atomic_uint s_nbNestedProtectors;
 	};
 }
 
@@ -10,6 +10,8 @@
 #include "TestRunner.h"
 
 #include <cassert>
+#include <new>
+#include <algorithm>
 
 #ifdef __linux__
 #ifndef EASYTEST_NO_THREADS
@@ -24,6 +26,12 @@
 #include "../include/TestSuiteRegistrar.h"
 #include "ITestListener.h"
 #include "RTErrorProtector.h"
+#include "stats/PerfCounters.h"
+#include "stats/AllocTracker.h"
+#include "stats/ResourceUsage.h"
+#include "stats/IoUsage.h"
+#include "stats/Profiler.h"
+#include "stats/BenchEnvironment.h"
 
 namespace
 {
@@ -50,6 +58,55 @@ namespace
 		return 1;
 #endif //!EASYTEST_NO_THREADS
 	}
+
+	//Number of empty test case executions measuring the framework overhead
+	const size_t OVERHEAD_CALIBRATION_RUNS = 1001;
+
+	//Empty test suite executing an empty test case, used to measure the
+	//framework overhead included in each test case timer
+	class OverheadSuite final : public easyTest::TestSuite
+	{
+	public:
+		virtual size_t getTestCaseCount() const override final
+		{
+			return 0;
+		}
+
+		virtual const easyTest::TestCaseRegistrar** getTestCaseList() const override final
+		{
+			return nullptr;
+		}
+	};
+
+	class OverheadSuiteReg final : public easyTest::TestSuiteRegistrar
+	{
+	public:
+		virtual size_t getTestCaseCount() const override final
+		{
+			return 0;
+		}
+
+		virtual easyTest::TestSuite* createTestSuite(easyTest::ITestListener*, unsigned int) const override final
+		{
+			return new(std::nothrow) OverheadSuite();
+		}
+
+		virtual void deleteTestSuite(easyTest::TestSuite* p) const override final
+		{
+			delete p;
+		}
+	};
+
+	class OverheadCaseReg final : public easyTest::TestCaseRegistrar
+	{
+	public:
+		OverheadCaseReg() : TestCaseRegistrar("") {}
+
+		virtual bool executeTest(easyTest::TestSuite*) const override final
+		{
+			return true;
+		}
+	};
 }
 
 namespace easyTest
@@ -76,17 +133,32 @@ namespace easyTest
 			return false;
 		}
 
+		//The control thread priority is raised first, so that the overhead
+		//and the noise are measured in the same conditions as test cases
+		const bool bPriorityRaised = m_bRaisePriority && stats::raiseThreadPriority();
+
+		m_bHasCaseOverhead = measureCaseOverhead();
+
 		m_pTestListener = pTestListener;
 		m_testSuiteList = testSuiteList;
 		m_nbTestSuites = nbTestSuites;
 		m_bStopRequested.store(false, std::memory_order_relaxed);
 
+		const bool bHasBenchmarkCases = hasBenchmarkCases();
+		if (bHasBenchmarkCases)
+		{
+			stats::collectBenchEnvironment(m_environment);
+			m_environment.noise = stats::measureNoise();
+			m_environment.bPriorityRaised = bPriorityRaised;
+		}
+
 #ifndef EASYTEST_NO_THREADS
 		assert(!m_nbThreads);
 		assert(!m_threadList);
 
 		m_nextTestSuiteIdx.store(0, std::memory_order_relaxed);
 		m_nbFailedTestSuites.store(0, std::memory_order_relaxed);
+		m_nbTotalAsserts.store(0, std::memory_order_relaxed);
 
 		if (nbThreads)
 		{
@@ -103,6 +175,7 @@ namespace easyTest
 #else //EASYTEST_NO_THREADS is defined
 		m_nextTestSuiteIdx = 0;
 		m_nbFailedTestSuites = 0;
+		m_nbTotalAsserts = 0;
 		nbThreads = 0;
 #endif //!EASYTEST_NO_THREADS
 
@@ -121,6 +194,9 @@ namespace easyTest
 			event.testRunnerStart.nbMaxWorkerThreads = nbThreads;
 			event.testRunnerStart.nbTotalSuites = m_nbTestSuites;
 			event.testRunnerStart.nbTotalTestCases = nbTotalTestCases;
+			event.testRunnerStart.pCaseOverhead = m_bHasCaseOverhead ? &m_caseOverhead : nullptr;
+			event.testRunnerStart.bOverheadSubtracted = m_bHasCaseOverhead && m_bSubtractOverhead;
+			event.testRunnerStart.pEnvironment = bHasBenchmarkCases ? &m_environment : nullptr;
 			m_pTestListener->onEvent(event);
 		}
 
@@ -202,10 +278,12 @@ namespace easyTest
 
 		size_t nbTestSuites = m_nextTestSuiteIdx.load(std::memory_order_relaxed);
 		const size_t nbFailedSuites = m_nbFailedTestSuites.load(std::memory_order_relaxed);
+		const size_t nbTotalAsserts = m_nbTotalAsserts.load(std::memory_order_relaxed);
 
 #else //EASYTEST_NO_THREADS is defined
 		size_t nbTestSuites = m_nextTestSuiteIdx;
 		const size_t nbFailedSuites = m_nbFailedTestSuites;
+		const size_t nbTotalAsserts = m_nbTotalAsserts;
 #endif //!EASYTEST_NO_THREADS
 
 		if (m_testSuiteList)
@@ -229,6 +307,7 @@ namespace easyTest
 					event.testRunnerFinish.nbSuccessSuites = 0;
 
 				event.testRunnerFinish.nbTotalSuites = m_nbTestSuites;
+				event.testRunnerFinish.nbAsserts = nbTotalAsserts;
 				event.testRunnerFinish.pTimer = &m_executionTimer;
 				m_pTestListener->onEvent(event);
 			}
@@ -241,6 +320,104 @@ namespace easyTest
 		return nbFailedSuites;
 	}
 
+	bool TestRunner::hasBenchmarkCases() const
+	{
+		for (size_t i = 0; i < m_nbTestSuites; ++i)
+		{
+			const TestSuiteRegistrar* pRegistrar = m_testSuiteList[i];
+			if (pRegistrar && pRegistrar->getBenchmarkCaseCount())
+				return true;
+		}
+
+		return false;
+	}
+
+	bool TestRunner::executeCase(RTErrorProtector& errorProtector, TestSuite* pTestSuite, const TestCaseRegistrar* pCaseReg, const CaseProbes& probes)
+	{
+		pTestSuite->m_nbAsserts = 0;
+		pTestSuite->m_bHasBenchmarkResult = false;
+		pTestSuite->m_latencyHistogram.reset();
+		pTestSuite->m_bHasComplexityResult = false;
+		pTestSuite->m_bHasScalingResult = false;
+		pTestSuite->m_bHasColdResult = false;
+		pTestSuite->m_bHasABResult = false;
+		pTestSuite->m_latencyOptions = DEFAULT_LATENCY_OPTIONS;
+		pTestSuite->m_scopeTimings.reset();
+		pTestSuite->m_metrics.reset();
+
+		if (probes.pCounters)
+			probes.pCounters->start();
+
+		if (probes.pAllocs)
+			probes.pAllocs->start();
+
+		const bool bSuccess = errorProtector.executeProtectedTestCase(pCaseReg);
+
+		if (probes.pAllocs)
+			probes.pAllocs->stop();
+
+		if (probes.pCounters)
+			probes.pCounters->stop();
+
+		//ASSERT_NO_ALLOC scopes interrupted by a runtime error are never
+		//closed
+		stats::resetAllocScopes();
+
+		return bSuccess;
+	}
+
+	//Times executeCase() with an empty test case, from the control thread.
+	//The medians of all measures are kept. Listener notifications, the
+	//profiler and the resource usage and I/O samples are outside of the test
+	//case timers, so they are not measured either.
+	bool TestRunner::measureCaseOverhead()
+	{
+		OverheadSuiteReg suiteReg;
+		OverheadCaseReg caseReg;
+		RTErrorProtector errorProtector(nullptr, 0);
+
+		TestSuite* pTestSuite = errorProtector.createProtectedTestSuite(&suiteReg);
+		if (!pTestSuite)
+			return false;
+
+		stats::AllocTracker allocs;
+		CaseProbes probes = {};
+		probes.pCounters = stats::arePerfCountersEnabled() ? new(std::nothrow) stats::PerfCounters() : nullptr;
+		probes.pAllocs = stats::isAllocTrackingEnabled() ? &allocs : nullptr;
+
+		long long* times = new(std::nothrow) long long[3 * OVERHEAD_CALIBRATION_RUNS];
+		bool bRet = (times != nullptr);
+		stats::CodeTimer timer;
+		for (size_t i = 0; bRet && (i < OVERHEAD_CALIBRATION_RUNS); ++i)
+		{
+			timer.start();
+			bRet = executeCase(errorProtector, pTestSuite, &caseReg, probes);
+			timer.stop();
+
+			times[i] = timer.getElapsedRealTime();
+			times[OVERHEAD_CALIBRATION_RUNS + i] = timer.getElapsedProcessTime();
+			times[2 * OVERHEAD_CALIBRATION_RUNS + i] = timer.getElapsedThreadTime();
+		}
+
+		if (bRet)
+		{
+			long long medians[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				long long* pTimes = times + i * OVERHEAD_CALIBRATION_RUNS;
+				std::nth_element(pTimes, pTimes + OVERHEAD_CALIBRATION_RUNS / 2, pTimes + OVERHEAD_CALIBRATION_RUNS);
+				medians[i] = pTimes[OVERHEAD_CALIBRATION_RUNS / 2];
+			}
+
+			bRet = m_caseOverhead.setElapsedTimes(medians[0], medians[1], medians[2]);
+		}
+
+		delete[] times;
+		delete probes.pCounters;
+		errorProtector.deleteProtectedTestSuite();
+		return bRet;
+	}
+
 	threadproc_ret _callconv TestRunner::run(void* pUserData)
 	{
 		const ThreadInfo* pInfo = static_cast<const ThreadInfo*>(pUserData);
@@ -251,11 +428,30 @@ namespace easyTest
 		assert(pRunner->m_testSuiteList);
 		assert(pRunner->m_nbTestSuites);
 
+		//Worker-threads inherit the control thread priority under Linux but
+		//not under Windows
+		if (pRunner->m_bRaisePriority)
+			stats::raiseThreadPriority();
+
 		RTErrorProtector errorProtector(pRunner->m_pTestListener, pInfo->threadIdx);
 
 		TestEvent event;
 		stats::CodeTimer suiteTimer;
 		stats::CodeTimer caseTimer;
+		stats::ResourceUsage caseUsage;
+
+		//Performance counters and the thread I/O accounting file must be
+		//opened by the thread they count
+		stats::AllocTracker caseAllocs;
+		CaseProbes probes = {};
+		probes.pCounters = stats::arePerfCountersEnabled() ? new(std::nothrow) stats::PerfCounters() : nullptr;
+		probes.pAllocs = stats::isAllocTrackingEnabled() ? &caseAllocs : nullptr;
+		stats::IoUsage* pCaseIo = stats::isIoAccountingEnabled() ? new(std::nothrow) stats::IoUsage() : nullptr;
+		const long long maxIoPerCase = stats::getMaxIoPerCase();
+
+		//The profiler samples the thread which creates it
+		stats::ThreadProfiler* pCaseProfiler = stats::isProfilingEnabled() ? new(std::nothrow) stats::ThreadProfiler() : nullptr;
+
 		for (;;)
 		{
 			bool bStopRequested = pRunner->m_bStopRequested.load(std::memory_order_relaxed);
@@ -284,6 +480,7 @@ namespace easyTest
 				const size_t nbTotalCases = pTestSuite->getTestCaseCount();
 				size_t nbSuccessCases = 0;
 				size_t nbFailedCases = 0;
+				size_t nbSuiteAsserts = 0;
 
 				if (pRunner->m_pTestListener)
 				{
@@ -307,8 +504,6 @@ namespace easyTest
 						break;
 					}
 
-					caseTimer.start();
-
 					if (pRunner->m_pTestListener)
 					{
 						event.type = TestEventType::TESTCASE_START;
@@ -316,24 +511,68 @@ namespace easyTest
 						pRunner->m_pTestListener->onEvent(event);
 					}
 
-					if (errorProtector.executeProtectedTestCase(*ppCaseReg))
-					{
-						event.testCaseFinish.bSuccess = true;
+					//The profiler, the resource usage and the I/O are
+					//sampled outside of the timer, so that their system
+					//calls are never part of the test case times. I/O are
+					//sampled after TESTCASE_START, so that the output
+					//written by the listener is not accounted.
+					if (pCaseProfiler)
+						pCaseProfiler->startCase();
+
+					if (pCaseIo)
+						pCaseIo->start();
+
+					caseUsage.start();
+					caseTimer.start();
+
+					bool bCaseSuccess = executeCase(errorProtector, pTestSuite, *ppCaseReg, probes);
+
+					caseTimer.stop();
+					caseUsage.stop();
+
+					if (pCaseIo)
+						pCaseIo->stop();
+
+					if (pCaseProfiler)
+						pCaseProfiler->stopCase(pRegistrar->getTestSuiteName(), (*ppCaseReg)->getTestName());
+
+					const bool bIoLimitExceeded = pCaseIo && (maxIoPerCase > 0) && (pCaseIo->getTotalChars() > maxIoPerCase);
+					if (bIoLimitExceeded)
+						bCaseSuccess = false;
+
+					if (bCaseSuccess)
 						nbSuccessCases++;
-					}
 					else
 					{
-						event.testCaseFinish.bSuccess = false;
 						nbFailedCases++;
 						bTestSuiteSuccess = false;
 					}
 
-					caseTimer.stop();
+					if (pRunner->m_bHasCaseOverhead && pRunner->m_bSubtractOverhead)
+						caseTimer.subtract(pRunner->m_caseOverhead);
+
+					const size_t nbCaseAsserts = pTestSuite->m_nbAsserts;
+					nbSuiteAsserts += nbCaseAsserts;
 
 					if (pRunner->m_pTestListener)
 					{
 						event.type = TestEventType::TESTCASE_FINISH;
+						event.testCaseFinish.bSuccess = bCaseSuccess;
+						event.testCaseFinish.nbAsserts = nbCaseAsserts;
 						event.testCaseFinish.pTimer = &caseTimer;
+						event.testCaseFinish.pUsage = &caseUsage;
+						event.testCaseFinish.pBenchmark = (pTestSuite->m_bHasBenchmarkResult && pTestSuite->m_benchmarkResult.nbSamples) ? &pTestSuite->m_benchmarkResult : nullptr;
+						event.testCaseFinish.pColdBenchmark = (pTestSuite->m_bHasColdResult && pTestSuite->m_coldResult.nbSamples) ? &pTestSuite->m_coldResult : nullptr;
+						event.testCaseFinish.pComplexity = (pTestSuite->m_bHasComplexityResult && pTestSuite->m_complexityResult.nbRanges) ? &pTestSuite->m_complexityResult : nullptr;
+						event.testCaseFinish.pLatencies = pTestSuite->m_latencyHistogram.getTotalCount() ? &pTestSuite->m_latencyHistogram : nullptr;
+						event.testCaseFinish.pScaling = (pTestSuite->m_bHasScalingResult && pTestSuite->m_scalingResult.nbMeasures) ? &pTestSuite->m_scalingResult : nullptr;
+						event.testCaseFinish.pAB = (pTestSuite->m_bHasABResult && pTestSuite->m_abResult.nbRounds) ? &pTestSuite->m_abResult : nullptr;
+						event.testCaseFinish.pScopes = pTestSuite->m_scopeTimings.getNbScopes() ? &pTestSuite->m_scopeTimings : nullptr;
+						event.testCaseFinish.pMetrics = pTestSuite->m_metrics.getNbMetrics() ? &pTestSuite->m_metrics : nullptr;
+						event.testCaseFinish.pCounters = probes.pCounters;
+						event.testCaseFinish.pAllocs = probes.pAllocs;
+						event.testCaseFinish.pIo = pCaseIo;
+						event.testCaseFinish.bIoLimitExceeded = bIoLimitExceeded;
 						pRunner->m_pTestListener->onEvent(event);
 					}
 				}
@@ -342,12 +581,19 @@ namespace easyTest
 
 				suiteTimer.stop();
 
+#ifndef EASYTEST_NO_THREADS
+				pRunner->m_nbTotalAsserts.fetch_add(nbSuiteAsserts, std::memory_order_relaxed);
+#else //EASYTEST_NO_THREADS is defined
+				pRunner->m_nbTotalAsserts += nbSuiteAsserts;
+#endif //!EASYTEST_NO_THREADS
+
 				if (pRunner->m_pTestListener)
 				{
 					event.type = TestEventType::TESTSUITE_FINISH;
 					event.testSuiteFinish.nbTotalCases = nbTotalCases;
 					event.testSuiteFinish.nbSuccessCases = nbSuccessCases;
 					event.testSuiteFinish.nbFailedCases = nbFailedCases;
+					event.testSuiteFinish.nbAsserts = nbSuiteAsserts;
 					event.testSuiteFinish.pTimer = &suiteTimer;
 					pRunner->m_pTestListener->onEvent(event);
 				}
@@ -369,6 +615,9 @@ namespace easyTest
 				break;
 		}
 
+		delete pCaseProfiler;
+		delete pCaseIo;
+		delete probes.pCounters;
 		return 0;
 	}
 }
@@ -35,6 +35,7 @@
 #endif
 
 #include "stats/CodeTimer.h"
+#include "stats/BenchEnvironment.h"
 
 namespace easyTest
 {
@@ -56,7 +57,16 @@ namespace easyTest
 #endif //!EASYTEST_NO_THREADS
 
 	class TestSuiteRegistrar;
+	class TestCaseRegistrar;
+	class TestSuite;
 	class ITestListener;
+	class RTErrorProtector;
+
+	namespace stats
+	{
+		class PerfCounters;
+		class AllocTracker;
+	}
 
 	class TestRunner final
 	{
@@ -78,6 +88,26 @@ namespace easyTest
 		void stopTestSuites();
 		size_t waitTestsTermination(); //returns the number of failed test suites
 
+		//The fixed framework overhead included in each test case timer
+		//(timer, fixtures and runtime error protection calls) is measured
+		//when the runner starts. When subtraction is enabled, it is removed
+		//from the times of all test cases. Must be called before
+		//startTestSuites().
+		void setCaseOverheadSubtraction(bool bSubtract)
+		{
+			m_bSubtractOverhead = bSubtract;
+		}
+
+		//Raises the scheduling priority of the control thread and of all
+		//worker-threads while test suites are running. When benchmark cases
+		//are run, the environment sent with TESTRUNNER_START tells whether
+		//the priority has actually been raised. Must be called before
+		//startTestSuites().
+		void setPriorityRaise(bool bRaise)
+		{
+			m_bRaisePriority = bRaise;
+		}
+
 	private:
 		TestRunner(const TestRunner&) = delete;
 		TestRunner& operator=(const TestRunner&) = delete;
@@ -87,6 +117,32 @@ namespace easyTest
 		ITestListener* m_pTestListener = nullptr;
 		stats::CodeTimer m_executionTimer;
 
+		bool measureCaseOverhead();
+
+		//Instruments of the calling thread sampled right around each test
+		//case, nullptr if disabled
+		struct CaseProbes
+		{
+			stats::PerfCounters* pCounters;
+			stats::AllocTracker* pAllocs;
+		};
+
+		//Resets the per test case state of pTestSuite, then executes one
+		//test case between the probes. Used by both run() and
+		//measureCaseOverhead(), so that the measured overhead is the one of
+		//real test cases.
+		static bool executeCase(RTErrorProtector& errorProtector, TestSuite* pTestSuite, const TestCaseRegistrar* pCaseReg, const CaseProbes& probes);
+
+		stats::CodeTimer m_caseOverhead;
+		bool m_bHasCaseOverhead = false;
+		bool m_bSubtractOverhead = false;
+
+		//Only collected when benchmark cases are run
+		bool hasBenchmarkCases() const;
+
+		stats::BenchEnvironment m_environment = {};
+		bool m_bRaisePriority = false;
+
 		//Even when not using threads, we need an atomic flag used to stop any
 		//running test suite when receiving an asynchronous interruption signal.
 		std::atomic_bool m_bStopRequested = ATOMIC_VAR_INIT(false);
@@ -106,10 +162,12 @@ namespace easyTest
 
 		std::atomic_size_t m_nextTestSuiteIdx = ATOMIC_VAR_INIT(0);
 		std::atomic_size_t m_nbFailedTestSuites = ATOMIC_VAR_INIT(0);
+		std::atomic_size_t m_nbTotalAsserts = ATOMIC_VAR_INIT(0);
 
 #else //EASYTEST_NO_THREADS is defined
 		size_t m_nextTestSuiteIdx = 0;
 		size_t m_nbFailedTestSuites = 0;
+		size_t m_nbTotalAsserts = 0;
 #endif //!EASYTEST_NO_THREADS
 	};
 }
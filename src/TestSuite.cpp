@@ -10,9 +10,16 @@
 #include "../include/TestSuite.h"
 
 #include "ITestListener.h"
+#include "compare/SimdCompare.h"
+#include "compare/GoldenFile.h"
+#include "compare/Digest.h"
+#include "TestRunner.h"
+#include "stats/BenchmarkStats.h"
 
 namespace easyTest
 {
+	const size_t TestSuite::NO_STRING_MISMATCH;
+
 	void TestSuite::trace(const SrcInfo& info, const char* format, ...) const
 	{
 		if (m_pTestListener && format && (format[0] != '\0'))
@@ -26,6 +33,7 @@ namespace easyTest
 
 	bool TestSuite::unaryAssert(bool condition, const SrcInfo& info, AssertType type, const char* varName) const
 	{
+		m_nbAsserts++;
 		if (condition)
 			return true;
 
@@ -37,6 +45,7 @@ namespace easyTest
 
 	bool TestSuite::binaryAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName) const
 	{
+		m_nbAsserts++;
 		if (condition)
 			return true;
 
@@ -45,4 +54,250 @@ namespace easyTest
 
 		return false;
 	}
+
+	bool TestSuite::stringAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const
+	{
+		m_nbAsserts++;
+		if (condition)
+			return true;
+
+		notifyStringFailure(info, type, varAName, varBName, strA, strB, charSize, mismatchIdx);
+		return false;
+	}
+
+	void TestSuite::notifyStringFailure(const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const
+	{
+		if (m_pTestListener)
+		{
+			if ((charSize == 1) || (charSize == 2) || (charSize == 4))
+			{
+				char contextA[compare::STRING_CONTEXT_BUFFER_SIZE];
+				char contextB[compare::STRING_CONTEXT_BUFFER_SIZE];
+				compare::formatStringContext(contextA, sizeof(contextA), strA, charSize, mismatchIdx);
+				compare::formatStringContext(contextB, sizeof(contextB), strB, charSize, mismatchIdx);
+
+				m_pTestListener->onStringAssertFailure(m_workerThreadIdx, info, type, varAName, varBName, mismatchIdx, contextA, contextB);
+			}
+			else
+				m_pTestListener->onBinaryAssertFailure(m_workerThreadIdx, info, type, varAName, varBName);
+		}
+	}
+
+	bool TestSuite::dataAssert(bool condition, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* dataA, const void* dataB, size_t sizeInBytes) const
+	{
+		m_nbAsserts++;
+		if (condition)
+			return true;
+
+		notifyDataFailure(info, type, varAName, varBName, dataA, dataB, sizeInBytes);
+		return false;
+	}
+
+	void TestSuite::notifyDataFailure(const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const void* dataA, const void* dataB, size_t sizeInBytes) const
+	{
+		if (m_pTestListener)
+		{
+			if (dataA && dataB && sizeInBytes)
+			{
+				compare::DataDiffReport report;
+				compare::computeDataDiff(report, dataA, dataB, sizeInBytes);
+				m_pTestListener->onDataAssertFailure(m_workerThreadIdx, info, type, varAName, varBName, report);
+			}
+			else
+				m_pTestListener->onBinaryAssertFailure(m_workerThreadIdx, info, type, varAName, varBName);
+		}
+	}
+
+	bool TestSuite::matchesGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, const char* varName, const SrcInfo& info) const
+	{
+		m_nbAsserts++;
+		return goldenAssert(data, sizeInBytes, goldenPath, info, varName);
+	}
+
+	bool TestSuite::matchesGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, const AssertSite& site) const
+	{
+		m_nbAsserts++;
+		return goldenAssert(data, sizeInBytes, goldenPath, site.getInfo(), site.getVarAName());
+	}
+
+	bool TestSuite::goldenAssert(const void* data, size_t sizeInBytes, const char* goldenPath, const SrcInfo& info, const char* varName) const
+	{
+		if (!goldenPath || (!data && sizeInBytes))
+		{
+			if (m_pTestListener)
+				m_pTestListener->onUnaryAssertFailure(m_workerThreadIdx, info, AssertType::MATCH_GOLDEN_FILE, varName);
+
+			return false;
+		}
+
+		size_t goldenSize = 0;
+		compare::DataDiffReport report;
+		const compare::GoldenStatus status = compare::matchGoldenFile(data, sizeInBytes, goldenPath, goldenSize, report);
+		if ((status == compare::GoldenStatus::MATCH) || (status == compare::GoldenStatus::UPDATED))
+			return true;
+
+		if (m_pTestListener)
+			m_pTestListener->onGoldenAssertFailure(m_workerThreadIdx, info, varName, goldenPath, status, sizeInBytes, goldenSize, (status == compare::GoldenStatus::DATA_MISMATCH) ? &report : nullptr);
+
+		return false;
+	}
+
+	bool TestSuite::hasDataDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const char* varName, const SrcInfo& info) const
+	{
+		m_nbAsserts++;
+		return digestAssert(data, sizeInBytes, expectedDigest, info, AssertType::HAS_DATA_DIGEST, varName);
+	}
+
+	bool TestSuite::hasDataTreeDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const char* varName, const SrcInfo& info) const
+	{
+		m_nbAsserts++;
+		return digestAssert(data, sizeInBytes, expectedDigest, info, AssertType::HAS_DATA_TREE_DIGEST, varName);
+	}
+
+	bool TestSuite::hasDataDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const AssertSite& site) const
+	{
+		m_nbAsserts++;
+		return digestAssert(data, sizeInBytes, expectedDigest, site.getInfo(), AssertType::HAS_DATA_DIGEST, site.getVarAName());
+	}
+
+	bool TestSuite::hasDataTreeDigest(const void* data, size_t sizeInBytes, const char* expectedDigest, const AssertSite& site) const
+	{
+		m_nbAsserts++;
+		return digestAssert(data, sizeInBytes, expectedDigest, site.getInfo(), AssertType::HAS_DATA_TREE_DIGEST, site.getVarAName());
+	}
+
+	bool TestSuite::digestAssert(const void* data, size_t sizeInBytes, const char* expectedDigest, const SrcInfo& info, AssertType type, const char* varName) const
+	{
+		if (!data && sizeInBytes)
+		{
+			if (m_pTestListener)
+				m_pTestListener->onUnaryAssertFailure(m_workerThreadIdx, info, type, varName);
+
+			return false;
+		}
+
+		const uint64_t digest = (type == AssertType::HAS_DATA_TREE_DIGEST) ? compare::computeTreeDigest(data, sizeInBytes, TestRunner::NB_HARDWARE_THREADS) : compare::computeDigest(data, sizeInBytes);
+
+		uint64_t expected = 0;
+		if (compare::parseDigest(expectedDigest, expected) && (expected == digest))
+			return true;
+
+		//The actual digest is always reported so that the expectation can be
+		//updated
+		if (m_pTestListener)
+		{
+			char actualDigest[compare::DIGEST_BUFFER_SIZE];
+			compare::formatDigest(actualDigest, sizeof(actualDigest), digest);
+			m_pTestListener->onDigestAssertFailure(m_workerThreadIdx, info, type, varName, expectedDigest ? expectedDigest : "", actualDigest);
+		}
+
+		return false;
+	}
+
+	bool TestSuite::latencyAssert(LatencyBody body, const void* pBody, long long maxTime, const AssertSite& site) const
+	{
+		const AssertType type = site.getType();
+		const bool bCPUTime = (type == AssertType::P99_CPU_TIME_BELOW) || (type == AssertType::MEDIAN_CPU_TIME_BELOW);
+		const double q = ((type == AssertType::P99_BELOW) || (type == AssertType::P99_CPU_TIME_BELOW)) ? 0.99 : 0.5;
+
+		stats::LatencyMeasure measure;
+		if (!stats::measureLatency(body, pBody, m_latencyOptions, bCPUTime, q, measure))
+			return reportFailure(site);
+
+		if (measure.time <= static_cast<double>(maxTime))
+			return true;
+
+		if (m_pTestListener)
+			m_pTestListener->onLatencyAssertFailure(m_workerThreadIdx, site.getInfo(), type, site.getVarAName(), maxTime, measure.time, measure.nbRuns, measure.nbOutliers);
+
+		return false;
+	}
+
+	bool TestSuite::reportFailure(const AssertSite& site) const
+	{
+		if (m_pTestListener)
+		{
+			if (site.getVarBName())
+				m_pTestListener->onBinaryAssertFailure(m_workerThreadIdx, site.getInfo(), site.getType(), site.getVarAName(), site.getVarBName());
+			else
+				m_pTestListener->onUnaryAssertFailure(m_workerThreadIdx, site.getInfo(), site.getType(), site.getVarAName());
+		}
+
+		return false;
+	}
+
+	bool TestSuite::reportStringFailure(const AssertSite& site, const void* strA, const void* strB, size_t charSize, size_t mismatchIdx) const
+	{
+		notifyStringFailure(site.getInfo(), site.getType(), site.getVarAName(), site.getVarBName(), strA, strB, charSize, mismatchIdx);
+		return false;
+	}
+
+	bool TestSuite::reportDataFailure(const AssertSite& site, const void* dataA, const void* dataB, size_t sizeInBytes) const
+	{
+		notifyDataFailure(site.getInfo(), site.getType(), site.getVarAName(), site.getVarBName(), dataA, dataB, sizeInBytes);
+		return false;
+	}
+
+	bool TestSuite::runBenchmark(BenchmarkBody body, const void* pUserData)
+	{
+		m_bHasBenchmarkResult = true;
+		return BenchmarkState::run(this, body, pUserData, m_benchmarkResult, &m_latencyHistogram);
+	}
+
+	bool TestSuite::runBenchmarkRange(BenchmarkBody body, const void* pUserData, const BenchmarkRange& range)
+	{
+		m_bHasComplexityResult = true;
+		m_complexityResult.expected = range.getExpected();
+		if (!BenchmarkState::runRange(this, body, pUserData, range.getMinRange(), range.getMaxRange(), range.getMultiplier(), m_complexityResult))
+			return false;
+
+		if (range.getExpected() == Complexity::ANY)
+			return true;
+
+		//The expected complexity is an upper bound, a body fitting a lower
+		//class succeeds
+		m_nbAsserts++;
+		return stats::fitsComplexity(m_complexityResult, range.getExpected()) ? true : reportFailure(range.getSite());
+	}
+
+	bool TestSuite::runBenchmarkScaling(BenchmarkBody body, const void* pUserData, const BenchmarkThreads& threads)
+	{
+		m_bHasScalingResult = true;
+		return BenchmarkState::runScaling(this, body, pUserData, threads.getMaxThreads(), m_scalingResult);
+	}
+
+	bool TestSuite::runBenchmarkCold(BenchmarkBody body, const void* pUserData)
+	{
+		if (!runBenchmark(body, pUserData))
+			return false;
+
+		m_bHasColdResult = true;
+		return BenchmarkState::runCold(this, body, pUserData, m_coldResult);
+	}
+
+	bool TestSuite::runBenchmarkAB(BenchmarkBody bodyA, const char* nameA, BenchmarkBody bodyB, const char* nameB, const void* pUserData)
+	{
+		m_bHasABResult = true;
+		return BenchmarkState::runAB(this, bodyA, nameA, bodyB, nameB, pUserData, m_abResult);
+	}
+
+	size_t TestSuite::strMismatch(const char* strA, const char* strB)
+	{
+		return compare::findStringMismatch(strA, strB, sizeof(char));
+	}
+
+	size_t TestSuite::strMismatch(const wchar_t* strA, const wchar_t* strB)
+	{
+		return compare::findStringMismatch(strA, strB, sizeof(wchar_t));
+	}
+
+	size_t TestSuite::strMismatch(const char16_t* strA, const char16_t* strB)
+	{
+		return compare::findStringMismatch(strA, strB, sizeof(char16_t));
+	}
+
+	size_t TestSuite::strMismatch(const char32_t* strA, const char32_t* strB)
+	{
+		return compare::findStringMismatch(strA, strB, sizeof(char32_t));
+	}
 }
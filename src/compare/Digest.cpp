@@ -0,0 +1,361 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "Digest.h"
+
+#include <cstring>
+
+#include "../TestRunner.h" //native thread types, see TestRunner.h
+
+#if !defined(EASYTEST_NO_THREADS) && defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif //!EASYTEST_NO_THREADS && _WIN32
+
+namespace
+{
+	const uint64_t PRIME_1 = 11400714785074694791ULL;
+	const uint64_t PRIME_2 = 14029467366897019727ULL;
+	const uint64_t PRIME_3 = 1609587929392839161ULL;
+	const uint64_t PRIME_4 = 9650029242287828579ULL;
+	const uint64_t PRIME_5 = 2870177450012600261ULL;
+
+	inline uint64_t rotl(uint64_t x, unsigned int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	//XXH64 is defined on little-endian values
+	inline uint64_t read64(const unsigned char* p)
+	{
+		uint64_t v;
+		std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+		v = __builtin_bswap64(v);
+#endif //__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		return v;
+	}
+
+	inline uint32_t read32(const unsigned char* p)
+	{
+		uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+		v = __builtin_bswap32(v);
+#endif //__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		return v;
+	}
+
+	inline void write64(unsigned char* p, uint64_t v)
+	{
+		for (int i = 0; i < 8; ++i, v >>= 8)
+			p[i] = static_cast<unsigned char>(v);
+	}
+
+	inline uint64_t xxhRound(uint64_t acc, uint64_t input)
+	{
+		acc += input * PRIME_2;
+		acc = rotl(acc, 31);
+		return acc * PRIME_1;
+	}
+
+	inline uint64_t mergeRound(uint64_t acc, uint64_t value)
+	{
+		acc ^= xxhRound(0, value);
+		return acc * PRIME_1 + PRIME_4;
+	}
+
+	//Consumes all complete 32-byte stripes and returns the number of bytes
+	//consumed
+	size_t consumeStripes(uint64_t acc[4], const unsigned char* p, size_t sizeInBytes)
+	{
+		uint64_t v1 = acc[0], v2 = acc[1], v3 = acc[2], v4 = acc[3];
+		const unsigned char* const pStart = p;
+		const unsigned char* const pLimit = p + (sizeInBytes & ~static_cast<size_t>(31));
+
+		while (p < pLimit)
+		{
+			v1 = xxhRound(v1, read64(p));
+			v2 = xxhRound(v2, read64(p + 8));
+			v3 = xxhRound(v3, read64(p + 16));
+			v4 = xxhRound(v4, read64(p + 24));
+			p += 32;
+		}
+
+		acc[0] = v1;
+		acc[1] = v2;
+		acc[2] = v3;
+		acc[3] = v4;
+		return p - pStart;
+	}
+
+#ifndef EASYTEST_NO_THREADS
+	struct LeafTask
+	{
+		const unsigned char* data;
+		size_t sizeInBytes;
+		size_t firstLeaf;
+		size_t nbLeaves;
+		uint64_t* digests;
+		easyTest::thread_t threadHandle;
+	};
+
+	void hashLeaves(const LeafTask& task)
+	{
+		for (size_t i = 0; i < task.nbLeaves; ++i)
+		{
+			const size_t offset = (task.firstLeaf + i) * easyTest::compare::DIGEST_TREE_LEAF_SIZE;
+			const size_t size = task.sizeInBytes - offset;
+			task.digests[i] = easyTest::compare::computeDigest(task.data + offset, (size < easyTest::compare::DIGEST_TREE_LEAF_SIZE) ? size : easyTest::compare::DIGEST_TREE_LEAF_SIZE);
+		}
+	}
+
+	easyTest::threadproc_ret _callconv runLeafTask(void* pUserData)
+	{
+		hashLeaves(*static_cast<const LeafTask*>(pUserData));
+		return 0;
+	}
+
+	//Maximum number of threads used to compute a tree digest
+	const unsigned int MAX_DIGEST_THREADS = 64;
+
+	//Leaf digests are computed by batches so that no allocation is needed
+	const size_t LEAF_BATCH_SIZE = 256;
+#endif //!EASYTEST_NO_THREADS
+}
+
+namespace easyTest
+{
+	namespace compare
+	{
+		DigestHasher::DigestHasher()
+		{
+			m_acc[0] = PRIME_1 + PRIME_2;
+			m_acc[1] = PRIME_2;
+			m_acc[2] = 0;
+			m_acc[3] = static_cast<uint64_t>(0) - PRIME_1;
+		}
+
+		void DigestHasher::update(const void* data, size_t sizeInBytes)
+		{
+			if (!sizeInBytes)
+				return;
+
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			m_totalSize += sizeInBytes;
+
+			if (m_stripeSize)
+			{
+				size_t n = STRIPE_SIZE - m_stripeSize;
+				if (n > sizeInBytes)
+					n = sizeInBytes;
+
+				std::memcpy(m_stripe + m_stripeSize, p, n);
+				m_stripeSize += n;
+				p += n;
+				sizeInBytes -= n;
+
+				if (m_stripeSize < STRIPE_SIZE)
+					return;
+
+				consumeStripes(m_acc, m_stripe, STRIPE_SIZE);
+				m_stripeSize = 0;
+			}
+
+			const size_t consumed = consumeStripes(m_acc, p, sizeInBytes);
+			m_stripeSize = sizeInBytes - consumed;
+			std::memcpy(m_stripe, p + consumed, m_stripeSize);
+		}
+
+		uint64_t DigestHasher::getDigest() const
+		{
+			uint64_t h;
+			if (m_totalSize >= STRIPE_SIZE)
+			{
+				h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+				h = mergeRound(h, m_acc[0]);
+				h = mergeRound(h, m_acc[1]);
+				h = mergeRound(h, m_acc[2]);
+				h = mergeRound(h, m_acc[3]);
+			}
+			else
+				h = m_acc[2] + PRIME_5;
+
+			h += m_totalSize;
+
+			const unsigned char* p = m_stripe;
+			size_t n = m_stripeSize;
+			for (; n >= 8; n -= 8, p += 8)
+				h = rotl(h ^ xxhRound(0, read64(p)), 27) * PRIME_1 + PRIME_4;
+
+			if (n >= 4)
+			{
+				h = rotl(h ^ (read32(p) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+				n -= 4;
+				p += 4;
+			}
+
+			for (; n; --n, ++p)
+				h = rotl(h ^ (*p * PRIME_5), 11) * PRIME_1;
+
+			h ^= h >> 33;
+			h *= PRIME_2;
+			h ^= h >> 29;
+			h *= PRIME_3;
+			h ^= h >> 32;
+			return h;
+		}
+
+		uint64_t computeDigest(const void* data, size_t sizeInBytes)
+		{
+			DigestHasher hasher;
+			hasher.update(data, sizeInBytes);
+			return hasher.getDigest();
+		}
+
+		uint64_t computeTreeDigest(const void* data, size_t sizeInBytes, unsigned int nbThreads)
+		{
+			if (sizeInBytes <= DIGEST_TREE_LEAF_SIZE)
+				return computeDigest(data, sizeInBytes);
+
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			const size_t nbLeaves = (sizeInBytes + DIGEST_TREE_LEAF_SIZE - 1) / DIGEST_TREE_LEAF_SIZE;
+			DigestHasher treeHasher;
+			unsigned char leafDigest[8];
+
+#ifndef EASYTEST_NO_THREADS
+			if (nbThreads > MAX_DIGEST_THREADS)
+				nbThreads = MAX_DIGEST_THREADS;
+
+			if (nbThreads > 1)
+			{
+				LeafTask tasks[MAX_DIGEST_THREADS];
+				uint64_t digests[LEAF_BATCH_SIZE];
+
+				for (size_t batchStart = 0; batchStart < nbLeaves; batchStart += LEAF_BATCH_SIZE)
+				{
+					const size_t batchSize = (nbLeaves - batchStart < LEAF_BATCH_SIZE) ? nbLeaves - batchStart : LEAF_BATCH_SIZE;
+					const size_t nbTasks = (batchSize < nbThreads) ? batchSize : nbThreads;
+
+					//Contiguous ranges of leaves, the first task is run by the
+					//calling thread once all other tasks have been launched
+					size_t leafIdx = 0;
+					for (size_t i = 0; i < nbTasks; ++i)
+					{
+						LeafTask& task = tasks[i];
+						task.data = p;
+						task.sizeInBytes = sizeInBytes;
+						task.firstLeaf = batchStart + leafIdx;
+						task.nbLeaves = (batchSize - leafIdx) / (nbTasks - i);
+						task.digests = digests + leafIdx;
+						task.threadHandle = 0;
+						leafIdx += task.nbLeaves;
+
+						if (i)
+						{
+#ifdef __linux__
+							if (pthread_create(&task.threadHandle, nullptr, &runLeafTask, &task))
+								task.threadHandle = 0;
+#elif defined(_WIN32)
+							task.threadHandle = _beginthreadex(nullptr, 0, &runLeafTask, &task, 0, nullptr);
+#endif //__linux__
+						}
+					}
+
+					for (size_t i = 0; i < nbTasks; ++i)
+					{
+						LeafTask& task = tasks[i];
+						if (!task.threadHandle)
+							hashLeaves(task); //thread not started
+						else
+						{
+#ifdef __linux__
+							pthread_join(task.threadHandle, nullptr);
+#elif defined(_WIN32)
+							HANDLE hThread = reinterpret_cast<HANDLE>(task.threadHandle);
+							WaitForSingleObject(hThread, INFINITE);
+							CloseHandle(hThread);
+#endif //__linux__
+						}
+					}
+
+					for (size_t i = 0; i < batchSize; ++i)
+					{
+						write64(leafDigest, digests[i]);
+						treeHasher.update(leafDigest, sizeof(leafDigest));
+					}
+				}
+
+				return treeHasher.getDigest();
+			}
+#else //EASYTEST_NO_THREADS is defined
+			(void)nbThreads;
+#endif //!EASYTEST_NO_THREADS
+
+			for (size_t i = 0; i < nbLeaves; ++i)
+			{
+				const size_t offset = i * DIGEST_TREE_LEAF_SIZE;
+				const size_t size = sizeInBytes - offset;
+				write64(leafDigest, computeDigest(p + offset, (size < DIGEST_TREE_LEAF_SIZE) ? size : DIGEST_TREE_LEAF_SIZE));
+				treeHasher.update(leafDigest, sizeof(leafDigest));
+			}
+
+			return treeHasher.getDigest();
+		}
+
+		void formatDigest(char* buffer, size_t bufferSize, uint64_t digest)
+		{
+			if (!buffer || !bufferSize)
+				return;
+
+			static const char s_hexDigits[] = "0123456789abcdef";
+			size_t n = (bufferSize - 1 < 16) ? bufferSize - 1 : 16;
+			for (size_t i = 0; i < n; ++i)
+				buffer[i] = s_hexDigits[(digest >> (60 - 4 * i)) & 0x0F];
+
+			buffer[n] = '\0';
+		}
+
+		bool parseDigest(const char* str, uint64_t& digest)
+		{
+			if (!str)
+				return false;
+
+			if ((str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X')))
+				str += 2;
+
+			uint64_t value = 0;
+			size_t nbDigits = 0;
+			for (; *str; ++str, ++nbDigits)
+			{
+				const char c = *str;
+				unsigned int d;
+				if ((c >= '0') && (c <= '9'))
+					d = c - '0';
+				else if ((c >= 'a') && (c <= 'f'))
+					d = c - 'a' + 10;
+				else if ((c >= 'A') && (c <= 'F'))
+					d = c - 'A' + 10;
+				else
+					return false;
+
+				if (nbDigits == 16)
+					return false;
+
+				value = (value << 4) | d;
+			}
+
+			if (!nbDigits)
+				return false;
+
+			digest = value;
+			return true;
+		}
+	}
+}
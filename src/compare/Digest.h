@@ -0,0 +1,76 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _DIGEST_H_
+#define _DIGEST_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace easyTest
+{
+	namespace compare
+	{
+		//Streaming XXH64 hasher (seed 0), giving the same digests as the
+		//reference xxHash implementation and the xxhsum tool.
+		class DigestHasher final
+		{
+		public:
+			DigestHasher();
+
+			//data must not be nullptr unless sizeInBytes is 0
+			void update(const void* data, size_t sizeInBytes);
+
+			//Does not modify the hasher state, update() can still be called
+			//afterwards
+			uint64_t getDigest() const;
+
+		private:
+			DigestHasher(const DigestHasher&) = delete;
+			DigestHasher& operator=(const DigestHasher&) = delete;
+
+			static const size_t STRIPE_SIZE = 32;
+
+			uint64_t m_acc[4];
+			uint64_t m_totalSize = 0;
+			unsigned char m_stripe[STRIPE_SIZE];
+			size_t m_stripeSize = 0;
+		};
+
+		//One-shot XXH64 digest of sizeInBytes bytes of data
+		uint64_t computeDigest(const void* data, size_t sizeInBytes);
+
+		//Size of the leaves of a tree digest
+		const size_t DIGEST_TREE_LEAF_SIZE = 4 * 1024 * 1024;
+
+		//Tree digest of sizeInBytes bytes of data: data is split into leaves
+		//of DIGEST_TREE_LEAF_SIZE bytes which are hashed in parallel by up to
+		//nbThreads threads, the tree digest is then the XXH64 digest of all
+		//leaf digests (64-bit little-endian values, in data order).
+		//The result never depends on nbThreads and it is equal to the plain
+		//XXH64 digest if data holds in a single leaf. Without thread support
+		//(EASYTEST_NO_THREADS), all leaves are hashed by the calling thread.
+		uint64_t computeTreeDigest(const void* data, size_t sizeInBytes, unsigned int nbThreads);
+
+		//Size of a buffer large enough to hold any formatDigest() output
+		const size_t DIGEST_BUFFER_SIZE = 17;
+
+		//Formats digest as 16 lowercase hexadecimal digits, most significant
+		//first (same canonical form as xxhsum). The output is always
+		//null-terminated (truncated if bufferSize is too small).
+		void formatDigest(char* buffer, size_t bufferSize, uint64_t digest);
+
+		//Parses a digest formatted as 1 to 16 hexadecimal digits (any case),
+		//optionally prefixed by "0x". Returns false if str is nullptr or is
+		//not a valid digest.
+		bool parseDigest(const char* str, uint64_t& digest);
+	}
+}
+
+#endif //_DIGEST_H_
@@ -0,0 +1,400 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "GoldenFile.h"
+
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#elif defined(_WIN32)
+#include <cstdio>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+#error Unsupported platform: currently supported platforms are\
+       Linux and Windows
+#endif //__linux__
+
+#include "SimdCompare.h"
+
+namespace
+{
+	//Size of the golden file window mapped in memory at the same time. It
+	//must be a multiple of the memory allocation granularity on all
+	//platforms (64 KB under Windows).
+	const size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+#ifdef __linux__
+	//Replaced by a unique string when the temporary file is created
+	const char TEMP_FILE_SUFFIX[] = ".XXXXXX";
+#elif defined(_WIN32)
+	//Process and thread identifiers, unique among concurrent writers
+	const char TEMP_FILE_SUFFIX[] = ".%08lx%08lx.tmp";
+	const size_t TEMP_FILE_SUFFIX_SIZE = 22; //terminating null character included
+#endif //__linux__
+
+	bool s_bUpdateMode = false;
+
+	class GoldenReader final
+	{
+	public:
+		GoldenReader() = default;
+
+		~GoldenReader()
+		{
+			close();
+		}
+
+		bool open(const char* path)
+		{
+#ifdef __linux__
+			m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+			if (m_fd < 0)
+				return false;
+
+			struct stat fileStat = {};
+			if (fstat(m_fd, &fileStat) || !S_ISREG(fileStat.st_mode) || (static_cast<unsigned long long>(fileStat.st_size) > static_cast<size_t>(-1)))
+			{
+				close();
+				return false;
+			}
+
+			m_size = static_cast<size_t>(fileStat.st_size);
+			return true;
+
+#elif defined(_WIN32)
+			m_hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_hFile == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER fileSize = {};
+			if (!GetFileSizeEx(m_hFile, &fileSize) || (static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<size_t>(-1)))
+			{
+				close();
+				return false;
+			}
+
+			m_size = static_cast<size_t>(fileSize.QuadPart);
+
+			//Empty files cannot be mapped but there is nothing to read anyway
+			if (m_size)
+			{
+				m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (!m_hMapping)
+				{
+					close();
+					return false;
+				}
+			}
+
+			return true;
+#endif //__linux__
+		}
+
+		size_t getSize() const
+		{
+			return m_size;
+		}
+
+		//Maps the chunk of sizeInBytes bytes starting at offset (which must be
+		//a multiple of CHUNK_SIZE), any previously mapped chunk is unmapped.
+		const void* mapChunk(size_t offset, size_t sizeInBytes)
+		{
+			unmapChunk();
+
+#ifdef __linux__
+			void* p = mmap(nullptr, sizeInBytes, PROT_READ, MAP_PRIVATE, m_fd, static_cast<off_t>(offset));
+			if (p == MAP_FAILED)
+				return nullptr;
+
+			madvise(p, sizeInBytes, MADV_SEQUENTIAL);
+
+#elif defined(_WIN32)
+			const unsigned long long largeOffset = offset;
+			void* p = MapViewOfFile(m_hMapping, FILE_MAP_READ, static_cast<DWORD>(largeOffset >> 32), static_cast<DWORD>(largeOffset & 0xFFFFFFFF), sizeInBytes);
+			if (!p)
+				return nullptr;
+#endif //__linux__
+
+			m_pChunk = p;
+			m_chunkSize = sizeInBytes;
+			return p;
+		}
+
+		void unmapChunk()
+		{
+			if (m_pChunk)
+			{
+#ifdef __linux__
+				munmap(m_pChunk, m_chunkSize);
+#elif defined(_WIN32)
+				UnmapViewOfFile(m_pChunk);
+#endif //__linux__
+
+				m_pChunk = nullptr;
+				m_chunkSize = 0;
+			}
+		}
+
+		void close()
+		{
+			unmapChunk();
+
+#ifdef __linux__
+			if (m_fd >= 0)
+			{
+				::close(m_fd);
+				m_fd = -1;
+			}
+
+#elif defined(_WIN32)
+			if (m_hMapping)
+			{
+				CloseHandle(m_hMapping);
+				m_hMapping = nullptr;
+			}
+
+			if (m_hFile != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_hFile);
+				m_hFile = INVALID_HANDLE_VALUE;
+			}
+#endif //__linux__
+
+			m_size = 0;
+		}
+
+	private:
+		GoldenReader(const GoldenReader&) = delete;
+		GoldenReader& operator=(const GoldenReader&) = delete;
+
+#ifdef __linux__
+		int m_fd = -1;
+#elif defined(_WIN32)
+		HANDLE m_hFile = INVALID_HANDLE_VALUE;
+		HANDLE m_hMapping = nullptr;
+#endif //__linux__
+
+		size_t m_size = 0;
+		void* m_pChunk = nullptr;
+		size_t m_chunkSize = 0;
+	};
+
+	//Creates the temporary file tempPath and writes data into it. Under
+	//Linux, the suffix of tempPath is first made unique. On failure, the
+	//temporary file is never left on disk.
+	bool writeTempFile(char* tempPath, const void* data, size_t sizeInBytes)
+	{
+		const char* p = static_cast<const char*>(data);
+
+#ifdef __linux__
+		//mkostemp() creates the file with 0600 permissions, golden files
+		//are readable by all
+		int fd = mkostemp(tempPath, O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		bool bRet = !fchmod(fd, 0644);
+		while (bRet && sizeInBytes)
+		{
+			ssize_t n = write(fd, p, sizeInBytes);
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+
+				bRet = false;
+				break;
+			}
+
+			p += n;
+			sizeInBytes -= n;
+		}
+
+		//Data must be on disk before the file is renamed, otherwise a crash
+		//could leave an empty golden file
+		bRet = bRet && !fsync(fd);
+		bRet = !close(fd) && bRet;
+		if (!bRet)
+			unlink(tempPath);
+
+		return bRet;
+
+#elif defined(_WIN32)
+		HANDLE hFile = CreateFileA(tempPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		bool bRet = true;
+		while (sizeInBytes)
+		{
+			DWORD n = (sizeInBytes > CHUNK_SIZE) ? static_cast<DWORD>(CHUNK_SIZE) : static_cast<DWORD>(sizeInBytes);
+			if (!WriteFile(hFile, p, n, &n, nullptr) || !n)
+			{
+				bRet = false;
+				break;
+			}
+
+			p += n;
+			sizeInBytes -= n;
+		}
+
+		bRet = bRet && (FlushFileBuffers(hFile) != FALSE);
+		bRet = CloseHandle(hFile) && bRet;
+		if (!bRet)
+			DeleteFileA(tempPath);
+
+		return bRet;
+#endif //__linux__
+	}
+
+#ifdef __linux__
+	//A renamed file is only kept by a crash once its directory entry is on
+	//disk. dirPath is a buffer of at least strlen(path) + 2 characters.
+	bool syncParentDirectory(const char* path, char* dirPath)
+	{
+		const char* pSlash = std::strrchr(path, '/');
+		if (!pSlash)
+			std::strcpy(dirPath, ".");
+		else
+		{
+			const size_t dirLen = (pSlash == path) ? 1 : static_cast<size_t>(pSlash - path);
+			std::memcpy(dirPath, path, dirLen);
+			dirPath[dirLen] = '\0';
+		}
+
+		int fd = ::open(dirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		//Some file systems cannot sync directories
+		bool bRet = !fsync(fd) || (errno == EINVAL);
+		return !close(fd) && bRet;
+	}
+#endif //__linux__
+
+	//The golden file is first written to a temporary file which then replaces
+	//the golden file, so that a golden file is never left partially written.
+	//The temporary file name is unique, so that test cases updating the same
+	//golden file in parallel never write to the same temporary file.
+	bool updateGoldenFile(const char* goldenPath, const void* data, size_t sizeInBytes)
+	{
+		const size_t pathLen = std::strlen(goldenPath);
+#ifdef __linux__
+		char* tempPath = new(std::nothrow) char[pathLen + sizeof(TEMP_FILE_SUFFIX)];
+		if (!tempPath)
+			return false;
+
+		std::memcpy(tempPath, goldenPath, pathLen);
+		std::memcpy(tempPath + pathLen, TEMP_FILE_SUFFIX, sizeof(TEMP_FILE_SUFFIX));
+
+#elif defined(_WIN32)
+		char* tempPath = new(std::nothrow) char[pathLen + TEMP_FILE_SUFFIX_SIZE];
+		if (!tempPath)
+			return false;
+
+		std::memcpy(tempPath, goldenPath, pathLen);
+		std::snprintf(tempPath + pathLen, TEMP_FILE_SUFFIX_SIZE, TEMP_FILE_SUFFIX, static_cast<unsigned long>(GetCurrentProcessId()), static_cast<unsigned long>(GetCurrentThreadId()));
+#endif //__linux__
+
+		bool bRet = writeTempFile(tempPath, data, sizeInBytes);
+		if (bRet)
+		{
+#ifdef __linux__
+			bRet = !std::rename(tempPath, goldenPath);
+			if (!bRet)
+				unlink(tempPath);
+			else
+				bRet = syncParentDirectory(goldenPath, tempPath);
+
+#elif defined(_WIN32)
+			bRet = (MoveFileExA(tempPath, goldenPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE);
+			if (!bRet)
+				DeleteFileA(tempPath);
+#endif //__linux__
+		}
+
+		delete[] tempPath;
+		return bRet;
+	}
+}
+
+namespace easyTest
+{
+	namespace compare
+	{
+		void setGoldenUpdateMode(bool bUpdate)
+		{
+			s_bUpdateMode = bUpdate;
+		}
+
+		bool isGoldenUpdateMode()
+		{
+			return s_bUpdateMode;
+		}
+
+		GoldenStatus matchGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, size_t& goldenSize, DataDiffReport& report)
+		{
+			GoldenStatus status = GoldenStatus::CANNOT_READ;
+			goldenSize = 0;
+
+			{
+				GoldenReader reader;
+				if (reader.open(goldenPath))
+				{
+					goldenSize = reader.getSize();
+					if (goldenSize != sizeInBytes)
+						status = GoldenStatus::SIZE_MISMATCH;
+					else
+					{
+						const unsigned char* p = static_cast<const unsigned char*>(data);
+						DataDiffScanner scanner(report);
+
+						size_t offset = 0;
+						while (offset < sizeInBytes)
+						{
+							const size_t chunkSize = (sizeInBytes - offset > CHUNK_SIZE) ? CHUNK_SIZE : sizeInBytes - offset;
+							const void* pChunk = reader.mapChunk(offset, chunkSize);
+							if (!pChunk)
+								break;
+
+							scanner.scan(p + offset, pChunk, chunkSize);
+							offset += chunkSize;
+						}
+
+						scanner.finish();
+						reader.unmapChunk();
+
+						if (offset < sizeInBytes)
+							status = GoldenStatus::CANNOT_READ;
+						else if (report.nbMismatchBytes)
+							status = GoldenStatus::DATA_MISMATCH;
+						else
+							status = GoldenStatus::MATCH;
+					}
+				}
+			}
+
+			if ((status == GoldenStatus::MATCH) || !s_bUpdateMode)
+				return status;
+
+			return updateGoldenFile(goldenPath, data, sizeInBytes) ? GoldenStatus::UPDATED : GoldenStatus::CANNOT_UPDATE;
+		}
+	}
+}
@@ -0,0 +1,50 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _GOLDENFILE_H_
+#define _GOLDENFILE_H_
+
+#include <cstddef>
+
+namespace easyTest
+{
+	namespace compare
+	{
+		struct DataDiffReport;
+
+		enum struct GoldenStatus : unsigned char
+		{
+			MATCH,			//Data matches the golden file content
+			UPDATED,		//Golden file has been (re)written with data (update mode only)
+			CANNOT_READ,	//Golden file does not exist or cannot be read
+			SIZE_MISMATCH,	//Golden file size is different from data size
+			DATA_MISMATCH,	//Golden file content is different from data
+			CANNOT_UPDATE	//Golden file cannot be written (update mode only)
+		};
+
+		//In update mode, golden files which do not match their data are
+		//atomically replaced by this data instead of failing. Golden files
+		//which already match are never rewritten.
+		//The mode must be set before starting any test suite as it is not
+		//protected against concurrent accesses.
+		void setGoldenUpdateMode(bool bUpdate);
+		bool isGoldenUpdateMode();
+
+		//Compares sizeInBytes bytes of data with the content of the golden
+		//file goldenPath. The golden file is memory mapped and compared by
+		//chunks of limited size, so that memory usage does not depend on the
+		//file size. goldenSize receives the golden file size (0 if it cannot
+		//be read) and report is filled only on DATA_MISMATCH.
+		//data can be nullptr only if sizeInBytes is 0 and goldenPath must not
+		//be nullptr.
+		GoldenStatus matchGoldenFile(const void* data, size_t sizeInBytes, const char* goldenPath, size_t& goldenSize, DataDiffReport& report);
+	}
+}
+
+#endif //_GOLDENFILE_H_
@@ -0,0 +1,445 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "SimdCompare.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _MSC_VER //Visual C++ compiler
+#include <intrin.h>
+#endif //_MSC_VER
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define HAS_SSE2 1
+#include <emmintrin.h>
+#endif //__SSE2__ || _M_X64 || _M_IX86_FP >= 2
+
+namespace
+{
+	//Number of characters displayed before and after the mismatch index by
+	//formatStringContext().
+	const size_t CONTEXT_RADIUS = 16;
+
+	template<typename T> T loadChar(const unsigned char* p, size_t charIdx)
+	{
+		//We use memcpy in order to respect strict-aliasing rules: strings
+		//are received as void* and their real character type is unknown.
+		T c;
+		std::memcpy(&c, p + charIdx * sizeof(T), sizeof(T));
+		return c;
+	}
+
+	unsigned int getFirstBitIndex(unsigned int mask)
+	{
+#ifdef __GNUC__ //GNU-compatible compilers: g++, mingw and clang
+		return __builtin_ctz(mask);
+#elif defined(_MSC_VER) //Visual C++ compiler
+		unsigned long idx = 0;
+		_BitScanForward(&idx, mask);
+		return idx;
+#endif //__GNUC__
+	}
+
+	//Data buffers are compared by blocks of BLOCK_SIZE bytes (one bit per
+	//byte in difference masks) and equal regions are skipped by wide blocks
+	//of WIDE_BLOCK_SIZE bytes.
+	const size_t BLOCK_SIZE = 16;
+	const size_t WIDE_BLOCK_SIZE = 4 * BLOCK_SIZE;
+
+#ifdef HAS_SSE2
+	const size_t VECTOR_SIZE = sizeof(__m128i);
+
+	//Smallest memory page size on all supported architectures. A vector
+	//load which does not cross a page boundary cannot fault if the first
+	//byte it reads is valid.
+	const uintptr_t PAGE_SIZE = 4096;
+
+	bool canLoadVector(const unsigned char* p)
+	{
+		return (reinterpret_cast<uintptr_t>(p) & (PAGE_SIZE - 1)) <= PAGE_SIZE - VECTOR_SIZE;
+	}
+
+	template<typename T> __m128i compareEqual(__m128i a, __m128i b);
+
+	template<> __m128i compareEqual<std::uint8_t>(__m128i a, __m128i b)
+	{
+		return _mm_cmpeq_epi8(a, b);
+	}
+
+	template<> __m128i compareEqual<std::uint16_t>(__m128i a, __m128i b)
+	{
+		return _mm_cmpeq_epi16(a, b);
+	}
+
+	template<> __m128i compareEqual<std::uint32_t>(__m128i a, __m128i b)
+	{
+		return _mm_cmpeq_epi32(a, b);
+	}
+
+	template<typename T> size_t findMismatch(const unsigned char* strA, const unsigned char* strB)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t charIdx = 0;
+		for (;;)
+		{
+			const unsigned char* pA = strA + charIdx * sizeof(T);
+			const unsigned char* pB = strB + charIdx * sizeof(T);
+			if (canLoadVector(pA) && canLoadVector(pB))
+			{
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB));
+
+				//One bit per byte is set for each character which is either
+				//different in both strings or the terminator of strA.
+				const unsigned int mask = (~_mm_movemask_epi8(compareEqual<T>(a, b)) | _mm_movemask_epi8(compareEqual<T>(a, zero))) & 0xFFFF;
+				if (mask)
+				{
+					charIdx += getFirstBitIndex(mask) / sizeof(T);
+					if (loadChar<T>(strA, charIdx) == loadChar<T>(strB, charIdx))
+						return easyTest::compare::NO_MISMATCH;
+
+					return charIdx;
+				}
+
+				charIdx += VECTOR_SIZE / sizeof(T);
+			}
+			else
+			{
+				//Close to a page boundary, we go on character by character
+				const T c = loadChar<T>(strA, charIdx);
+				if (c != loadChar<T>(strB, charIdx))
+					return charIdx;
+
+				if (!c)
+					return easyTest::compare::NO_MISMATCH;
+
+				charIdx++;
+			}
+		}
+	}
+
+	//Returns a mask with one bit set for each differing byte in the blocks
+	unsigned int getBlockDiffMask(const unsigned char* a, const unsigned char* b)
+	{
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+		return ~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xFFFF;
+	}
+
+	bool isWideBlockEqual(const unsigned char* a, const unsigned char* b)
+	{
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+		for (size_t i = VECTOR_SIZE; i < WIDE_BLOCK_SIZE; i += VECTOR_SIZE)
+			eq = _mm_and_si128(eq, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+
+		return (_mm_movemask_epi8(eq) == 0xFFFF);
+	}
+
+#else //HAS_SSE2 is not defined
+	template<typename T> size_t findMismatch(const unsigned char* strA, const unsigned char* strB)
+	{
+		for (size_t charIdx = 0;; ++charIdx)
+		{
+			const T c = loadChar<T>(strA, charIdx);
+			if (c != loadChar<T>(strB, charIdx))
+				return charIdx;
+
+			if (!c)
+				return easyTest::compare::NO_MISMATCH;
+		}
+	}
+
+	//Returns a mask with one bit set for each differing byte in the blocks
+	unsigned int getBlockDiffMask(const unsigned char* a, const unsigned char* b)
+	{
+		unsigned int mask = 0;
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+		{
+			if (a[i] != b[i])
+				mask |= 1u << i;
+		}
+
+		return mask;
+	}
+
+	bool isWideBlockEqual(const unsigned char* a, const unsigned char* b)
+	{
+		return !std::memcmp(a, b, WIDE_BLOCK_SIZE);
+	}
+#endif //HAS_SSE2
+
+	class ContextWriter final
+	{
+	public:
+		ContextWriter(char* buffer, size_t bufferSize) : m_buffer(buffer), m_bufferSize(bufferSize)
+		{
+			if (m_buffer && m_bufferSize)
+				m_buffer[0] = '\0';
+		}
+
+		void append(const char* str)
+		{
+			while (*str != '\0')
+			{
+				if (m_len + 1 >= m_bufferSize)
+					return;
+
+				m_buffer[m_len++] = *str++;
+				m_buffer[m_len] = '\0';
+			}
+		}
+
+		void appendChar(std::uint32_t c, size_t charSize)
+		{
+			char str[16] = {};
+			if (c == 0)
+				append("\\0");
+			else if (c == '\\')
+				append("\\\\");
+			else if ((c >= 0x20) && (c <= 0x7E))
+			{
+				str[0] = static_cast<char>(c);
+				append(str);
+			}
+			else
+			{
+				if (charSize == 1)
+					std::snprintf(str, sizeof(str), "\\x%02X", static_cast<unsigned int>(c));
+				else if (c <= 0xFFFF)
+					std::snprintf(str, sizeof(str), "\\u%04X", static_cast<unsigned int>(c));
+				else
+					std::snprintf(str, sizeof(str), "\\U%08X", static_cast<unsigned int>(c));
+
+				append(str);
+			}
+		}
+
+	private:
+		ContextWriter(const ContextWriter&) = delete;
+		ContextWriter& operator=(const ContextWriter&) = delete;
+
+		char* const m_buffer;
+		const size_t m_bufferSize;
+		size_t m_len = 0;
+	};
+
+	template<typename T> void formatContext(ContextWriter& writer, const unsigned char* str, size_t charIdx)
+	{
+		size_t i = 0;
+		if (charIdx > CONTEXT_RADIUS)
+		{
+			i = charIdx - CONTEXT_RADIUS;
+			writer.append("...");
+		}
+
+		for (; i <= charIdx + CONTEXT_RADIUS; ++i)
+		{
+			const T c = loadChar<T>(str, i);
+			writer.appendChar(static_cast<std::uint32_t>(c), sizeof(T));
+			if (!c)
+				return;
+		}
+
+		if (loadChar<T>(str, i))
+			writer.append("...");
+	}
+}
+
+namespace easyTest
+{
+	namespace compare
+	{
+		size_t findStringMismatch(const void* strA, const void* strB, size_t charSize)
+		{
+			const unsigned char* a = static_cast<const unsigned char*>(strA);
+			const unsigned char* b = static_cast<const unsigned char*>(strB);
+
+			switch (charSize)
+			{
+			case 1:
+				return findMismatch<std::uint8_t>(a, b);
+
+			case 2:
+				return findMismatch<std::uint16_t>(a, b);
+
+			case 4:
+				return findMismatch<std::uint32_t>(a, b);
+
+			default:
+				return NO_MISMATCH;
+			}
+		}
+
+		DataDiffScanner::DataDiffScanner(DataDiffReport& report) : m_report(report)
+		{
+			std::memset(&m_report, 0, sizeof(DataDiffReport));
+		}
+
+		void DataDiffScanner::scan(const void* dataA, const void* dataB, size_t sizeInBytes)
+		{
+			m_chunkA = static_cast<const unsigned char*>(dataA);
+			m_chunkB = static_cast<const unsigned char*>(dataB);
+			m_chunkOffset = m_report.sizeInBytes;
+
+			size_t pos = 0;
+			while (pos + BLOCK_SIZE <= sizeInBytes)
+			{
+				if ((pos + WIDE_BLOCK_SIZE <= sizeInBytes) && isWideBlockEqual(m_chunkA + pos, m_chunkB + pos))
+				{
+					pos += WIDE_BLOCK_SIZE;
+					continue;
+				}
+
+				unsigned int mask = getBlockDiffMask(m_chunkA + pos, m_chunkB + pos);
+				while (mask)
+				{
+					addMismatch(m_chunkOffset + pos + getFirstBitIndex(mask));
+					mask &= mask - 1;
+				}
+
+				pos += BLOCK_SIZE;
+			}
+
+			for (; pos < sizeInBytes; ++pos)
+			{
+				if (m_chunkA[pos] != m_chunkB[pos])
+					addMismatch(m_chunkOffset + pos);
+			}
+
+			m_report.sizeInBytes += sizeInBytes;
+
+			//The next chunk may not be accessible anymore, so we copy now
+			//every excerpt byte this chunk holds for the current region
+			if (m_bInRegion)
+				fillExcerpt(m_report.sizeInBytes);
+		}
+
+		void DataDiffScanner::finish()
+		{
+			if (m_bInRegion)
+			{
+				fillExcerpt(m_regionEnd);
+				closeRegion();
+			}
+		}
+
+		void DataDiffScanner::addMismatch(size_t offset)
+		{
+			m_report.nbMismatchBytes++;
+			if (m_bInRegion && (offset - m_regionEnd <= DATA_DIFF_COALESCE_GAP))
+			{
+				m_regionEnd = offset + 1;
+				return;
+			}
+
+			if (m_bInRegion)
+			{
+				fillExcerpt(m_regionEnd);
+				closeRegion();
+			}
+
+			m_bInRegion = true;
+			m_regionStart = offset;
+			m_regionEnd = offset + 1;
+			m_excerptSize = 0;
+		}
+
+		void DataDiffScanner::fillExcerpt(size_t end)
+		{
+			if (m_report.nbReportedRegions >= DATA_DIFF_MAX_REGIONS)
+				return;
+
+			if (end > m_regionStart + DATA_DIFF_EXCERPT_SIZE)
+				end = m_regionStart + DATA_DIFF_EXCERPT_SIZE;
+
+			const size_t begin = m_regionStart + m_excerptSize;
+			if (end <= begin)
+				return;
+
+			DataDiffRegion& region = m_report.regions[m_report.nbReportedRegions];
+			std::memcpy(region.excerptA + m_excerptSize, m_chunkA + (begin - m_chunkOffset), end - begin);
+			std::memcpy(region.excerptB + m_excerptSize, m_chunkB + (begin - m_chunkOffset), end - begin);
+			m_excerptSize += end - begin;
+		}
+
+		void DataDiffScanner::closeRegion()
+		{
+			m_bInRegion = false;
+			m_report.nbRegions++;
+			if (m_report.nbReportedRegions >= DATA_DIFF_MAX_REGIONS)
+				return;
+
+			DataDiffRegion& region = m_report.regions[m_report.nbReportedRegions++];
+			region.offset = m_regionStart;
+			region.size = m_regionEnd - m_regionStart;
+
+			//The excerpt may hold equal bytes following the region, copied
+			//at the end of the chunk before the region end was known
+			region.excerptSize = (m_excerptSize < region.size) ? m_excerptSize : region.size;
+		}
+
+		void computeDataDiff(DataDiffReport& report, const void* dataA, const void* dataB, size_t sizeInBytes)
+		{
+			DataDiffScanner scanner(report);
+			scanner.scan(dataA, dataB, sizeInBytes);
+			scanner.finish();
+		}
+
+		void formatHexBytes(char* buffer, size_t bufferSize, const unsigned char* bytes, size_t nbBytes)
+		{
+			static const char s_hexDigits[] = "0123456789abcdef";
+
+			if (!buffer || !bufferSize)
+				return;
+
+			size_t len = 0;
+			for (size_t i = 0; i < nbBytes; ++i)
+			{
+				//Each byte needs 2 digits, plus 1 separator if not the first
+				//one, plus the final null character
+				if (len + (i ? 4 : 3) > bufferSize)
+					break;
+
+				if (i)
+					buffer[len++] = ' ';
+
+				buffer[len++] = s_hexDigits[bytes[i] >> 4];
+				buffer[len++] = s_hexDigits[bytes[i] & 0x0F];
+			}
+
+			buffer[len] = '\0';
+		}
+
+		void formatStringContext(char* buffer, size_t bufferSize, const void* str, size_t charSize, size_t charIdx)
+		{
+			ContextWriter writer(buffer, bufferSize);
+			const unsigned char* s = static_cast<const unsigned char*>(str);
+
+			switch (charSize)
+			{
+			case 1:
+				formatContext<std::uint8_t>(writer, s, charIdx);
+				break;
+
+			case 2:
+				formatContext<std::uint16_t>(writer, s, charIdx);
+				break;
+
+			case 4:
+				formatContext<std::uint32_t>(writer, s, charIdx);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,132 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _SIMDCOMPARE_H_
+#define _SIMDCOMPARE_H_
+
+#include <cstddef>
+
+namespace easyTest
+{
+	namespace compare
+	{
+		const size_t NO_MISMATCH = static_cast<size_t>(-1);
+
+		//Returns the index (in characters, not in bytes) of the first
+		//character which differs between the two null-terminated strings
+		//strA and strB, or NO_MISMATCH if both strings are equal.
+		//charSize must be 1, 2 or 4, strA and strB must not be nullptr.
+		//When SSE2 is available, strings are compared 16 bytes at a time.
+		//Vector loads never cross a memory page boundary, so they can never
+		//fault even if they read a few bytes beyond the string terminator.
+		size_t findStringMismatch(const void* strA, const void* strB, size_t charSize);
+
+		//Formats in buffer a bounded window of characters around charIdx in
+		//the null-terminated string str. Printable ASCII characters are
+		//written as-is, all other characters are escaped (\0, \xHH, \uHHHH
+		//or \UHHHHHHHH depending on charSize). The window never reads
+		//beyond the string terminator and the output is always
+		//null-terminated (truncated if bufferSize is too small).
+		//charSize must be 1, 2 or 4 and charIdx must not be greater than the
+		//string length.
+		void formatStringContext(char* buffer, size_t bufferSize, const void* str, size_t charSize, size_t charIdx);
+
+		//Size of a buffer large enough to hold any formatStringContext()
+		//output, whatever the character size.
+		const size_t STRING_CONTEXT_BUFFER_SIZE = 512;
+
+		//Maximum number of differing regions detailed in a DataDiffReport
+		const size_t DATA_DIFF_MAX_REGIONS = 8;
+
+		//Maximum number of bytes copied from each buffer for each detailed
+		//region
+		const size_t DATA_DIFF_EXCERPT_SIZE = 16;
+
+		//Two differing ranges separated by at most this number of equal bytes
+		//are coalesced into a single region
+		const size_t DATA_DIFF_COALESCE_GAP = 8;
+
+		struct DataDiffRegion
+		{
+			size_t offset;		//offset of the first differing byte
+			size_t size;		//size of the region, from its first to its last differing byte
+			size_t excerptSize;	//number of valid bytes in excerptA and excerptB
+			unsigned char excerptA[DATA_DIFF_EXCERPT_SIZE];
+			unsigned char excerptB[DATA_DIFF_EXCERPT_SIZE];
+		};
+
+		struct DataDiffReport
+		{
+			//nbRegions can be greater than nbReportedRegions, only the first
+			//DATA_DIFF_MAX_REGIONS regions are detailed.
+
+			size_t sizeInBytes;
+			size_t nbMismatchBytes;
+			size_t nbRegions;
+			size_t nbReportedRegions;
+			DataDiffRegion regions[DATA_DIFF_MAX_REGIONS];
+		};
+
+		//Fills a DataDiffReport from data compared chunk by chunk, so that
+		//both data blocks never have to be entirely accessible at the same
+		//time (memory mapped files for instance). When SSE2 is available,
+		//data is compared 64 bytes at a time until a difference is found.
+		class DataDiffScanner final
+		{
+		public:
+			//report is reset and then filled as chunks are scanned
+			DataDiffScanner(DataDiffReport& report);
+
+			//Compares the next sizeInBytes bytes of both data blocks, chunks
+			//must be scanned in order. Chunk data is not accessed anymore
+			//once the method has returned. dataA and dataB must not be
+			//nullptr.
+			void scan(const void* dataA, const void* dataB, size_t sizeInBytes);
+
+			//Must be called once after the last chunk in order to complete
+			//the report
+			void finish();
+
+		private:
+			DataDiffScanner(const DataDiffScanner&) = delete;
+			DataDiffScanner& operator=(const DataDiffScanner&) = delete;
+
+			void addMismatch(size_t offset);
+			void fillExcerpt(size_t end);
+			void closeRegion();
+
+			DataDiffReport& m_report;
+
+			const unsigned char* m_chunkA = nullptr;
+			const unsigned char* m_chunkB = nullptr;
+			size_t m_chunkOffset = 0;
+
+			bool m_bInRegion = false;
+			size_t m_regionStart = 0;
+			size_t m_regionEnd = 0;
+			size_t m_excerptSize = 0;
+		};
+
+		//Compares sizeInBytes bytes of dataA and dataB in a single chunk and
+		//fills report with the total number of differing bytes and the first
+		//differing regions. dataA and dataB must not be nullptr.
+		void computeDataDiff(DataDiffReport& report, const void* dataA, const void* dataB, size_t sizeInBytes);
+
+		//Formats nbBytes bytes as space-separated hexadecimal values. The
+		//output is always null-terminated (truncated if bufferSize is too
+		//small).
+		void formatHexBytes(char* buffer, size_t bufferSize, const unsigned char* bytes, size_t nbBytes);
+
+		//Size of a buffer large enough to hold any formatHexBytes() output of
+		//a DataDiffRegion excerpt.
+		const size_t HEX_EXCERPT_BUFFER_SIZE = DATA_DIFF_EXCERPT_SIZE * 3;
+	}
+}
+
+#endif //_SIMDCOMPARE_H_
@@ -33,6 +33,100 @@ namespace easyTest
 			TIME_PREFIX_PROC,
 			TIME_PREFIX_THREAD,
 			STATS_NOT_AVAILABLE,
+			STATS_ASSERT_COUNT,
+			BENCH_ITERATIONS,
+			BENCH_PREFIX_MIN,
+			BENCH_PREFIX_MEDIAN,
+			BENCH_PREFIX_MEAN,
+			BENCH_PREFIX_MAD,
+			BENCH_PREFIX_MAX,
+			BENCH_PREFIX_CPU,
+			BENCH_BYTES_RATE,
+			BENCH_ITEMS_RATE,
+			BENCH_COLD_RATIO,
+			RANGE_MEDIAN,
+			COMPLEXITY_O_1,
+			COMPLEXITY_O_LOG_N,
+			COMPLEXITY_O_N,
+			COMPLEXITY_O_N_LOG_N,
+			COMPLEXITY_O_N_SQUARED,
+			COMPLEXITY_BEST_FIT,
+			COMPLEXITY_NOT_FITTED,
+			COMPLEXITY_COEFFICIENT,
+			COMPLEXITY_RMS,
+			COMPLEXITY_EXPECTED,
+			SCALING_ITERATIONS,
+			SCALING_THROUGHPUT,
+			SCALING_THREAD_THROUGHPUT,
+			SCALING_EFFICIENCY,
+			SCALING_FAIRNESS,
+			AB_ITERATIONS,
+			AB_PREFIX_MEDIAN,
+			AB_FASTER,
+			AB_NO_DIFFERENCE,
+			AB_RATIO,
+			SCOPE_RUNS,
+			LATENCY_COUNT,
+			LATENCY_PREFIX_MIN,
+			LATENCY_PREFIX_MEAN,
+			LATENCY_PREFIX_P50,
+			LATENCY_PREFIX_P90,
+			LATENCY_PREFIX_P99,
+			LATENCY_PREFIX_P999,
+			LATENCY_PREFIX_MAX,
+			LATENCY_BUDGET,
+			LATENCY_RUNS,
+			BASELINE_REGRESSION,
+			BASELINE_IMPROVEMENT,
+			BASELINE_UNCHANGED,
+			BASELINE_NOT_ENOUGH,
+			BASELINE_NEW_TEST,
+			BASELINE_MEDIANS,
+			BASELINE_DETAILS,
+			BASELINE_CANNOT_READ,
+			BASELINE_CANNOT_WRITE,
+			CLOCK_UNAVAILABLE,
+			PROFILE_UNAVAILABLE,
+			PROFILE_CANNOT_WRITE,
+			ALLOCS_UNAVAILABLE,
+			OVERHEAD_SUBTRACTED,
+			COUNTER_PREFIX_CYCLES,
+			COUNTER_PREFIX_INSTRUCTIONS,
+			COUNTER_PREFIX_IPC,
+			COUNTER_PREFIX_CACHE_MISSES,
+			COUNTER_PREFIX_BRANCH_MISSES,
+			COUNTER_PREFIX_PAGE_FAULTS,
+			COUNTER_UNAVAILABLE,
+			ALLOC_STATS,
+			RESOURCE_PREFIX_USER,
+			RESOURCE_PREFIX_SYSTEM,
+			RESOURCE_PREFIX_MINOR_FAULTS,
+			RESOURCE_PREFIX_MAJOR_FAULTS,
+			RESOURCE_PREFIX_VOLUNTARY,
+			RESOURCE_PREFIX_INVOLUNTARY,
+			IO_PREFIX_READ_CHARS,
+			IO_PREFIX_WRITTEN_CHARS,
+			IO_PREFIX_READ_SYSCALLS,
+			IO_PREFIX_WRITE_SYSCALLS,
+			IO_PREFIX_READ_BYTES,
+			IO_PREFIX_WRITTEN_BYTES,
+			IO_LIMIT,
+			ENV_PREFIX_CPU,
+			ENV_PREFIX_NB_CPUS,
+			ENV_PREFIX_KERNEL,
+			ENV_PREFIX_GOVERNOR,
+			ENV_PREFIX_TURBO,
+			ENV_PREFIX_LOAD,
+			ENV_PREFIX_NOISE,
+			ENV_PREFIX_PRIORITY,
+			ENV_TURBO_ON,
+			ENV_TURBO_OFF,
+			ENV_PRIORITY_RAISED,
+			ENV_PRIORITY_NORMAL,
+			ENV_WARNING_GOVERNOR,
+			ENV_WARNING_TURBO,
+			ENV_WARNING_LOAD,
+			ENV_WARNING_NOISE,
 
 			//WARNING: ASSERT_FAIL_* strings MUST NOT contain invalid JSON
 			//characters ["\\b\f\n\r\t]
@@ -42,6 +136,15 @@ namespace easyTest
 			ASSERT_FAIL_NAN,
 			ASSERT_FAIL_INFINITE,
 			ASSERT_FAIL_FINITE,
+			ASSERT_FAIL_GOLDEN,
+			ASSERT_FAIL_DIGEST,
+			ASSERT_FAIL_TREE_DIGEST,
+			ASSERT_FAIL_P99,
+			ASSERT_FAIL_MEDIAN,
+			ASSERT_FAIL_P99_CPU,
+			ASSERT_FAIL_MEDIAN_CPU,
+			ASSERT_FAIL_NO_ALLOC,
+			ASSERT_FAIL_COMPLEXITY,
 			ASSERT_FAIL_BINARY,
 			ASSERT_FAIL_LT,
 			ASSERT_FAIL_LE,
@@ -105,6 +208,33 @@ namespace easyTest
 			LOG_CASE_FINISH_OK,
 			LOG_TRACE_HEADER,
 			LOG_ASSERT_HEADER,
+			LOG_STRING_MISMATCH,
+			LOG_DATA_DIFF_SUMMARY,
+			LOG_DATA_DIFF_REGION,
+			LOG_DATA_DIFF_MORE,
+			LOG_GOLDEN_CANNOT_READ,
+			LOG_GOLDEN_SIZE_MISMATCH,
+			LOG_GOLDEN_CANNOT_UPDATE,
+			LOG_DIGEST_MISMATCH,
+			LOG_LATENCY_MEASURED,
+			LOG_BENCHMARK_HEADER,
+			LOG_COLD_HEADER,
+			LOG_RANGE_HEADER,
+			LOG_COMPLEXITY_HEADER,
+			LOG_THREADS_HEADER,
+			LOG_AB_MEASURE_HEADER,
+			LOG_AB_HEADER,
+			LOG_LATENCIES_HEADER,
+			LOG_COUNTERS_HEADER,
+			LOG_ALLOCS_HEADER,
+			LOG_SCOPE_HEADER,
+			LOG_METRIC_HEADER,
+			LOG_RESOURCES_HEADER,
+			LOG_IO_HEADER,
+			LOG_IO_LIMIT_HEADER,
+			LOG_CASE_OVERHEAD,
+			LOG_ENVIRONMENT_HEADER,
+			LOG_WARNING_HEADER,
 			LOG_RTERROR_HEADER,
 
 			TAP_RUNNER_START,
@@ -113,12 +243,46 @@ namespace easyTest
 			TAP_FAILED_SUITE,
 			TAP_TRACE_HEADER,
 			TAP_ASSERT_HEADER,
+			TAP_STRING_MISMATCH,
+			TAP_DATA_DIFF_SUMMARY,
+			TAP_DATA_DIFF_REGION,
+			TAP_DATA_DIFF_MORE,
+			TAP_GOLDEN_CANNOT_READ,
+			TAP_GOLDEN_SIZE_MISMATCH,
+			TAP_GOLDEN_CANNOT_UPDATE,
+			TAP_DIGEST_MISMATCH,
+			TAP_LATENCY_MEASURED,
+			TAP_BENCHMARK_HEADER,
+			TAP_COLD_HEADER,
+			TAP_RANGE_HEADER,
+			TAP_COMPLEXITY_HEADER,
+			TAP_THREADS_HEADER,
+			TAP_AB_MEASURE_HEADER,
+			TAP_AB_HEADER,
+			TAP_LATENCIES_HEADER,
+			TAP_COMMENT,
+			TAP_COUNTERS_HEADER,
+			TAP_ALLOCS_HEADER,
+			TAP_SCOPE_HEADER,
+			TAP_RESOURCES_HEADER,
+			TAP_IO_HEADER,
+			TAP_IO_LIMIT_HEADER,
+			TAP_CASE_OVERHEAD,
+			TAP_ENVIRONMENT_HEADER,
+			TAP_WARNING_HEADER,
 			TAP_RTERROR_HEADER,
 
 			NB_STRINGS,
 
 			TIME_UNITS_SEQ = TIME_UNIT_MIN,
-			TIME_PREFIXES_SEQ = TIME_PREFIX_REAL
+			TIME_PREFIXES_SEQ = TIME_PREFIX_REAL,
+			BENCH_PREFIXES_SEQ = BENCH_PREFIX_MIN,
+			COMPLEXITY_NAMES_SEQ = COMPLEXITY_O_1,
+			COUNTER_PREFIXES_SEQ = COUNTER_PREFIX_CYCLES,
+			RESOURCE_PREFIXES_SEQ = RESOURCE_PREFIX_USER,
+			IO_PREFIXES_SEQ = IO_PREFIX_READ_CHARS,
+			ENV_PREFIXES_SEQ = ENV_PREFIX_CPU,
+			LATENCY_PREFIXES_SEQ = LATENCY_PREFIX_MIN
 		};
 
 		const char* getString(StringId id);
@@ -7,6 +7,8 @@
  * See: http://opensource.org/licenses/MIT
  */
 
+#include <cstdio>
+#include <cstring>
 #include <cstdlib>
 #include <csignal>
 #include <climits>
@@ -25,6 +27,15 @@
 #include "output/LOGWriter.h"
 #include "output/JSWriter.h"
 #include "output/TAPWriter.h"
+#include "output/GBenchWriter.h"
+#include "compare/GoldenFile.h"
+#include "stats/BenchmarkStats.h"
+#include "stats/Baseline.h"
+#include "stats/PerfCounters.h"
+#include "stats/AllocTracker.h"
+#include "stats/IoUsage.h"
+#include "stats/Profiler.h"
+#include "stats/Chrono.h"
 #include "i18n/i18n.h"
 
 namespace
@@ -103,11 +114,42 @@ namespace
 			return m_nbThreads;
 		}
 
+		bool isOverheadSubtracted() const
+		{
+			return m_bSubtractOverhead;
+		}
+
+		bool isPriorityRaised() const
+		{
+			return m_bRaisePriority;
+		}
+
 		easyTest::ITestListener* getTestListener() const
 		{
+			if (m_pBaselineRecorder)
+				return m_pBaselineRecorder;
+
 			return m_pTestListener;
 		}
 
+		//nullptr if no baseline is saved or compared
+		easyTest::stats::BaselineRecorder* getBaselineRecorder() const
+		{
+			return m_pBaselineRecorder;
+		}
+
+		//nullptr if the baseline must not be saved
+		const char* getSaveBaselinePath() const
+		{
+			return m_saveBaselinePath;
+		}
+
+		//nullptr if the test cases are not profiled
+		const char* getProfilePath() const
+		{
+			return m_profilePath;
+		}
+
 	private:
 		Config() = default;
 		Config(const Config&) = delete;
@@ -125,11 +167,34 @@ namespace
 		bool m_bNeedRegistrarsDeletion = false;
 
 		unsigned int m_nbThreads = easyTest::TestRunner::NB_HARDWARE_THREADS;
+		bool m_bSubtractOverhead = false;
+		bool m_bRaisePriority = false;
 		easyTest::ITestListener* m_pTestListener = nullptr;
 
 		std::FILE* m_pOutputFile = nullptr;
+
+		easyTest::stats::BaselineRecorder* m_pBaselineRecorder = nullptr;
+		char* m_saveBaselinePath = nullptr;
+		const char* m_profilePath = nullptr;
 	};
 
+	const char* const BASELINE_FILE_EXTENSION = ".etb";
+
+	//Baseline files are named after the baseline: NAME.etb
+	char* makeBaselinePath(const char* baselineName)
+	{
+		const size_t nameLen = std::strlen(baselineName);
+		const size_t extLen = std::strlen(BASELINE_FILE_EXTENSION);
+		char* path = new(std::nothrow) char[nameLen + extLen + 1];
+		if (path)
+		{
+			std::memcpy(path, baselineName, nameLen);
+			std::memcpy(path + nameLen, BASELINE_FILE_EXTENSION, extLen + 1);
+		}
+
+		return path;
+	}
+
 	Config Config::s_config;
 
 	void Config::reset()
@@ -148,6 +213,29 @@ namespace
 		m_nbTestSuites = 0;
 		m_bNeedRegistrarsDeletion = false;
 		m_nbThreads = easyTest::TestRunner::NB_HARDWARE_THREADS;
+		m_bSubtractOverhead = false;
+		m_bRaisePriority = false;
+		easyTest::compare::setGoldenUpdateMode(false);
+		easyTest::stats::setBenchmarkTargetTime(easyTest::stats::DEFAULT_BENCHMARK_TARGET_TIME);
+		easyTest::stats::setPerfCountersEnabled(false);
+		easyTest::stats::setAllocTrackingEnabled(false);
+		easyTest::stats::setIoAccountingEnabled(false);
+		easyTest::stats::setMaxIoPerCase(0);
+		easyTest::stats::setProfilingEnabled(false);
+		m_profilePath = nullptr;
+		easyTest::stats::setRealTimeClock(easyTest::stats::RealTimeClock::OS);
+
+		if (m_pBaselineRecorder)
+		{
+			delete m_pBaselineRecorder;
+			m_pBaselineRecorder = nullptr;
+		}
+
+		if (m_saveBaselinePath)
+		{
+			delete[] m_saveBaselinePath;
+			m_saveBaselinePath = nullptr;
+		}
 
 		if (m_pTestListener)
 		{
@@ -168,13 +256,24 @@ namespace
 
 		bool bVerbose = false;
 		bool bStats = false;
+		bool bUpdateGolden = false;
+		bool bPerfCounters = false;
+		bool bAllocs = false;
+		long long maxIoPerCase = 0;
+		easyTest::stats::RealTimeClock realTimeClock = easyTest::stats::RealTimeClock::OS;
+		long long benchTargetTime = easyTest::stats::DEFAULT_BENCHMARK_TARGET_TIME;
 		const char* outputPath = nullptr;
+		const char* saveBaselineName = nullptr;
+		const char* compareBaselineName = nullptr;
+		double baselineAlpha = easyTest::stats::DEFAULT_BASELINE_ALPHA;
+		double baselineMinEffect = easyTest::stats::DEFAULT_BASELINE_MIN_EFFECT;
 
 		enum struct OutputType : unsigned char
 		{
 			LOG,
 			JS,
-			TAP
+			TAP,
+			GBENCH
 		} outputType = OutputType::LOG;
 
 		//Fetch options
@@ -199,12 +298,81 @@ namespace
 							|| !strcasecmp(arg + i, "list")
 							|| !strcasecmp(arg + i, "verbose")
 							|| !strcasecmp(arg + i, "stats")
+							|| !strcasecmp(arg + i, "update-golden")
+							|| !strcasecmp(arg + i, "bench-time")
+							|| !strcasecmp(arg + i, "perf-counters")
+							|| !strcasecmp(arg + i, "allocs")
+							|| !strcasecmp(arg + i, "clock")
 #ifndef EASYTEST_NO_THREADS
 							|| !strcasecmp(arg + i, "nthreads")
 #endif //!EASYTEST_NO_THREADS
 							|| !strcasecmp(arg + i, "out")
 							|| !strcasecmp(arg + i, "type")))
 						arg[3] = '\0';
+					else if ((i == 2) && !strcasecmp(arg + i, "subtract-overhead"))
+					{
+						//Long-only option without value
+						s_config.m_bSubtractOverhead = true;
+						arg[i] = '\0';
+					}
+					else if ((i == 2) && !strcasecmp(arg + i, "raise-priority"))
+					{
+						//Long-only option without value
+						s_config.m_bRaisePriority = true;
+						arg[i] = '\0';
+					}
+					else if ((i == 2)
+							&& (!strcasecmp(arg + i, "save-baseline")
+							|| !strcasecmp(arg + i, "compare-baseline")
+							|| !strcasecmp(arg + i, "baseline-alpha")
+							|| !strcasecmp(arg + i, "baseline-effect")
+							|| !strcasecmp(arg + i, "max-io-per-case")
+							|| !strcasecmp(arg + i, "profile"))
+							&& (argc > 1) && (**(argv + 1) != '-'))
+					{
+						//Long-only options, always followed by a value
+						argc--;
+						const char* str = *++argv;
+
+						if (!strcasecmp(arg + i, "save-baseline"))
+							saveBaselineName = str;
+						else if (!strcasecmp(arg + i, "compare-baseline"))
+							compareBaselineName = str;
+						else if (!strcasecmp(arg + i, "profile"))
+							s_config.m_profilePath = str;
+						else if (!strcasecmp(arg + i, "max-io-per-case"))
+						{
+							char* pEnd = nullptr;
+							long long nbBytes = std::strtoll(str, &pEnd, 10);
+							if (!pEnd || (pEnd == str) || (*pEnd != '\0') || (nbBytes <= 0) || (nbBytes == LLONG_MAX))
+							{
+								s_config.reset();
+								std::fprintf(stderr, "%s", invalidArgs);
+								return s_config;
+							}
+
+							maxIoPerCase = nbBytes;
+						}
+						else
+						{
+							char* pEnd = nullptr;
+							double value = std::strtod(str, &pEnd);
+							bool bAlpha = !strcasecmp(arg + i, "baseline-alpha");
+							if (!pEnd || (pEnd == str) || (*pEnd != '\0') || !(value > 0.0) || (bAlpha && !(value < 1.0)) || (!bAlpha && !(value < 1000.0)))
+							{
+								s_config.reset();
+								std::fprintf(stderr, "%s", invalidArgs);
+								return s_config;
+							}
+
+							if (bAlpha)
+								baselineAlpha = value;
+							else
+								baselineMinEffect = value / 100.0;
+						}
+
+						arg[i] = '\0';
+					}
 					else
 					{
 						s_config.reset();
@@ -235,6 +403,75 @@ namespace
 					bStats = true;
 					break;
 
+				case 'u':
+				case 'U':
+					bUpdateGolden = true;
+					break;
+
+				case 'p':
+				case 'P':
+					bPerfCounters = true;
+					break;
+
+				case 'a':
+				case 'A':
+					bAllocs = true;
+					break;
+
+				case 'c':
+				case 'C':
+					if (bNextArgUsed || (argc <= 1) || (**(argv + 1) == '-'))
+					{
+						s_config.reset();
+						std::fprintf(stderr, "%s", invalidArgs);
+						return s_config;
+					}
+					else
+					{
+						bNextArgUsed = true;
+						argc--;
+						const char* str = *++argv;
+
+						if (!strcasecmp(str, "os"))
+							realTimeClock = easyTest::stats::RealTimeClock::OS;
+						else if (!strcasecmp(str, "tsc"))
+							realTimeClock = easyTest::stats::RealTimeClock::TSC;
+						else
+						{
+							s_config.reset();
+							std::fprintf(stderr, "%s", invalidArgs);
+							return s_config;
+						}
+					}
+					break;
+
+				case 'b':
+				case 'B':
+					if (bNextArgUsed || (argc <= 1) || (**(argv + 1) == '-'))
+					{
+						s_config.reset();
+						std::fprintf(stderr, "%s", invalidArgs);
+						return s_config;
+					}
+					else
+					{
+						bNextArgUsed = true;
+						argc--;
+						const char* str = *++argv;
+
+						char* pEnd = nullptr;
+						long ms = std::strtol(str, &pEnd, 10);
+						if (!pEnd || (pEnd == str) || (*pEnd != '\0') || (ms <= 0) || (ms == LONG_MAX))
+						{
+							s_config.reset();
+							std::fprintf(stderr, "%s", invalidArgs);
+							return s_config;
+						}
+
+						benchTargetTime = ms * 1000000LL;
+					}
+					break;
+
 #ifndef EASYTEST_NO_THREADS
 				case 'n':
 				case 'N':
@@ -305,6 +542,8 @@ namespace
 							outputType = OutputType::JS;
 						else if (!strcasecmp(str, "tap"))
 							outputType = OutputType::TAP;
+						else if (!strcasecmp(str, "gbench"))
+							outputType = OutputType::GBENCH;
 						else
 						{
 							s_config.reset();
@@ -405,6 +644,10 @@ namespace
 		case OutputType::TAP:
 			s_config.m_pTestListener = new(std::nothrow) easyTest::output::TAPWriter(pOut, bStats, bVerbose);
 			break;
+
+		case OutputType::GBENCH:
+			s_config.m_pTestListener = new(std::nothrow) easyTest::output::GBenchWriter(pOut, bStats, bVerbose);
+			break;
 		}
 
 		if (!s_config.m_pTestListener)
@@ -414,6 +657,69 @@ namespace
 			return s_config;
 		}
 
+		if (saveBaselineName || compareBaselineName)
+		{
+			s_config.m_pBaselineRecorder = new(std::nothrow) easyTest::stats::BaselineRecorder(s_config.m_pTestListener, baselineAlpha, baselineMinEffect);
+			if (!s_config.m_pBaselineRecorder)
+			{
+				s_config.reset();
+				std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::OUT_OF_MEMORY));
+				return s_config;
+			}
+
+			if (saveBaselineName)
+			{
+				s_config.m_saveBaselinePath = makeBaselinePath(saveBaselineName);
+				if (!s_config.m_saveBaselinePath)
+				{
+					s_config.reset();
+					std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::OUT_OF_MEMORY));
+					return s_config;
+				}
+			}
+
+			if (compareBaselineName)
+			{
+				char* path = makeBaselinePath(compareBaselineName);
+				bool bLoaded = path && s_config.m_pBaselineRecorder->loadBaseline(path);
+				delete[] path;
+
+				if (!bLoaded)
+				{
+					s_config.reset();
+					std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::BASELINE_CANNOT_READ));
+					return s_config;
+				}
+			}
+		}
+
+		easyTest::compare::setGoldenUpdateMode(bUpdateGolden);
+		easyTest::stats::setBenchmarkTargetTime(benchTargetTime);
+		easyTest::stats::setPerfCountersEnabled(bPerfCounters);
+		easyTest::stats::setIoAccountingEnabled(bStats || (maxIoPerCase > 0));
+		easyTest::stats::setMaxIoPerCase(maxIoPerCase);
+
+		if (!easyTest::stats::setRealTimeClock(realTimeClock))
+		{
+			s_config.reset();
+			std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::CLOCK_UNAVAILABLE));
+			return s_config;
+		}
+
+		if (!easyTest::stats::setAllocTrackingEnabled(bAllocs))
+		{
+			s_config.reset();
+			std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::ALLOCS_UNAVAILABLE));
+			return s_config;
+		}
+
+		if (s_config.m_profilePath && !easyTest::stats::setProfilingEnabled(true))
+		{
+			s_config.reset();
+			std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::PROFILE_UNAVAILABLE));
+			return s_config;
+		}
+
 		return s_config;
 	}
 
@@ -444,6 +750,8 @@ int main(int argc, char* argv[])
 		return 0;
 	}
 
+	s_runner.setCaseOverheadSubtraction(conf.isOverheadSubtracted());
+	s_runner.setPriorityRaise(conf.isPriorityRaised());
 	if (!s_runner.startTestSuites(conf.getTestSuiteList(), conf.getNBTestSuites(), conf.getNBThreads(), conf.getTestListener()))
 	{
 		std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::CANNOT_START_RUNNER));
@@ -453,5 +761,28 @@ int main(int argc, char* argv[])
 	if (s_signalQuit)
 		s_runner.stopTestSuites();
 
-	return static_cast<int>(s_runner.waitTestsTermination());
+	//Performance regressions detected against the compared baseline are
+	//counted as failures, so that they can break continuous integration
+	size_t nbFailures = s_runner.waitTestsTermination();
+
+	easyTest::stats::BaselineRecorder* pRecorder = conf.getBaselineRecorder();
+	if (pRecorder)
+	{
+		nbFailures += pRecorder->getNbRegressions();
+
+		if (conf.getSaveBaselinePath() && !pRecorder->saveBaseline(conf.getSaveBaselinePath()))
+		{
+			std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::BASELINE_CANNOT_WRITE));
+			nbFailures++;
+		}
+	}
+
+	//The samples of all worker threads are gathered when they terminate
+	if (conf.getProfilePath() && !easyTest::stats::writeProfile(conf.getProfilePath()))
+	{
+		std::fprintf(stderr, "%s", easyTest::i18n::getString(easyTest::i18n::PROFILE_CANNOT_WRITE));
+		nbFailures++;
+	}
+
+	return static_cast<int>(nbFailures);
 }
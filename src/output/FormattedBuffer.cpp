@@ -342,6 +342,23 @@ namespace easyTest
 			return *this;
 		}
 
+		FormattedBuffer& FormattedBuffer::formatPreciseTime(double t, const char* const units[5])
+		{
+			if (units)
+			{
+				if (t >= 1000000000.0)
+					appendFormat("%0.3f%s", t / 1000000000.0, units[1]);
+				else if (t >= 1000000.0)
+					appendFormat("%0.3f%s", t / 1000000.0, units[2]);
+				else if (t >= 1000.0)
+					appendFormat("%0.3f%s", t / 1000.0, units[3]);
+				else
+					appendFormat("%0.3f%s", t, units[4]);
+			}
+
+			return *this;
+		}
+
 		FormattedBuffer& FormattedBuffer::insert(char c)
 		{
 			assert(m_insertMark <= m_strLen);
@@ -38,6 +38,10 @@ namespace easyTest
 			//t must be in ns.
 			FormattedBuffer& formatTime(long long t, const char* const units[5], bool bInsert);
 
+			//Same as formatTime() but keeps fractions of ns, for mean times
+			//per iteration. Always appends.
+			FormattedBuffer& formatPreciseTime(double t, const char* const units[5]);
+
 			void setInsertMark()
 			{
 				m_insertMark = m_strLen;
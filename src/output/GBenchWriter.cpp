@@ -0,0 +1,272 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "GBenchWriter.h"
+
+#include <ctime>
+
+#include "../../include/Benchmark.h"
+#include "../../include/TimedScope.h"
+#include "../../include/CaseMetrics.h"
+#include "../TestRunner.h"
+#include "../stats/BenchEnvironment.h"
+#include "FormattedBuffer.h"
+
+namespace
+{
+	//Appends the fields of an iteration entry after its name and run name,
+	//the entry is left open for extra counters
+	void appendIterationEntry(easyTest::output::FormattedBuffer& buffer, unsigned int nbThreads, size_t nbIterations, double realTime, double cpuTime, double bytesPerSecond, double itemsPerSecond, bool bSuccess)
+	{
+		buffer.appendFormat("      \"run_type\": \"iteration\",\n      \"repetitions\": 1,\n      \"repetition_index\": 0,\n      \"threads\": %u,\n", nbThreads)
+				.appendFormat("      \"iterations\": %zu,\n      \"real_time\": %0.3f,\n      \"cpu_time\": %0.3f,\n      \"time_unit\": \"ns\"", nbIterations, realTime, cpuTime);
+
+		if (bytesPerSecond > 0.0)
+			buffer.appendFormat(",\n      \"bytes_per_second\": %0.3f", bytesPerSecond);
+
+		if (itemsPerSecond > 0.0)
+			buffer.appendFormat(",\n      \"items_per_second\": %0.3f", itemsPerSecond);
+
+		if (!bSuccess)
+			buffer.append(",\n      \"error_occurred\": true,\n      \"error_message\": \"test case has failed\"");
+	}
+}
+
+namespace easyTest
+{
+	namespace output
+	{
+		void GBenchWriter::onEvent(const TestEvent& event)
+		{
+			switch (event.type)
+			{
+			case TestEventType::TESTRUNNER_START:
+				TestWriter::onEvent(event);
+				m_bFirstEntry = true;
+
+				{
+					FormattedBuffer* pBuffer = getControlThreadBuffer();
+					if (pBuffer)
+					{
+						char date[32] = {};
+						const std::time_t now = std::time(nullptr);
+						std::tm localNow = {};
+#ifdef __linux__
+						if (localtime_r(&now, &localNow))
+#elif defined(_WIN32)
+						if (!localtime_s(&localNow, &now))
+#endif //__linux__
+							std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &localNow);
+
+#ifdef NDEBUG
+						const char* const buildType = "release";
+#else //NDEBUG is not defined
+						const char* const buildType = "debug";
+#endif //NDEBUG
+
+						pBuffer->append("{\n  \"context\": {\n")
+								.appendFormat("    \"date\": \"%s\",\n    \"executable\": \"EasyTest++\",\n    \"num_cpus\": %u,\n    \"library_build_type\": \"%s\"", date, TestRunner::NB_HARDWARE_THREADS, buildType);
+
+						//Same field names as Google Benchmark when they exist,
+						//unavailable values are null
+						const stats::BenchEnvironment* pEnv = event.testRunnerStart.pEnvironment;
+						if (pEnv)
+						{
+							pBuffer->append(",\n    \"cpu_model\": ");
+							if (pEnv->cpuModel[0])
+								pBuffer->append('"').appendJSString(pEnv->cpuModel).append('"');
+							else
+								pBuffer->append("null");
+
+							pBuffer->append(",\n    \"kernel\": ");
+							if (pEnv->kernel[0])
+								pBuffer->append('"').appendJSString(pEnv->kernel).append('"');
+							else
+								pBuffer->append("null");
+
+							if (pEnv->governor[0])
+								pBuffer->append(",\n    \"cpu_governor\": \"").appendJSString(pEnv->governor)
+										.append("\",\n    \"cpu_scaling_enabled\": ").append(stats::hasEnvironmentWarning(*pEnv, stats::EnvironmentWarning::GOVERNOR) ? "true" : "false");
+							else
+								pBuffer->append(",\n    \"cpu_governor\": null,\n    \"cpu_scaling_enabled\": null");
+
+							pBuffer->append(",\n    \"turbo_enabled\": ").append((pEnv->turbo < 0) ? "null" : (pEnv->turbo ? "true" : "false"));
+
+							if (pEnv->loadAverage < 0.0)
+								pBuffer->append(",\n    \"load_avg\": []");
+							else
+								pBuffer->appendFormat(",\n    \"load_avg\": [%0.2f]", pEnv->loadAverage);
+
+							if (pEnv->noise < 0.0)
+								pBuffer->append(",\n    \"noise\": null");
+							else
+								pBuffer->appendFormat(",\n    \"noise\": %0.4f", pEnv->noise);
+
+							pBuffer->append(",\n    \"priority_raised\": ").append(pEnv->bPriorityRaised ? "true" : "false");
+						}
+
+						pBuffer->append("\n  },\n  \"benchmarks\": [")
+								.flushAndClear(m_pOut);
+					}
+				}
+				break;
+
+			case TestEventType::TESTRUNNER_FINISH:
+				{
+					FormattedBuffer* pBuffer = getControlThreadBuffer();
+					if (pBuffer)
+						pBuffer->append("\n  ]\n}\n").flushAndClear(m_pOut);
+				}
+
+				TestWriter::onEvent(event);
+				break;
+
+			case TestEventType::TESTCASE_FINISH:
+				if (event.testCaseFinish.pBenchmark || event.testCaseFinish.pComplexity || event.testCaseFinish.pScaling || event.testCaseFinish.pAB)
+				{
+					FormattedBuffer* pBuffer = getWorkerThreadBuffer(event.testCaseFinish.workerThreadIdx);
+					if (pBuffer)
+					{
+						const char* suiteName = event.testCaseFinish.testSuiteName;
+						const char* caseName = event.testCaseFinish.testCaseName;
+
+						if (event.testCaseFinish.pBenchmark)
+						{
+							const BenchmarkResult& result = *event.testCaseFinish.pBenchmark;
+
+							pBuffer->appendFormat("\n    {\n      \"name\": \"%s/%s\",\n      \"run_name\": \"%s/%s\",\n", suiteName, caseName, suiteName, caseName);
+							appendIterationEntry(*pBuffer, 1, result.nbIterations * result.nbSamples, result.meanTime, result.cpuTime, result.bytesPerSecond, result.itemsPerSecond, event.testCaseFinish.bSuccess);
+
+							//Recorded latencies are written as user counters
+							const LatencyHistogram* pLatencies = event.testCaseFinish.pLatencies;
+							if (pLatencies)
+								pBuffer->appendFormat(",\n      \"latency_p50\": %lld,\n      \"latency_p90\": %lld,\n      \"latency_p99\": %lld,\n      \"latency_p999\": %lld,\n      \"latency_max\": %lld",
+										pLatencies->getValueAtPercentile(50.0), pLatencies->getValueAtPercentile(90.0), pLatencies->getValueAtPercentile(99.0), pLatencies->getValueAtPercentile(99.9), pLatencies->getMax());
+
+							//So are the TIMED_SCOPE sites, with their number
+							//of runs and total times (in ns)
+							const ScopeTimings* pScopes = event.testCaseFinish.pScopes;
+							for (size_t i = 0; pScopes && (i < pScopes->getNbScopes()); ++i)
+							{
+								const ScopeTiming& timing = pScopes->getScope(i);
+								const char* scopeName = timing.pSite->getName();
+								pBuffer->append(",\n      \"scope/").appendJSString(scopeName).appendFormat("/runs\": %zu", timing.nbCalls)
+										.append(",\n      \"scope/").appendJSString(scopeName).appendFormat("/real_time\": %lld", timing.realTime)
+										.append(",\n      \"scope/").appendJSString(scopeName).appendFormat("/thread_time\": %lld", timing.threadTime);
+							}
+
+							//And the metrics published by the test case
+							const CaseMetrics* pMetrics = event.testCaseFinish.pMetrics;
+							for (size_t i = 0; pMetrics && (i < pMetrics->getNbMetrics()); ++i)
+							{
+								const CaseMetric& metric = pMetrics->getMetric(i);
+								pBuffer->append(",\n      \"metric/").appendJSString(metric.name).appendFormat("\": %.10g", metric.value);
+							}
+
+							pBuffer->append("\n    }");
+
+							//Cold cache measures get their own entry, every
+							//iteration being a sample
+							const BenchmarkResult* pCold = event.testCaseFinish.pColdBenchmark;
+							if (pCold)
+							{
+								pBuffer->appendFormat(",\n    {\n      \"name\": \"%s/%s/cold\",\n      \"run_name\": \"%s/%s/cold\",\n", suiteName, caseName, suiteName, caseName);
+								appendIterationEntry(*pBuffer, 1, pCold->nbIterations * pCold->nbSamples, pCold->meanTime, pCold->cpuTime, pCold->bytesPerSecond, pCold->itemsPerSecond, event.testCaseFinish.bSuccess);
+								pBuffer->appendFormat(",\n      \"cold_median\": %0.3f,\n      \"warm_median\": %0.3f\n    }", pCold->medianTime, result.medianTime);
+							}
+						}
+						else if (event.testCaseFinish.pAB)
+						{
+							//One entry per body, the time ratio and its
+							//confidence interval are user counters of the
+							//entry of body B
+							const ABResult& result = *event.testCaseFinish.pAB;
+							const ABMeasure* measures[] = {&result.a, &result.b};
+							for (int i = 0; i < 2; ++i)
+							{
+								const ABMeasure& measure = *measures[i];
+								if (i)
+									pBuffer->append(',');
+
+								pBuffer->appendFormat("\n    {\n      \"name\": \"%s/%s/%s\",\n      \"run_name\": \"%s/%s/%s\",\n", suiteName, caseName, measure.name, suiteName, caseName, measure.name);
+								appendIterationEntry(*pBuffer, 1, measure.nbIterations * result.nbRounds, measure.meanTime, measure.cpuTime, 0.0, 0.0, event.testCaseFinish.bSuccess);
+								pBuffer->appendFormat(",\n      \"median_time\": %0.3f", measure.medianTime);
+								if (i)
+									pBuffer->appendFormat(",\n      \"ab_ratio\": %0.6f,\n      \"ab_ratio_low\": %0.6f,\n      \"ab_ratio_high\": %0.6f", result.ratio, result.lowRatio, result.highRatio);
+
+								pBuffer->append("\n    }");
+							}
+						}
+						else if (event.testCaseFinish.pScaling)
+						{
+							//Same entries as Google Benchmark multi-threaded
+							//runs: one per thread count, real_time being the
+							//time of one iteration in one thread
+							const ScalingResult& result = *event.testCaseFinish.pScaling;
+							for (size_t i = 0; i < result.nbMeasures; ++i)
+							{
+								const ScalingMeasure& measure = result.measures[i];
+								if (i)
+									pBuffer->append(',');
+
+								const double realTime = (measure.throughput > 0.0) ? measure.nbThreads * 1000000000.0 / measure.throughput : 0.0;
+								pBuffer->appendFormat("\n    {\n      \"name\": \"%s/%s/threads:%u\",\n      \"run_name\": \"%s/%s/threads:%u\",\n", suiteName, caseName, measure.nbThreads, suiteName, caseName, measure.nbThreads);
+								appendIterationEntry(*pBuffer, measure.nbThreads, measure.nbIterations, realTime, measure.cpuTime, 0.0, measure.throughput, event.testCaseFinish.bSuccess);
+								pBuffer->appendFormat(",\n      \"efficiency\": %0.6f,\n      \"fairness\": %0.6f\n    }", measure.efficiency, measure.fairness);
+							}
+						}
+						else
+						{
+							//Same entries as Google Benchmark complexity
+							//reports: one per range, then the BigO and RMS
+							//aggregates
+							const ComplexityResult& result = *event.testCaseFinish.pComplexity;
+							for (size_t i = 0; i < result.nbRanges; ++i)
+							{
+								const RangeMeasure& measure = result.ranges[i];
+								if (i)
+									pBuffer->append(',');
+
+								pBuffer->appendFormat("\n    {\n      \"name\": \"%s/%s/%zu\",\n      \"run_name\": \"%s/%s/%zu\",\n", suiteName, caseName, measure.range, suiteName, caseName, measure.range);
+								appendIterationEntry(*pBuffer, 1, measure.nbIterations * measure.nbSamples, measure.meanTime, measure.cpuTime, 0.0, 0.0, event.testCaseFinish.bSuccess);
+								pBuffer->append("\n    }");
+							}
+
+							if (result.bestFit < Complexity::ANY)
+							{
+								static const char* const s_bigONames[] = {"(1)", "lgN", "N", "NlgN", "N^2"};
+
+								pBuffer->appendFormat(",\n    {\n      \"name\": \"%s/%s_BigO\",\n      \"run_name\": \"%s/%s\",\n", suiteName, caseName, suiteName, caseName)
+										.append("      \"run_type\": \"aggregate\",\n      \"repetitions\": 1,\n      \"threads\": 1,\n      \"aggregate_name\": \"BigO\",\n")
+										.appendFormat("      \"cpu_coefficient\": %0.6f,\n      \"real_coefficient\": %0.6f,\n      \"big_o\": \"%s\",\n      \"time_unit\": \"ns\"\n    }", result.cpuCoefficient, result.coefficient, s_bigONames[static_cast<int>(result.bestFit)])
+										.appendFormat(",\n    {\n      \"name\": \"%s/%s_RMS\",\n      \"run_name\": \"%s/%s\",\n", suiteName, caseName, suiteName, caseName)
+										.append("      \"run_type\": \"aggregate\",\n      \"repetitions\": 1,\n      \"threads\": 1,\n      \"aggregate_name\": \"RMS\",\n")
+										.appendFormat("      \"rms\": %0.6f\n    }", result.rms);
+							}
+						}
+
+						while (m_outputLock.test_and_set(std::memory_order_acquire));
+
+						if (m_bFirstEntry)
+							m_bFirstEntry = false;
+						else
+							pBuffer->insert(','); //worker buffers only hold the entries, the insert mark is at their beginning
+
+						pBuffer->flushAndClear(m_pOut);
+						m_outputLock.clear(std::memory_order_release);
+					}
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+}
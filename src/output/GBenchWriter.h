@@ -0,0 +1,56 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _GBENCHWRITER_H_
+#define	_GBENCHWRITER_H_
+
+#include <atomic>
+
+#include "TestWriter.h"
+
+namespace easyTest
+{
+	namespace output
+	{
+		//Writes the results of benchmark cases only, as a Google Benchmark
+		//JSON report (same format as --benchmark_format=json) which can be
+		//processed by the Google Benchmark tools (compare.py for instance).
+		//Ordinary test cases and assert failures are not reported.
+		class GBenchWriter final : public TestWriter
+		{
+		public:
+			GBenchWriter(std::FILE* pOut, bool bStats, bool bVerbose) : TestWriter(pOut, bStats, bVerbose) {}
+
+			virtual void onEvent(const TestEvent& event) override final;
+
+			virtual void onTrace(unsigned int, const SrcInfo&, const char*, std::va_list&) override final {}
+
+			virtual void onUnaryAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*) override final {}
+			virtual void onBinaryAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*, const char*) override final {}
+			virtual void onStringAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*, const char*, size_t, const char*, const char*) override final {}
+			virtual void onDataAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*, const char*, const compare::DataDiffReport&) override final {}
+			virtual void onGoldenAssertFailure(unsigned int, const SrcInfo&, const char*, const char*, compare::GoldenStatus, size_t, size_t, const compare::DataDiffReport*) override final {}
+			virtual void onDigestAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*, const char*, const char*) override final {}
+			virtual void onLatencyAssertFailure(unsigned int, const SrcInfo&, AssertType, const char*, long long, double, size_t, size_t) override final {}
+
+			virtual void onBaselineComparison(const BaselineComparison&) override final {}
+
+			virtual void onRuntimeError(unsigned int, RTErrorType, const char*) override final {}
+
+		private:
+			//Benchmark entries are written by the worker-threads, the lock
+			//makes sure that the separator between two entries is always
+			//written with the second entry.
+			std::atomic_flag m_outputLock = ATOMIC_FLAG_INIT;
+			bool m_bFirstEntry = true;
+		};
+	}
+}
+
+#endif //_GBENCHWRITER_H_
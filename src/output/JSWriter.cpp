@@ -9,8 +9,18 @@
 
 #include "JSWriter.h"
 
+#include <new>
+
 #include "../../include/TestSuite.h"
+#include "../../include/Benchmark.h"
 #include "../stats/CodeTimer.h"
+#include "../stats/PerfCounters.h"
+#include "../stats/AllocTracker.h"
+#include "../stats/ResourceUsage.h"
+#include "../stats/IoUsage.h"
+#include "../stats/BenchEnvironment.h"
+#include "../compare/SimdCompare.h"
+#include "../compare/GoldenFile.h"
 #include "FormattedBuffer.h"
 
 namespace
@@ -34,6 +44,461 @@ namespace
 
 		return buffer;
 	}
+
+	//Appends a benchmark result as a JS object, times are in ns per
+	//iteration
+	easyTest::output::FormattedBuffer& formatBenchmark(easyTest::output::FormattedBuffer& buffer, const easyTest::BenchmarkResult* pResult, bool bVerbose)
+	{
+		if (pResult)
+		{
+			if (bVerbose)
+				buffer.appendFormat("{nbIterations: %zu, nbSamples: %zu, min: %0.3f, median: %0.3f, mean: %0.3f, mad: %0.3f, max: %0.3f, cpu: %0.3f, bytesPerSecond: %0.3f, itemsPerSecond: %0.3f}", pResult->nbIterations, pResult->nbSamples, pResult->minTime, pResult->medianTime, pResult->meanTime, pResult->madTime, pResult->maxTime, pResult->cpuTime, pResult->bytesPerSecond, pResult->itemsPerSecond);
+			else
+				buffer.appendFormat("{\"nbIterations\":%zu,\"nbSamples\":%zu,\"min\":%0.3f,\"median\":%0.3f,\"mean\":%0.3f,\"mad\":%0.3f,\"max\":%0.3f,\"cpu\":%0.3f,\"bytesPerSecond\":%0.3f,\"itemsPerSecond\":%0.3f}", pResult->nbIterations, pResult->nbSamples, pResult->minTime, pResult->medianTime, pResult->meanTime, pResult->madTime, pResult->maxTime, pResult->cpuTime, pResult->bytesPerSecond, pResult->itemsPerSecond);
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends a range benchmark result as a JS object, times are in ns per
+	//iteration. bestFit and expected are the complexity names, null if they
+	//are nullptr.
+	easyTest::output::FormattedBuffer& formatComplexity(easyTest::output::FormattedBuffer& buffer, const easyTest::ComplexityResult* pResult, const char* bestFit, const char* expected, bool bVerbose)
+	{
+		if (pResult)
+		{
+			buffer.append(bVerbose ? "{ranges: [" : "{\"ranges\":[");
+			for (size_t i = 0; i < pResult->nbRanges; ++i)
+			{
+				const easyTest::RangeMeasure& measure = pResult->ranges[i];
+				if (i)
+					buffer.append(bVerbose ? ", " : ",");
+
+				if (bVerbose)
+					buffer.appendFormat("{range: %zu, nbIterations: %zu, nbSamples: %zu, median: %0.3f, mean: %0.3f, cpu: %0.3f}", measure.range, measure.nbIterations, measure.nbSamples, measure.medianTime, measure.meanTime, measure.cpuTime);
+				else
+					buffer.appendFormat("{\"range\":%zu,\"nbIterations\":%zu,\"nbSamples\":%zu,\"median\":%0.3f,\"mean\":%0.3f,\"cpu\":%0.3f}", measure.range, measure.nbIterations, measure.nbSamples, measure.medianTime, measure.meanTime, measure.cpuTime);
+			}
+
+			buffer.append(bVerbose ? "], bestFit: " : "],\"bestFit\":");
+			if (bestFit)
+				buffer.appendFormat("\"%s\"", bestFit);
+			else
+				buffer.append("null");
+
+			if (bVerbose)
+				buffer.appendFormat(", coefficient: %0.3f, cpuCoefficient: %0.3f, rms: %0.6f, expected: ", pResult->coefficient, pResult->cpuCoefficient, pResult->rms);
+			else
+				buffer.appendFormat(",\"coefficient\":%0.3f,\"cpuCoefficient\":%0.3f,\"rms\":%0.6f,\"expected\":", pResult->coefficient, pResult->cpuCoefficient, pResult->rms);
+
+			if (expected)
+				buffer.appendFormat("\"%s\"}", expected);
+			else
+				buffer.append("null}");
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends a scaling benchmark result as a JS array with one object per
+	//thread count, throughputs are in iterations per second and times in ns
+	easyTest::output::FormattedBuffer& formatScaling(easyTest::output::FormattedBuffer& buffer, const easyTest::ScalingResult* pResult, bool bVerbose)
+	{
+		if (pResult)
+		{
+			buffer.append('[');
+			for (size_t i = 0; i < pResult->nbMeasures; ++i)
+			{
+				const easyTest::ScalingMeasure& measure = pResult->measures[i];
+				if (i)
+					buffer.append(bVerbose ? ", " : ",");
+
+				if (bVerbose)
+					buffer.appendFormat("{nbThreads: %u, nbIterations: %zu, minThreadIterations: %zu, maxThreadIterations: %zu, realTime: %0.3f, cpu: %0.3f, throughput: %0.3f, threadThroughput: %0.3f, efficiency: %0.6f, fairness: %0.6f}", measure.nbThreads, measure.nbIterations, measure.minThreadIterations, measure.maxThreadIterations, measure.realTime, measure.cpuTime, measure.throughput, measure.threadThroughput, measure.efficiency, measure.fairness);
+				else
+					buffer.appendFormat("{\"nbThreads\":%u,\"nbIterations\":%zu,\"minThreadIterations\":%zu,\"maxThreadIterations\":%zu,\"realTime\":%0.3f,\"cpu\":%0.3f,\"throughput\":%0.3f,\"threadThroughput\":%0.3f,\"efficiency\":%0.6f,\"fairness\":%0.6f}", measure.nbThreads, measure.nbIterations, measure.minThreadIterations, measure.maxThreadIterations, measure.realTime, measure.cpuTime, measure.throughput, measure.threadThroughput, measure.efficiency, measure.fairness);
+			}
+
+			buffer.append(']');
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends an A/B benchmark result as a JS object, times are in ns per
+	//iteration. faster is the name of the faster body, null if there is no
+	//significant difference.
+	easyTest::output::FormattedBuffer& formatAB(easyTest::output::FormattedBuffer& buffer, const easyTest::ABResult* pResult, bool bVerbose)
+	{
+		if (pResult)
+		{
+			const easyTest::ABMeasure* measures[] = {&pResult->a, &pResult->b};
+			buffer.append(bVerbose ? "{a: " : "{\"a\":");
+			for (int i = 0; i < 2; ++i)
+			{
+				const easyTest::ABMeasure& measure = *measures[i];
+				if (i)
+					buffer.append(bVerbose ? ", b: " : ",\"b\":");
+
+				if (bVerbose)
+					buffer.appendFormat("{name: \"%s\", nbIterations: %zu, median: %0.3f, mean: %0.3f, cpu: %0.3f}", measure.name, measure.nbIterations, measure.medianTime, measure.meanTime, measure.cpuTime);
+				else
+					buffer.appendFormat("{\"name\":\"%s\",\"nbIterations\":%zu,\"median\":%0.3f,\"mean\":%0.3f,\"cpu\":%0.3f}", measure.name, measure.nbIterations, measure.medianTime, measure.meanTime, measure.cpuTime);
+			}
+
+			if (bVerbose)
+				buffer.appendFormat(", nbRounds: %zu, ratio: %0.6f, lowRatio: %0.6f, highRatio: %0.6f, faster: ", pResult->nbRounds, pResult->ratio, pResult->lowRatio, pResult->highRatio);
+			else
+				buffer.appendFormat(",\"nbRounds\":%zu,\"ratio\":%0.6f,\"lowRatio\":%0.6f,\"highRatio\":%0.6f,\"faster\":", pResult->nbRounds, pResult->ratio, pResult->lowRatio, pResult->highRatio);
+
+			if (pResult->verdict == easyTest::ABVerdict::SAME)
+				buffer.append("null}");
+			else
+				buffer.appendFormat("\"%s\"}", (pResult->verdict == easyTest::ABVerdict::A_FASTER) ? pResult->a.name : pResult->b.name);
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the recorded latencies as a JS object, times are in ns. The
+	//serialized histogram is null if it cannot be allocated.
+	easyTest::output::FormattedBuffer& formatLatencyHistogram(easyTest::output::FormattedBuffer& buffer, const easyTest::LatencyHistogram* pLatencies, bool bVerbose)
+	{
+		if (pLatencies)
+		{
+			const long long p50 = pLatencies->getValueAtPercentile(50.0);
+			const long long p90 = pLatencies->getValueAtPercentile(90.0);
+			const long long p99 = pLatencies->getValueAtPercentile(99.0);
+			const long long p999 = pLatencies->getValueAtPercentile(99.9);
+
+			if (bVerbose)
+				buffer.appendFormat("{count: %zu, min: %lld, mean: %0.3f, p50: %lld, p90: %lld, p99: %lld, p999: %lld, max: %lld, histogram: ", pLatencies->getTotalCount(), pLatencies->getMin(), pLatencies->getMean(), p50, p90, p99, p999, pLatencies->getMax());
+			else
+				buffer.appendFormat("{\"count\":%zu,\"min\":%lld,\"mean\":%0.3f,\"p50\":%lld,\"p90\":%lld,\"p99\":%lld,\"p999\":%lld,\"max\":%lld,\"histogram\":", pLatencies->getTotalCount(), pLatencies->getMin(), pLatencies->getMean(), p50, p90, p99, p999, pLatencies->getMax());
+
+			//The serialized histogram only holds digits and separators
+			const size_t length = pLatencies->serialize(nullptr, 0);
+			char* serialized = new(std::nothrow) char[length + 1];
+			if (serialized)
+			{
+				pLatencies->serialize(serialized, length + 1);
+				buffer.append('"').append(serialized).append("\"}");
+				delete[] serialized;
+			}
+			else
+				buffer.append("null}");
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the performance counters as a JS object, unavailable counters
+	//are null
+	easyTest::output::FormattedBuffer& formatCounters(easyTest::output::FormattedBuffer& buffer, const easyTest::stats::PerfCounters* pCounters, bool bVerbose)
+	{
+		if (pCounters)
+		{
+			using easyTest::stats::PerfCounter;
+
+			static const char* const s_verboseNames[] = {"{cycles: ", ", instructions: ", ", cacheMisses: ", ", branchMisses: ", ", pageFaults: "};
+			static const char* const s_jsonNames[] = {"{\"cycles\":", ",\"instructions\":", ",\"cacheMisses\":", ",\"branchMisses\":", ",\"pageFaults\":"};
+			const char* const* names = bVerbose ? s_verboseNames : s_jsonNames;
+
+			for (int i = 0; i < static_cast<int>(PerfCounter::COUNT); ++i)
+			{
+				const long long value = pCounters->getValue(static_cast<PerfCounter>(i));
+				buffer.append(names[i]);
+				if (value < 0)
+					buffer.append("null");
+				else
+					buffer.appendFormat("%lld", value);
+			}
+
+			const double ipc = pCounters->getIPC();
+			buffer.append(bVerbose ? ", ipc: " : ",\"ipc\":");
+			if (ipc < 0.0)
+				buffer.append("null}");
+			else
+				buffer.appendFormat("%0.3f}", ipc);
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the heap allocation statistics as a JS object
+	easyTest::output::FormattedBuffer& formatAllocs(easyTest::output::FormattedBuffer& buffer, const easyTest::stats::AllocTracker* pAllocs, bool bVerbose)
+	{
+		if (pAllocs)
+		{
+			if (bVerbose)
+				buffer.appendFormat("{nbAllocs: %zu, nbBytes: %zu, peakLiveBytes: %lld}", pAllocs->getNbAllocs(), pAllocs->getNbBytes(), pAllocs->getPeakLiveBytes());
+			else
+				buffer.appendFormat("{\"nbAllocs\":%zu,\"nbBytes\":%zu,\"peakLiveBytes\":%lld}", pAllocs->getNbAllocs(), pAllocs->getNbBytes(), pAllocs->getPeakLiveBytes());
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the timings of the TIMED_SCOPE sites of a test case as a JS
+	//array with one object per site, times are totals in ns
+	easyTest::output::FormattedBuffer& formatScopes(easyTest::output::FormattedBuffer& buffer, const easyTest::ScopeTimings* pScopes, bool bVerbose)
+	{
+		if (pScopes)
+		{
+			buffer.append('[');
+			for (size_t i = 0; i < pScopes->getNbScopes(); ++i)
+			{
+				const easyTest::ScopeTiming& timing = pScopes->getScope(i);
+				if (i)
+					buffer.append(bVerbose ? ", " : ",");
+
+				buffer.append(bVerbose ? "{name: \"" : "{\"name\":\"").appendJSString(timing.pSite->getName());
+				if (bVerbose)
+					buffer.appendFormat("\", nbRuns: %zu, realTime: %lld, threadTime: %lld}", timing.nbCalls, timing.realTime, timing.threadTime);
+				else
+					buffer.appendFormat("\",\"nbRuns\":%zu,\"realTime\":%lld,\"threadTime\":%lld}", timing.nbCalls, timing.realTime, timing.threadTime);
+			}
+
+			buffer.append(']');
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the metrics published by a test case as a JS array with one
+	//object per metric
+	easyTest::output::FormattedBuffer& formatMetrics(easyTest::output::FormattedBuffer& buffer, const easyTest::CaseMetrics* pMetrics, bool bVerbose)
+	{
+		if (pMetrics)
+		{
+			buffer.append('[');
+			for (size_t i = 0; i < pMetrics->getNbMetrics(); ++i)
+			{
+				const easyTest::CaseMetric& metric = pMetrics->getMetric(i);
+				if (i)
+					buffer.append(bVerbose ? ", " : ",");
+
+				buffer.append(bVerbose ? "{name: \"" : "{\"name\":\"").appendJSString(metric.name)
+						.appendFormat(bVerbose ? "\", value: %.10g}" : "\",\"value\":%.10g}", metric.value);
+			}
+
+			buffer.append(']');
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the operating system resources used by a test case as a JS
+	//object, unavailable values are null
+	easyTest::output::FormattedBuffer& formatUsage(easyTest::output::FormattedBuffer& buffer, const easyTest::stats::ResourceUsage* pUsage, bool bVerbose)
+	{
+		if (pUsage)
+		{
+			using easyTest::stats::ResourceCounter;
+
+			static const char* const s_verboseNames[] = {"{userTime: ", ", systemTime: ", ", minorFaults: ", ", majorFaults: ", ", voluntarySwitches: ", ", involuntarySwitches: "};
+			static const char* const s_jsonNames[] = {"{\"userTime\":", ",\"systemTime\":", ",\"minorFaults\":", ",\"majorFaults\":", ",\"voluntarySwitches\":", ",\"involuntarySwitches\":"};
+			const char* const* names = bVerbose ? s_verboseNames : s_jsonNames;
+
+			for (int i = 0; i < static_cast<int>(ResourceCounter::COUNT); ++i)
+			{
+				const long long value = pUsage->getValue(static_cast<ResourceCounter>(i));
+				buffer.append(names[i]);
+				if (value < 0)
+					buffer.append("null");
+				else
+					buffer.appendFormat("%lld", value);
+			}
+
+			buffer.append('}');
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the I/O of a test case as a JS object, unavailable values are
+	//null
+	easyTest::output::FormattedBuffer& formatIo(easyTest::output::FormattedBuffer& buffer, const easyTest::stats::IoUsage* pIo, bool bLimitExceeded, bool bVerbose)
+	{
+		if (pIo)
+		{
+			using easyTest::stats::IoCounter;
+
+			static const char* const s_verboseNames[] = {"{readChars: ", ", writtenChars: ", ", readSyscalls: ", ", writeSyscalls: ", ", readBytes: ", ", writtenBytes: "};
+			static const char* const s_jsonNames[] = {"{\"readChars\":", ",\"writtenChars\":", ",\"readSyscalls\":", ",\"writeSyscalls\":", ",\"readBytes\":", ",\"writtenBytes\":"};
+			const char* const* names = bVerbose ? s_verboseNames : s_jsonNames;
+
+			for (int i = 0; i < static_cast<int>(IoCounter::COUNT); ++i)
+			{
+				const long long value = pIo->getValue(static_cast<IoCounter>(i));
+				buffer.append(names[i]);
+				if (value < 0)
+					buffer.append("null");
+				else
+					buffer.appendFormat("%lld", value);
+			}
+
+			buffer.append(bVerbose ? ", bLimitExceeded: " : ",\"bLimitExceeded\":").append(bLimitExceeded ? "true}" : "false}");
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends a string value, or null if the string is empty
+	easyTest::output::FormattedBuffer& appendOptionalString(easyTest::output::FormattedBuffer& buffer, const char* str)
+	{
+		if (str[0])
+			return buffer.append('"').appendJSString(str).append('"');
+		else
+			return buffer.append("null");
+	}
+
+	//Appends the benchmark environment as a JS object with the names of its
+	//raised warnings, unavailable values are null
+	easyTest::output::FormattedBuffer& formatEnvironment(easyTest::output::FormattedBuffer& buffer, const easyTest::stats::BenchEnvironment* pEnv, bool bVerbose)
+	{
+		if (pEnv)
+		{
+			using easyTest::stats::EnvironmentWarning;
+
+			static const char* const s_verboseNames[] = {"{cpuModel: ", ", nbCpus: ", ", kernel: ", ", governor: ", ", turbo: ", ", loadAverage: ", ", noise: ", ", priorityRaised: ", ", warnings: ["};
+			static const char* const s_jsonNames[] = {"{\"cpuModel\":", ",\"nbCpus\":", ",\"kernel\":", ",\"governor\":", ",\"turbo\":", ",\"loadAverage\":", ",\"noise\":", ",\"priorityRaised\":", ",\"warnings\":["};
+			const char* const* names = bVerbose ? s_verboseNames : s_jsonNames;
+
+			//Same order as the EnvironmentWarning enum
+			static const char* const s_warningNames[] = {"\"governor\"", "\"turbo\"", "\"load\"", "\"noise\""};
+
+			appendOptionalString(buffer.append(names[0]), pEnv->cpuModel).append(names[1]).appendFormat("%u", pEnv->nbCpus);
+			appendOptionalString(buffer.append(names[2]), pEnv->kernel);
+			appendOptionalString(buffer.append(names[3]), pEnv->governor).append(names[4]).append((pEnv->turbo < 0) ? "null" : (pEnv->turbo ? "true" : "false"));
+
+			buffer.append(names[5]);
+			if (pEnv->loadAverage < 0.0)
+				buffer.append("null");
+			else
+				buffer.appendFormat("%0.2f", pEnv->loadAverage);
+
+			buffer.append(names[6]);
+			if (pEnv->noise < 0.0)
+				buffer.append("null");
+			else
+				buffer.appendFormat("%0.4f", pEnv->noise);
+
+			buffer.append(names[7]).append(pEnv->bPriorityRaised ? "true" : "false").append(names[8]);
+
+			bool bFirst = true;
+			for (int i = 0; i < static_cast<int>(EnvironmentWarning::COUNT); ++i)
+			{
+				if (easyTest::stats::hasEnvironmentWarning(*pEnv, static_cast<EnvironmentWarning>(i)))
+				{
+					if (!bFirst)
+						buffer.append(bVerbose ? ", " : ",");
+
+					buffer.append(s_warningNames[i]);
+					bFirst = false;
+				}
+			}
+
+			buffer.append("]}");
+		}
+		else
+			buffer.append("null");
+
+		return buffer;
+	}
+
+	//Appends the detailed differing regions of a data diff report as a JS
+	//array
+	void formatDiffRegions(easyTest::output::FormattedBuffer& buffer, const easyTest::compare::DataDiffReport& report, bool bVerbose)
+	{
+		char hexA[easyTest::compare::HEX_EXCERPT_BUFFER_SIZE];
+		char hexB[easyTest::compare::HEX_EXCERPT_BUFFER_SIZE];
+
+		buffer.append('[');
+		for (size_t i = 0; i < report.nbReportedRegions; ++i)
+		{
+			const easyTest::compare::DataDiffRegion& region = report.regions[i];
+			easyTest::compare::formatHexBytes(hexA, sizeof(hexA), region.excerptA, region.excerptSize);
+			easyTest::compare::formatHexBytes(hexB, sizeof(hexB), region.excerptB, region.excerptSize);
+
+			if (bVerbose)
+				buffer.appendFormat("%s\n\t\t{offset: %zu, size: %zu, dataA: \"%s\", dataB: \"%s\"}", i ? "," : "", region.offset, region.size, hexA, hexB);
+			else
+				buffer.appendFormat("%s{\"offset\":%zu,\"size\":%zu,\"dataA\":\"%s\",\"dataB\":\"%s\"}", i ? "," : "", region.offset, region.size, hexA, hexB);
+		}
+
+		if (bVerbose)
+			buffer.append("\n\t]");
+		else
+			buffer.append(']');
+	}
+
+	const char* getBaselineVerdictName(easyTest::BaselineVerdict verdict)
+	{
+		switch (verdict)
+		{
+		case easyTest::BaselineVerdict::UNCHANGED:
+			return "unchanged";
+
+		case easyTest::BaselineVerdict::REGRESSION:
+			return "regression";
+
+		case easyTest::BaselineVerdict::IMPROVEMENT:
+			return "improvement";
+
+		case easyTest::BaselineVerdict::NOT_ENOUGH_SAMPLES:
+			return "notEnoughSamples";
+
+		default:
+			return "newTest";
+		}
+	}
+
+	const char* getGoldenStatusName(easyTest::compare::GoldenStatus status)
+	{
+		switch (status)
+		{
+		case easyTest::compare::GoldenStatus::MATCH:
+			return "match";
+
+		case easyTest::compare::GoldenStatus::UPDATED:
+			return "updated";
+
+		case easyTest::compare::GoldenStatus::SIZE_MISMATCH:
+			return "sizeMismatch";
+
+		case easyTest::compare::GoldenStatus::DATA_MISMATCH:
+			return "dataMismatch";
+
+		case easyTest::compare::GoldenStatus::CANNOT_UPDATE:
+			return "cannotUpdate";
+
+		default:
+			return "cannotRead";
+		}
+	}
 }
 
 namespace easyTest
@@ -53,12 +518,20 @@ namespace easyTest
 						if (m_bVerbose)
 						{
 							pBuffer->append("var g_testResult = [\n{\n\ttype: \"runner_start\",\n")
-									.appendFormat("\tnbMaxWorkerThreads: %u,\n\tnbTotalSuites: %zu,\n\tnbTotalTestCases: %zu\n},\n", event.testRunnerStart.nbMaxWorkerThreads, event.testRunnerStart.nbTotalSuites, event.testRunnerStart.nbTotalTestCases);
+									.appendFormat("\tnbMaxWorkerThreads: %u,\n\tnbTotalSuites: %zu,\n\tnbTotalTestCases: %zu,\n\toverheadSubtracted: %s,\n\tenvironment: ", event.testRunnerStart.nbMaxWorkerThreads, event.testRunnerStart.nbTotalSuites, event.testRunnerStart.nbTotalTestCases, event.testRunnerStart.bOverheadSubtracted ? "true" : "false");
+							formatEnvironment(*pBuffer, event.testRunnerStart.pEnvironment, true)
+									.append(",\n\tcaseOverhead:");
+							formatCodeTimer(*pBuffer, m_bStats ? event.testRunnerStart.pCaseOverhead : nullptr, true)
+									.append("},\n");
 						}
 						else
 						{
 							pBuffer->append("{\"type\":\"runner_start\",")
-									.appendFormat("\"nbMaxWorkerThreads\":%u,\"nbTotalSuites\":%zu,\"nbTotalTestCases\":%zu}\n", event.testRunnerStart.nbMaxWorkerThreads, event.testRunnerStart.nbTotalSuites, event.testRunnerStart.nbTotalTestCases);
+									.appendFormat("\"nbMaxWorkerThreads\":%u,\"nbTotalSuites\":%zu,\"nbTotalTestCases\":%zu,\"overheadSubtracted\":%s,\"environment\":", event.testRunnerStart.nbMaxWorkerThreads, event.testRunnerStart.nbTotalSuites, event.testRunnerStart.nbTotalTestCases, event.testRunnerStart.bOverheadSubtracted ? "true" : "false");
+							formatEnvironment(*pBuffer, event.testRunnerStart.pEnvironment, false)
+									.append(",\"caseOverhead\":");
+							formatCodeTimer(*pBuffer, m_bStats ? event.testRunnerStart.pCaseOverhead : nullptr, false)
+									.append("}\n");
 						}
 
 						pBuffer->flushAndClear(m_pOut);
@@ -74,14 +547,14 @@ namespace easyTest
 						if (m_bVerbose)
 						{
 							pBuffer->append("{\n\ttype: \"runner_finish\",\n")
-									.appendFormat("\tnbUsedWorkerThreads: %u,\n\tnbTotalSuites: %zu,\n\tnbSuccessSuites: %zu,\n\tnbFailedSuites: %zu,\n\ttimer:", event.testRunnerFinish.nbUsedWorkerThreads, event.testRunnerFinish.nbTotalSuites, event.testRunnerFinish.nbSuccessSuites, event.testRunnerFinish.nbFailedSuites);
+									.appendFormat("\tnbUsedWorkerThreads: %u,\n\tnbTotalSuites: %zu,\n\tnbSuccessSuites: %zu,\n\tnbFailedSuites: %zu,\n\tnbAsserts: %zu,\n\ttimer:", event.testRunnerFinish.nbUsedWorkerThreads, event.testRunnerFinish.nbTotalSuites, event.testRunnerFinish.nbSuccessSuites, event.testRunnerFinish.nbFailedSuites, event.testRunnerFinish.nbAsserts);
 							formatCodeTimer(*pBuffer, m_bStats ? event.testRunnerFinish.pTimer : nullptr, true)
 									.append("}];\n");
 						}
 						else
 						{
 							pBuffer->append("{\"type\":\"runner_finish\",")
-									.appendFormat("\"nbUsedWorkerThreads\":%u,\"nbTotalSuites\":%zu,\"nbSuccessSuites\":%zu,\"nbFailedSuites\":%zu,\"timer\":", event.testRunnerFinish.nbUsedWorkerThreads, event.testRunnerFinish.nbTotalSuites, event.testRunnerFinish.nbSuccessSuites, event.testRunnerFinish.nbFailedSuites);
+									.appendFormat("\"nbUsedWorkerThreads\":%u,\"nbTotalSuites\":%zu,\"nbSuccessSuites\":%zu,\"nbFailedSuites\":%zu,\"nbAsserts\":%zu,\"timer\":", event.testRunnerFinish.nbUsedWorkerThreads, event.testRunnerFinish.nbTotalSuites, event.testRunnerFinish.nbSuccessSuites, event.testRunnerFinish.nbFailedSuites, event.testRunnerFinish.nbAsserts);
 							formatCodeTimer(*pBuffer, m_bStats ? event.testRunnerFinish.pTimer : nullptr, false)
 									.append("}\n");
 						}
@@ -142,14 +615,14 @@ namespace easyTest
 						if (m_bVerbose)
 						{
 							pBuffer->append("{\n\ttype: \"suite_finish\",\n")
-									.appendFormat("\tworkerThreadIdx: %u,\n\ttestSuiteName: \"%s\",\n\tnbTotalCases: %zu,\n\tnbSuccessCases: %zu,\n\tnbFailedCases: %zu,\n\ttimer:", event.testSuiteFinish.workerThreadIdx, event.testSuiteFinish.testSuiteName, event.testSuiteFinish.nbTotalCases, event.testSuiteFinish.nbSuccessCases, event.testSuiteFinish.nbFailedCases);
+									.appendFormat("\tworkerThreadIdx: %u,\n\ttestSuiteName: \"%s\",\n\tnbTotalCases: %zu,\n\tnbSuccessCases: %zu,\n\tnbFailedCases: %zu,\n\tnbAsserts: %zu,\n\ttimer:", event.testSuiteFinish.workerThreadIdx, event.testSuiteFinish.testSuiteName, event.testSuiteFinish.nbTotalCases, event.testSuiteFinish.nbSuccessCases, event.testSuiteFinish.nbFailedCases, event.testSuiteFinish.nbAsserts);
 							formatCodeTimer(*pBuffer, m_bStats ? event.testSuiteFinish.pTimer : nullptr, true)
 									.append("},\n");
 						}
 						else
 						{
 							pBuffer->append("{\"type\":\"suite_finish\",")
-									.appendFormat("\"workerThreadIdx\":%u,\"testSuiteName\":\"%s\",\"nbTotalCases\":%zu,\"nbSuccessCases\":%zu,\"nbFailedCases\":%zu,\"timer\":", event.testSuiteFinish.workerThreadIdx, event.testSuiteFinish.testSuiteName, event.testSuiteFinish.nbTotalCases, event.testSuiteFinish.nbSuccessCases, event.testSuiteFinish.nbFailedCases);
+									.appendFormat("\"workerThreadIdx\":%u,\"testSuiteName\":\"%s\",\"nbTotalCases\":%zu,\"nbSuccessCases\":%zu,\"nbFailedCases\":%zu,\"nbAsserts\":%zu,\"timer\":", event.testSuiteFinish.workerThreadIdx, event.testSuiteFinish.testSuiteName, event.testSuiteFinish.nbTotalCases, event.testSuiteFinish.nbSuccessCases, event.testSuiteFinish.nbFailedCases, event.testSuiteFinish.nbAsserts);
 							formatCodeTimer(*pBuffer, m_bStats ? event.testSuiteFinish.pTimer : nullptr, false)
 									.append("}\n");
 						}
@@ -184,17 +657,66 @@ namespace easyTest
 					FormattedBuffer* pBuffer = getWorkerThreadBuffer(event.testCaseFinish.workerThreadIdx);
 					if (pBuffer)
 					{
+						const ComplexityResult* pComplexity = event.testCaseFinish.pComplexity;
 						if (m_bVerbose)
 						{
 							pBuffer->append("{\n\ttype: \"case_finish\",\n")
-									.appendFormat("\tworkerThreadIdx: %u,\n\ttestSuiteName: \"%s\",\n\ttestCaseName: \"%s\",\n\tbSuccess: %s,\n\ttimer:", event.testCaseFinish.workerThreadIdx, event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, event.testCaseFinish.bSuccess ? "true" : "false");
+									.appendFormat("\tworkerThreadIdx: %u,\n\ttestSuiteName: \"%s\",\n\ttestCaseName: \"%s\",\n\tbSuccess: %s,\n\tnbAsserts: %zu,\n\tbenchmark: ", event.testCaseFinish.workerThreadIdx, event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, event.testCaseFinish.bSuccess ? "true" : "false", event.testCaseFinish.nbAsserts);
+							formatBenchmark(*pBuffer, event.testCaseFinish.pBenchmark, true)
+									.append(",\n\tcoldBenchmark: ");
+							formatBenchmark(*pBuffer, event.testCaseFinish.pColdBenchmark, true)
+									.append(",\n\tcomplexity: ");
+							formatComplexity(*pBuffer, pComplexity, pComplexity ? getComplexityName(pComplexity->bestFit) : nullptr, pComplexity ? getComplexityName(pComplexity->expected) : nullptr, true)
+									.append(",\n\tscaling: ");
+							formatScaling(*pBuffer, event.testCaseFinish.pScaling, true)
+									.append(",\n\tab: ");
+							formatAB(*pBuffer, event.testCaseFinish.pAB, true)
+									.append(",\n\tlatencies: ");
+							formatLatencyHistogram(*pBuffer, event.testCaseFinish.pLatencies, true)
+									.append(",\n\tcounters: ");
+							formatCounters(*pBuffer, event.testCaseFinish.pCounters, true)
+									.append(",\n\tallocs: ");
+							formatAllocs(*pBuffer, event.testCaseFinish.pAllocs, true)
+									.append(",\n\tscopes: ");
+							formatScopes(*pBuffer, event.testCaseFinish.pScopes, true)
+									.append(",\n\tmetrics: ");
+							formatMetrics(*pBuffer, event.testCaseFinish.pMetrics, true)
+									.append(",\n\tusage: ");
+							formatUsage(*pBuffer, m_bStats ? event.testCaseFinish.pUsage : nullptr, true)
+									.append(",\n\tio: ");
+							formatIo(*pBuffer, (m_bStats || event.testCaseFinish.bIoLimitExceeded) ? event.testCaseFinish.pIo : nullptr, event.testCaseFinish.bIoLimitExceeded, true)
+									.append(",\n\ttimer:");
 							formatCodeTimer(*pBuffer, m_bStats ? event.testCaseFinish.pTimer : nullptr, true)
 									.append("},\n");
 						}
 						else
 						{
 							pBuffer->append("{\"type\":\"case_finish\",")
-									.appendFormat("\"workerThreadIdx\":%u,\"testSuiteName\":\"%s\",\"testCaseName\":\"%s\",\"bSuccess\":%s,\"timer\":", event.testCaseFinish.workerThreadIdx, event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, event.testCaseFinish.bSuccess ? "true" : "false");
+									.appendFormat("\"workerThreadIdx\":%u,\"testSuiteName\":\"%s\",\"testCaseName\":\"%s\",\"bSuccess\":%s,\"nbAsserts\":%zu,\"benchmark\":", event.testCaseFinish.workerThreadIdx, event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, event.testCaseFinish.bSuccess ? "true" : "false", event.testCaseFinish.nbAsserts);
+							formatBenchmark(*pBuffer, event.testCaseFinish.pBenchmark, false)
+									.append(",\"coldBenchmark\":");
+							formatBenchmark(*pBuffer, event.testCaseFinish.pColdBenchmark, false)
+									.append(",\"complexity\":");
+							formatComplexity(*pBuffer, pComplexity, pComplexity ? getComplexityName(pComplexity->bestFit) : nullptr, pComplexity ? getComplexityName(pComplexity->expected) : nullptr, false)
+									.append(",\"scaling\":");
+							formatScaling(*pBuffer, event.testCaseFinish.pScaling, false)
+									.append(",\"ab\":");
+							formatAB(*pBuffer, event.testCaseFinish.pAB, false)
+									.append(",\"latencies\":");
+							formatLatencyHistogram(*pBuffer, event.testCaseFinish.pLatencies, false)
+									.append(",\"counters\":");
+							formatCounters(*pBuffer, event.testCaseFinish.pCounters, false)
+									.append(",\"allocs\":");
+							formatAllocs(*pBuffer, event.testCaseFinish.pAllocs, false)
+									.append(",\"scopes\":");
+							formatScopes(*pBuffer, event.testCaseFinish.pScopes, false)
+									.append(",\"metrics\":");
+							formatMetrics(*pBuffer, event.testCaseFinish.pMetrics, false)
+									.append(",\"usage\":");
+							formatUsage(*pBuffer, m_bStats ? event.testCaseFinish.pUsage : nullptr, false)
+									.append(",\"io\":");
+							formatIo(*pBuffer, (m_bStats || event.testCaseFinish.bIoLimitExceeded) ? event.testCaseFinish.pIo : nullptr, event.testCaseFinish.bIoLimitExceeded, false)
+									.append(",\"timer\":");
 							formatCodeTimer(*pBuffer, m_bStats ? event.testCaseFinish.pTimer : nullptr, false)
 									.append("}\n")
 									.flushAndClear(m_pOut);
@@ -278,6 +800,184 @@ namespace easyTest
 			}
 		}
 
+		void JSWriter::onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB)
+		{
+			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+			if (pBuffer)
+			{
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"assert\",\n")
+							.appendFormat("\tworkerThreadIdx: %u,\n\tfile: \"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\n\tfunction: \"%s\",\n\tline: %u,\n\tdetails: \"%s %s %s\",\n\tmismatchIdx: %zu,\n\tcontextA: \"", info.getFunction(), info.getLine(), varAName, getBinaryAssertFailText(type), varBName, mismatchIdx)
+							.appendJSString(contextA)
+							.append("\",\n\tcontextB: \"")
+							.appendJSString(contextB)
+							.append("\"\n},\n");
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"assert\",")
+							.appendFormat("\"workerThreadIdx\":%u,\"file\":\"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\"function\":\"%s\",\"line\":%u,\"details\":\"%s %s %s\",\"mismatchIdx\":%zu,\"contextA\":\"", info.getFunction(), info.getLine(), varAName, getBinaryAssertFailText(type), varBName, mismatchIdx)
+							.appendJSString(contextA)
+							.append("\",\"contextB\":\"")
+							.appendJSString(contextB)
+							.append("\"}\n")
+							.flushAndClear(m_pOut);
+				}
+			}
+		}
+
+		void JSWriter::onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report)
+		{
+			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+			if (pBuffer)
+			{
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"assert\",\n")
+							.appendFormat("\tworkerThreadIdx: %u,\n\tfile: \"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\n\tfunction: \"%s\",\n\tline: %u,\n\tdetails: \"%s %s %s\",\n\tsizeInBytes: %zu,\n\tnbMismatchBytes: %zu,\n\tnbDiffRegions: %zu,\n\tdiffRegions: ", info.getFunction(), info.getLine(), varAName, getBinaryAssertFailText(type), varBName, report.sizeInBytes, report.nbMismatchBytes, report.nbRegions);
+
+					formatDiffRegions(*pBuffer, report, true);
+					pBuffer->append("\n},\n");
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"assert\",")
+							.appendFormat("\"workerThreadIdx\":%u,\"file\":\"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\"function\":\"%s\",\"line\":%u,\"details\":\"%s %s %s\",\"sizeInBytes\":%zu,\"nbMismatchBytes\":%zu,\"nbDiffRegions\":%zu,\"diffRegions\":", info.getFunction(), info.getLine(), varAName, getBinaryAssertFailText(type), varBName, report.sizeInBytes, report.nbMismatchBytes, report.nbRegions);
+
+					formatDiffRegions(*pBuffer, report, false);
+					pBuffer->append("}\n").flushAndClear(m_pOut);
+				}
+			}
+		}
+
+		void JSWriter::onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport)
+		{
+			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+			if (pBuffer)
+			{
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"assert\",\n")
+							.appendFormat("\tworkerThreadIdx: %u,\n\tfile: \"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\n\tfunction: \"%s\",\n\tline: %u,\n\tdetails: \"%s %s\",\n\tgoldenPath: \"", info.getFunction(), info.getLine(), varName, getUnaryAssertFailText(AssertType::MATCH_GOLDEN_FILE))
+							.appendJSString(goldenPath)
+							.appendFormat("\",\n\tgoldenStatus: \"%s\",\n\tdataSize: %zu,\n\tgoldenSize: %zu", getGoldenStatusName(status), dataSize, goldenSize);
+
+					if (pReport)
+					{
+						pBuffer->appendFormat(",\n\tnbMismatchBytes: %zu,\n\tnbDiffRegions: %zu,\n\tdiffRegions: ", pReport->nbMismatchBytes, pReport->nbRegions);
+						formatDiffRegions(*pBuffer, *pReport, true);
+					}
+
+					pBuffer->append("\n},\n");
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"assert\",")
+							.appendFormat("\"workerThreadIdx\":%u,\"file\":\"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\"function\":\"%s\",\"line\":%u,\"details\":\"%s %s\",\"goldenPath\":\"", info.getFunction(), info.getLine(), varName, getUnaryAssertFailText(AssertType::MATCH_GOLDEN_FILE))
+							.appendJSString(goldenPath)
+							.appendFormat("\",\"goldenStatus\":\"%s\",\"dataSize\":%zu,\"goldenSize\":%zu", getGoldenStatusName(status), dataSize, goldenSize);
+
+					if (pReport)
+					{
+						pBuffer->appendFormat(",\"nbMismatchBytes\":%zu,\"nbDiffRegions\":%zu,\"diffRegions\":", pReport->nbMismatchBytes, pReport->nbRegions);
+						formatDiffRegions(*pBuffer, *pReport, false);
+					}
+
+					pBuffer->append("}\n").flushAndClear(m_pOut);
+				}
+			}
+		}
+
+		void JSWriter::onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest)
+		{
+			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+			if (pBuffer)
+			{
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"assert\",\n")
+							.appendFormat("\tworkerThreadIdx: %u,\n\tfile: \"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\n\tfunction: \"%s\",\n\tline: %u,\n\tdetails: \"%s %s\",\n\texpectedDigest: \"", info.getFunction(), info.getLine(), varName, getUnaryAssertFailText(type))
+							.appendJSString(expectedDigest)
+							.appendFormat("\",\n\tactualDigest: \"%s\"\n},\n", actualDigest);
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"assert\",")
+							.appendFormat("\"workerThreadIdx\":%u,\"file\":\"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\"function\":\"%s\",\"line\":%u,\"details\":\"%s %s\",\"expectedDigest\":\"", info.getFunction(), info.getLine(), varName, getUnaryAssertFailText(type))
+							.appendJSString(expectedDigest)
+							.appendFormat("\",\"actualDigest\":\"%s\"}\n", actualDigest)
+							.flushAndClear(m_pOut);
+				}
+			}
+		}
+
+		void JSWriter::onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers)
+		{
+			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+			if (pBuffer)
+			{
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"assert\",\n")
+							.appendFormat("\tworkerThreadIdx: %u,\n\tfile: \"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\n\tfunction: \"%s\",\n\tline: %u,\n\tdetails: \"", info.getFunction(), info.getLine())
+							.appendJSString(bodyName)
+							.appendFormat(" %s\",\n\tmaxTime: %lld,\n\tmeasuredTime: %0.3f,\n\tnbRuns: %zu,\n\tnbOutliers: %zu\n},\n", getUnaryAssertFailText(type), maxTime, measuredTime, nbRuns, nbOutliers);
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"assert\",")
+							.appendFormat("\"workerThreadIdx\":%u,\"file\":\"", workerThreadIdx)
+							.appendJSString(info.getFile())
+							.appendFormat("\",\"function\":\"%s\",\"line\":%u,\"details\":\"", info.getFunction(), info.getLine())
+							.appendJSString(bodyName)
+							.appendFormat(" %s\",\"maxTime\":%lld,\"measuredTime\":%0.3f,\"nbRuns\":%zu,\"nbOutliers\":%zu}\n", getUnaryAssertFailText(type), maxTime, measuredTime, nbRuns, nbOutliers)
+							.flushAndClear(m_pOut);
+				}
+			}
+		}
+
+		void JSWriter::onBaselineComparison(const BaselineComparison& comparison)
+		{
+			FormattedBuffer* pBuffer = getControlThreadBuffer();
+			if (pBuffer)
+			{
+				const char* verdict = getBaselineVerdictName(comparison.verdict);
+				if (m_bVerbose)
+				{
+					pBuffer->append("{\n\ttype: \"baseline\",\n\ttestName: \"")
+							.appendJSString(comparison.testName)
+							.appendFormat("\",\n\tverdict: \"%s\",\n\tnbBaselineSamples: %zu,\n\tnbSamples: %zu,\n\tbaselineMedian: %0.3f,\n\tmedian: %0.3f,\n\trelativeChange: %0.6f,\n\tpValue: %0.6f\n},\n", verdict, comparison.nbBaselineSamples, comparison.nbSamples, comparison.baselineMedian, comparison.median, comparison.relativeChange, comparison.pValue);
+				}
+				else
+				{
+					pBuffer->append("{\"type\":\"baseline\",\"testName\":\"")
+							.appendJSString(comparison.testName)
+							.appendFormat("\",\"verdict\":\"%s\",\"nbBaselineSamples\":%zu,\"nbSamples\":%zu,\"baselineMedian\":%0.3f,\"median\":%0.3f,\"relativeChange\":%0.6f,\"pValue\":%0.6f}\n", verdict, comparison.nbBaselineSamples, comparison.nbSamples, comparison.baselineMedian, comparison.median, comparison.relativeChange, comparison.pValue);
+				}
+
+				pBuffer->flushAndClear(m_pOut);
+			}
+		}
+
 		void JSWriter::onRuntimeError(unsigned int workerThreadIdx, RTErrorType type, const char* exceptionDetails)
 		{
 			FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
@@ -27,6 +27,13 @@ namespace easyTest
 
 			virtual void onUnaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName) override final;
 			virtual void onBinaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName) override final;
+			virtual void onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB) override final;
+			virtual void onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report) override final;
+			virtual void onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport) override final;
+			virtual void onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest) override final;
+			virtual void onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers) override final;
+
+			virtual void onBaselineComparison(const BaselineComparison& comparison) override final;
 
 			virtual void onRuntimeError(unsigned int workerThreadIdx, RTErrorType type, const char* exceptionDetails) override final;
 		};
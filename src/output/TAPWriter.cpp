@@ -11,6 +11,9 @@
 
 #include "../../include/TestSuite.h"
 #include "../stats/CodeTimer.h"
+#include "../stats/BenchEnvironment.h"
+#include "../compare/SimdCompare.h"
+#include "../compare/GoldenFile.h"
 #include "FormattedBuffer.h"
 #include "../i18n/i18n.h"
 
@@ -43,6 +46,27 @@ namespace
 
 		return buffer;
 	}
+
+	//Appends the differing regions of a data diff report, aName and bName
+	//label the excerpts of each compared buffer
+	void formatDataDiff(easyTest::output::FormattedBuffer& buffer, const easyTest::compare::DataDiffReport& report, const char* aName, const char* bName)
+	{
+		buffer.appendFormat(easyTest::i18n::getString(easyTest::i18n::TAP_DATA_DIFF_SUMMARY), report.nbMismatchBytes, report.nbRegions, report.sizeInBytes);
+
+		char hexA[easyTest::compare::HEX_EXCERPT_BUFFER_SIZE];
+		char hexB[easyTest::compare::HEX_EXCERPT_BUFFER_SIZE];
+		for (size_t i = 0; i < report.nbReportedRegions; ++i)
+		{
+			const easyTest::compare::DataDiffRegion& region = report.regions[i];
+			const char* ellipsis = (region.size > region.excerptSize) ? " ..." : "";
+			easyTest::compare::formatHexBytes(hexA, sizeof(hexA), region.excerptA, region.excerptSize);
+			easyTest::compare::formatHexBytes(hexB, sizeof(hexB), region.excerptB, region.excerptSize);
+			buffer.appendFormat(easyTest::i18n::getString(easyTest::i18n::TAP_DATA_DIFF_REGION), region.offset, region.size, aName, hexA, ellipsis, bName, hexB, ellipsis);
+		}
+
+		if (report.nbRegions > report.nbReportedRegions)
+			buffer.appendFormat(easyTest::i18n::getString(easyTest::i18n::TAP_DATA_DIFF_MORE), report.nbRegions - report.nbReportedRegions);
+	}
 }
 
 namespace easyTest
@@ -68,6 +92,32 @@ namespace easyTest
 #endif //!EASYTEST_NO_THREADS
 						}
 
+						if (m_bStats && event.testRunnerStart.pCaseOverhead)
+						{
+							formatCodeTimer(pBuffer->append(i18n::getString(i18n::TAP_CASE_OVERHEAD)), event.testRunnerStart.pCaseOverhead, false);
+							if (event.testRunnerStart.bOverheadSubtracted)
+								pBuffer->append(i18n::getString(i18n::OVERHEAD_SUBTRACTED));
+
+							pBuffer->append('\n');
+						}
+
+						if (event.testRunnerStart.pEnvironment)
+						{
+							const stats::BenchEnvironment& env = *event.testRunnerStart.pEnvironment;
+							formatBenchEnvironment(pBuffer->append(i18n::getString(i18n::TAP_ENVIRONMENT_HEADER)), env);
+							pBuffer->append('\n');
+
+							for (int i = 0; i < static_cast<int>(stats::EnvironmentWarning::COUNT); ++i)
+							{
+								const stats::EnvironmentWarning warning = static_cast<stats::EnvironmentWarning>(i);
+								if (stats::hasEnvironmentWarning(env, warning))
+								{
+									formatEnvironmentWarning(pBuffer->append(i18n::getString(i18n::TAP_WARNING_HEADER)), env, warning);
+									pBuffer->append('\n');
+								}
+							}
+						}
+
 						pBuffer->flushAndClear(m_pOut);
 					}
 				}
@@ -80,6 +130,7 @@ namespace easyTest
 					if (pBuffer)
 					{
 						formatCodeTimer(pBuffer->append(i18n::getString(i18n::TAP_TOTAL_EXEC_TIME)), event.testRunnerFinish.pTimer, false)
+								.appendFormat(i18n::getString(i18n::STATS_ASSERT_COUNT), event.testRunnerFinish.nbAsserts)
 								.append('\n')
 								.flushAndClear(m_pOut);
 					}
@@ -136,11 +187,111 @@ namespace easyTest
 						if (m_bStats)
 						{
 							pBuffer->insertFormat("%sok - [%s::%s] - ", event.testCaseFinish.bSuccess ? "" : "not ", event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName);
-							formatCodeTimer(*pBuffer, event.testCaseFinish.pTimer, true).insert('\n');
+							formatCodeTimer(*pBuffer, event.testCaseFinish.pTimer, true)
+									.insertFormat(i18n::getString(i18n::STATS_ASSERT_COUNT), event.testCaseFinish.nbAsserts)
+									.insert('\n');
 						}
 						else
 							pBuffer->insertFormat("%sok - [%s::%s]\n", event.testCaseFinish.bSuccess ? "" : "not ", event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName);
 
+						//Metrics are written as a YAML diagnostic block, which
+						//must directly follow the test line. Metric names only
+						//hold characters which need no quoting.
+						if (event.testCaseFinish.pMetrics)
+						{
+							const CaseMetrics& metrics = *event.testCaseFinish.pMetrics;
+							pBuffer->insert("  ---\n  metrics:\n");
+							for (size_t i = 0; i < metrics.getNbMetrics(); ++i)
+								pBuffer->insertFormat("    %s: %.10g\n", metrics.getMetric(i).name, metrics.getMetric(i).value);
+
+							pBuffer->insert("  ...\n");
+						}
+
+						if (m_bStats && event.testCaseFinish.pUsage)
+						{
+							formatResourceUsage(pBuffer->append(i18n::getString(i18n::TAP_RESOURCES_HEADER)), *event.testCaseFinish.pUsage);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pIo && (m_bStats || event.testCaseFinish.bIoLimitExceeded))
+						{
+							formatIoUsage(pBuffer->append(i18n::getString(event.testCaseFinish.bIoLimitExceeded ? i18n::TAP_IO_LIMIT_HEADER : i18n::TAP_IO_HEADER)), *event.testCaseFinish.pIo, event.testCaseFinish.bIoLimitExceeded);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pBenchmark)
+						{
+							formatBenchmarkResult(pBuffer->append(i18n::getString(i18n::TAP_BENCHMARK_HEADER)), *event.testCaseFinish.pBenchmark);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pColdBenchmark)
+						{
+							formatColdBenchmarkResult(pBuffer->append(i18n::getString(i18n::TAP_COLD_HEADER)), *event.testCaseFinish.pColdBenchmark, event.testCaseFinish.pBenchmark);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pComplexity)
+						{
+							const ComplexityResult& result = *event.testCaseFinish.pComplexity;
+							for (size_t i = 0; i < result.nbRanges; ++i)
+							{
+								formatRangeMeasure(pBuffer->appendFormat(i18n::getString(i18n::TAP_RANGE_HEADER), result.ranges[i].range), result.ranges[i]);
+								pBuffer->append('\n');
+							}
+
+							formatComplexityFit(pBuffer->append(i18n::getString(i18n::TAP_COMPLEXITY_HEADER)), result);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pScaling)
+						{
+							const ScalingResult& result = *event.testCaseFinish.pScaling;
+							for (size_t i = 0; i < result.nbMeasures; ++i)
+							{
+								formatScalingMeasure(pBuffer->appendFormat(i18n::getString(i18n::TAP_THREADS_HEADER), result.measures[i].nbThreads), result.measures[i]);
+								pBuffer->append('\n');
+							}
+						}
+
+						if (event.testCaseFinish.pAB)
+						{
+							const ABResult& result = *event.testCaseFinish.pAB;
+							formatABMeasure(pBuffer->appendFormat(i18n::getString(i18n::TAP_AB_MEASURE_HEADER), result.a.name), result.a, result.nbRounds);
+							formatABMeasure(pBuffer->append('\n').appendFormat(i18n::getString(i18n::TAP_AB_MEASURE_HEADER), result.b.name), result.b, result.nbRounds);
+							formatABVerdict(pBuffer->append('\n').append(i18n::getString(i18n::TAP_AB_HEADER)), result);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pLatencies)
+						{
+							formatLatencies(pBuffer->append(i18n::getString(i18n::TAP_LATENCIES_HEADER)), *event.testCaseFinish.pLatencies);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pCounters)
+						{
+							formatPerfCounters(pBuffer->append(i18n::getString(i18n::TAP_COUNTERS_HEADER)), *event.testCaseFinish.pCounters);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pAllocs)
+						{
+							formatAllocStats(pBuffer->append(i18n::getString(i18n::TAP_ALLOCS_HEADER)), *event.testCaseFinish.pAllocs);
+							pBuffer->append('\n');
+						}
+
+						if (event.testCaseFinish.pScopes)
+						{
+							const ScopeTimings& timings = *event.testCaseFinish.pScopes;
+							for (size_t i = 0; i < timings.getNbScopes(); ++i)
+							{
+								const ScopeTiming& timing = timings.getScope(i);
+								formatScopeTiming(pBuffer->appendFormat(i18n::getString(i18n::TAP_SCOPE_HEADER), timing.pSite->getName()), timing);
+								pBuffer->append('\n');
+							}
+						}
+
 						pBuffer->flushAndClear(m_pOut);
 					}
 				}
@@ -188,6 +339,111 @@ namespace easyTest
 			}
 		}
 
+		void TAPWriter::onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB)
+		{
+			if (m_bVerbose)
+			{
+				FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+				if (pBuffer)
+				{
+					pBuffer->appendFormat(i18n::getString(i18n::TAP_ASSERT_HEADER), info.getFile(), info.getFunction(), info.getLine())
+							.appendFormat("%s %s %s\n", varAName, getBinaryAssertFailText(type), varBName)
+							.appendFormat(i18n::getString(i18n::TAP_STRING_MISMATCH), mismatchIdx, varAName, contextA, varBName, contextB);
+				}
+			}
+		}
+
+		void TAPWriter::onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report)
+		{
+			if (m_bVerbose)
+			{
+				FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+				if (pBuffer)
+				{
+					pBuffer->appendFormat(i18n::getString(i18n::TAP_ASSERT_HEADER), info.getFile(), info.getFunction(), info.getLine())
+							.appendFormat("%s %s %s\n", varAName, getBinaryAssertFailText(type), varBName);
+
+					formatDataDiff(*pBuffer, report, varAName, varBName);
+				}
+			}
+		}
+
+		void TAPWriter::onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport)
+		{
+			if (m_bVerbose)
+			{
+				FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+				if (pBuffer)
+				{
+					pBuffer->appendFormat(i18n::getString(i18n::TAP_ASSERT_HEADER), info.getFile(), info.getFunction(), info.getLine())
+							.appendFormat("%s %s \"%s\"\n", varName, getUnaryAssertFailText(AssertType::MATCH_GOLDEN_FILE), goldenPath);
+
+					switch (status)
+					{
+					case compare::GoldenStatus::SIZE_MISMATCH:
+						pBuffer->appendFormat(i18n::getString(i18n::TAP_GOLDEN_SIZE_MISMATCH), dataSize, goldenSize);
+						break;
+
+					case compare::GoldenStatus::DATA_MISMATCH:
+						if (pReport)
+							formatDataDiff(*pBuffer, *pReport, varName, "golden");
+						break;
+
+					case compare::GoldenStatus::CANNOT_UPDATE:
+						pBuffer->append(i18n::getString(i18n::TAP_GOLDEN_CANNOT_UPDATE));
+						break;
+
+					default:
+						pBuffer->append(i18n::getString(i18n::TAP_GOLDEN_CANNOT_READ));
+						break;
+					}
+				}
+			}
+		}
+
+		void TAPWriter::onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest)
+		{
+			if (m_bVerbose)
+			{
+				FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+				if (pBuffer)
+				{
+					pBuffer->appendFormat(i18n::getString(i18n::TAP_ASSERT_HEADER), info.getFile(), info.getFunction(), info.getLine())
+							.appendFormat("%s %s\n", varName, getUnaryAssertFailText(type))
+							.appendFormat(i18n::getString(i18n::TAP_DIGEST_MISMATCH), expectedDigest, actualDigest);
+				}
+			}
+		}
+
+		void TAPWriter::onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers)
+		{
+			if (m_bVerbose)
+			{
+				FormattedBuffer* pBuffer = getWorkerThreadBuffer(workerThreadIdx);
+				if (pBuffer)
+				{
+					const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+					pBuffer->appendFormat(i18n::getString(i18n::TAP_ASSERT_HEADER), info.getFile(), info.getFunction(), info.getLine())
+							.appendFormat("%s %s\n", bodyName, getUnaryAssertFailText(type))
+							.append(i18n::getString(i18n::TAP_LATENCY_MEASURED)).formatPreciseTime(measuredTime, units)
+							.append(i18n::getString(i18n::LATENCY_BUDGET)).formatPreciseTime(static_cast<double>(maxTime), units)
+							.appendFormat(i18n::getString(i18n::LATENCY_RUNS), nbRuns, nbOutliers);
+				}
+			}
+		}
+
+		void TAPWriter::onBaselineComparison(const BaselineComparison& comparison)
+		{
+			FormattedBuffer* pBuffer = getControlThreadBuffer();
+			if (pBuffer)
+			{
+				if (formatBaselineComparison(pBuffer->append(i18n::getString(i18n::TAP_COMMENT)), comparison))
+					pBuffer->flushAndClear(m_pOut);
+				else
+					pBuffer->flushAndClear(nullptr);
+			}
+		}
+
 		void TAPWriter::onRuntimeError(unsigned int workerThreadIdx, RTErrorType type, const char* exceptionDetails)
 		{
 			if (m_bVerbose)
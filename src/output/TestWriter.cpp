@@ -12,9 +12,27 @@
 #include <new>
 
 #include "../../include/TestSuite.h"
+#include "../../include/Benchmark.h"
+#include "../stats/PerfCounters.h"
+#include "../stats/AllocTracker.h"
+#include "../stats/ResourceUsage.h"
+#include "../stats/IoUsage.h"
+#include "../stats/BenchEnvironment.h"
 #include "FormattedBuffer.h"
 #include "../i18n/i18n.h"
 
+namespace
+{
+	//Unavailable counters have negative values
+	void appendCounter(easyTest::output::FormattedBuffer& buffer, long long value, const char* unavailable)
+	{
+		if (value < 0)
+			buffer.append(unavailable);
+		else
+			buffer.appendFormat("%lld", value);
+	}
+}
+
 namespace easyTest
 {
 	namespace output
@@ -102,6 +120,33 @@ namespace easyTest
 			case AssertType::IS_FINITE:
 				return i18n::getString(i18n::ASSERT_FAIL_FINITE);
 
+			case AssertType::MATCH_GOLDEN_FILE:
+				return i18n::getString(i18n::ASSERT_FAIL_GOLDEN);
+
+			case AssertType::HAS_DATA_DIGEST:
+				return i18n::getString(i18n::ASSERT_FAIL_DIGEST);
+
+			case AssertType::HAS_DATA_TREE_DIGEST:
+				return i18n::getString(i18n::ASSERT_FAIL_TREE_DIGEST);
+
+			case AssertType::P99_BELOW:
+				return i18n::getString(i18n::ASSERT_FAIL_P99);
+
+			case AssertType::MEDIAN_BELOW:
+				return i18n::getString(i18n::ASSERT_FAIL_MEDIAN);
+
+			case AssertType::P99_CPU_TIME_BELOW:
+				return i18n::getString(i18n::ASSERT_FAIL_P99_CPU);
+
+			case AssertType::MEDIAN_CPU_TIME_BELOW:
+				return i18n::getString(i18n::ASSERT_FAIL_MEDIAN_CPU);
+
+			case AssertType::NO_ALLOC:
+				return i18n::getString(i18n::ASSERT_FAIL_NO_ALLOC);
+
+			case AssertType::HAS_COMPLEXITY:
+				return i18n::getString(i18n::ASSERT_FAIL_COMPLEXITY);
+
 			default:
 				return i18n::getString(i18n::ASSERT_FAIL_UNARY);
 			}
@@ -228,5 +273,280 @@ namespace easyTest
 				return i18n::getString(i18n::RTERROR_UNDEFINED);
 			}
 		}
+
+		void TestWriter::formatBenchmarkResult(FormattedBuffer& buffer, const BenchmarkResult& result) const
+		{
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+			const char* const* prefix = i18n::getSequence(i18n::BENCH_PREFIXES_SEQ, 6);
+
+			buffer.appendFormat(i18n::getString(i18n::BENCH_ITERATIONS), result.nbIterations, result.nbSamples)
+					.append(prefix[0]).formatPreciseTime(result.minTime, units)
+					.append(prefix[1]).formatPreciseTime(result.medianTime, units)
+					.append(prefix[2]).formatPreciseTime(result.meanTime, units)
+					.append(prefix[3]).formatPreciseTime(result.madTime, units)
+					.append(prefix[4]).formatPreciseTime(result.maxTime, units)
+					.append(prefix[5]).formatPreciseTime(result.cpuTime, units);
+
+			if (result.bytesPerSecond > 0.0)
+				buffer.appendFormat(i18n::getString(i18n::BENCH_BYTES_RATE), result.bytesPerSecond / (1024.0 * 1024.0));
+
+			if (result.itemsPerSecond > 0.0)
+				buffer.appendFormat(i18n::getString(i18n::BENCH_ITEMS_RATE), result.itemsPerSecond / 1000000.0);
+		}
+
+		void TestWriter::formatColdBenchmarkResult(FormattedBuffer& buffer, const BenchmarkResult& cold, const BenchmarkResult* pWarm) const
+		{
+			formatBenchmarkResult(buffer, cold);
+
+			if (pWarm && (pWarm->medianTime > 0.0))
+				buffer.appendFormat(i18n::getString(i18n::BENCH_COLD_RATIO), cold.medianTime / pWarm->medianTime);
+		}
+
+		const char* TestWriter::getComplexityName(Complexity complexity) const
+		{
+			if (complexity >= Complexity::ANY)
+				return nullptr;
+
+			return i18n::getSequence(i18n::COMPLEXITY_NAMES_SEQ, 5)[static_cast<int>(complexity)];
+		}
+
+		void TestWriter::formatRangeMeasure(FormattedBuffer& buffer, const RangeMeasure& measure) const
+		{
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+
+			buffer.appendFormat(i18n::getString(i18n::BENCH_ITERATIONS), measure.nbIterations, measure.nbSamples)
+					.append(i18n::getString(i18n::RANGE_MEDIAN)).formatPreciseTime(measure.medianTime, units)
+					.append(i18n::getString(i18n::BENCH_PREFIX_CPU)).formatPreciseTime(measure.cpuTime, units);
+		}
+
+		void TestWriter::formatComplexityFit(FormattedBuffer& buffer, const ComplexityResult& result) const
+		{
+			const char* bestFit = getComplexityName(result.bestFit);
+			if (bestFit)
+			{
+				buffer.appendFormat(i18n::getString(i18n::COMPLEXITY_BEST_FIT), bestFit)
+						.append(i18n::getString(i18n::COMPLEXITY_COEFFICIENT)).formatPreciseTime(result.coefficient, i18n::getSequence(i18n::TIME_UNITS_SEQ, 5))
+						.appendFormat(i18n::getString(i18n::COMPLEXITY_RMS), result.rms * 100.0);
+			}
+			else
+				buffer.append(i18n::getString(i18n::COMPLEXITY_NOT_FITTED));
+
+			const char* expected = getComplexityName(result.expected);
+			if (expected)
+				buffer.appendFormat(i18n::getString(i18n::COMPLEXITY_EXPECTED), expected);
+		}
+
+		void TestWriter::formatScalingMeasure(FormattedBuffer& buffer, const ScalingMeasure& measure) const
+		{
+			buffer.appendFormat(i18n::getString(i18n::SCALING_ITERATIONS), measure.nbIterations)
+					.appendFormat(i18n::getString(i18n::SCALING_THROUGHPUT), measure.throughput / 1000000.0)
+					.appendFormat(i18n::getString(i18n::SCALING_THREAD_THROUGHPUT), measure.threadThroughput / 1000000.0)
+					.appendFormat(i18n::getString(i18n::SCALING_EFFICIENCY), measure.efficiency * 100.0)
+					.appendFormat(i18n::getString(i18n::SCALING_FAIRNESS), measure.fairness)
+					.append(i18n::getString(i18n::BENCH_PREFIX_CPU)).formatPreciseTime(measure.cpuTime, i18n::getSequence(i18n::TIME_UNITS_SEQ, 5));
+		}
+
+		void TestWriter::formatABMeasure(FormattedBuffer& buffer, const ABMeasure& measure, size_t nbRounds) const
+		{
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+
+			buffer.appendFormat(i18n::getString(i18n::AB_ITERATIONS), measure.nbIterations, nbRounds)
+					.append(i18n::getString(i18n::AB_PREFIX_MEDIAN)).formatPreciseTime(measure.medianTime, units)
+					.append(i18n::getString(i18n::BENCH_PREFIX_MEAN)).formatPreciseTime(measure.meanTime, units)
+					.append(i18n::getString(i18n::BENCH_PREFIX_CPU)).formatPreciseTime(measure.cpuTime, units);
+		}
+
+		void TestWriter::formatABVerdict(FormattedBuffer& buffer, const ABResult& result) const
+		{
+			if (result.verdict == ABVerdict::A_FASTER)
+				buffer.appendFormat(i18n::getString(i18n::AB_FASTER), result.a.name, result.ratio, result.b.name);
+			else if ((result.verdict == ABVerdict::B_FASTER) && (result.ratio > 0.0))
+				buffer.appendFormat(i18n::getString(i18n::AB_FASTER), result.b.name, 1.0 / result.ratio, result.a.name);
+			else
+				buffer.appendFormat(i18n::getString(i18n::AB_NO_DIFFERENCE), result.a.name, result.b.name);
+
+			buffer.appendFormat(i18n::getString(i18n::AB_RATIO), result.b.name, result.a.name, result.ratio, result.lowRatio, result.highRatio);
+		}
+
+		void TestWriter::formatScopeTiming(FormattedBuffer& buffer, const ScopeTiming& timing) const
+		{
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+
+			buffer.appendFormat(i18n::getString(i18n::SCOPE_RUNS), timing.nbCalls)
+					.append(i18n::getString(i18n::TIME_PREFIX_REAL)).formatPreciseTime(static_cast<double>(timing.realTime), units)
+					.append(i18n::getString(i18n::TIME_PREFIX_THREAD)).formatPreciseTime(static_cast<double>(timing.threadTime), units);
+		}
+
+		void TestWriter::formatLatencies(FormattedBuffer& buffer, const LatencyHistogram& latencies) const
+		{
+			static const double s_percentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+			const char* const* prefix = i18n::getSequence(i18n::LATENCY_PREFIXES_SEQ, 7);
+
+			buffer.appendFormat(i18n::getString(i18n::LATENCY_COUNT), latencies.getTotalCount())
+					.append(prefix[0]).formatPreciseTime(static_cast<double>(latencies.getMin()), units)
+					.append(prefix[1]).formatPreciseTime(latencies.getMean(), units);
+
+			for (int i = 0; i < 4; ++i)
+				buffer.append(prefix[i + 2]).formatPreciseTime(static_cast<double>(latencies.getValueAtPercentile(s_percentiles[i])), units);
+
+			buffer.append(prefix[6]).formatPreciseTime(static_cast<double>(latencies.getMax()), units);
+		}
+
+		void TestWriter::formatPerfCounters(FormattedBuffer& buffer, const stats::PerfCounters& counters) const
+		{
+			const char* const* prefix = i18n::getSequence(i18n::COUNTER_PREFIXES_SEQ, 6);
+			const char* unavailable = i18n::getString(i18n::COUNTER_UNAVAILABLE);
+
+			appendCounter(buffer.append(prefix[0]), counters.getValue(stats::PerfCounter::CYCLES), unavailable);
+			appendCounter(buffer.append(prefix[1]), counters.getValue(stats::PerfCounter::INSTRUCTIONS), unavailable);
+
+			const double ipc = counters.getIPC();
+			if (ipc < 0.0)
+				buffer.append(prefix[2]).append(unavailable);
+			else
+				buffer.append(prefix[2]).appendFormat("%0.2f", ipc);
+
+			appendCounter(buffer.append(prefix[3]), counters.getValue(stats::PerfCounter::CACHE_MISSES), unavailable);
+			appendCounter(buffer.append(prefix[4]), counters.getValue(stats::PerfCounter::BRANCH_MISSES), unavailable);
+			appendCounter(buffer.append(prefix[5]), counters.getValue(stats::PerfCounter::PAGE_FAULTS), unavailable);
+		}
+
+		void TestWriter::formatAllocStats(FormattedBuffer& buffer, const stats::AllocTracker& tracker) const
+		{
+			buffer.appendFormat(i18n::getString(i18n::ALLOC_STATS), tracker.getNbAllocs(), tracker.getNbBytes(), tracker.getPeakLiveBytes());
+		}
+
+		void TestWriter::formatResourceUsage(FormattedBuffer& buffer, const stats::ResourceUsage& usage) const
+		{
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+			const char* const* prefix = i18n::getSequence(i18n::RESOURCE_PREFIXES_SEQ, 6);
+			const char* unavailable = i18n::getString(i18n::COUNTER_UNAVAILABLE);
+
+			//User and system times come first
+			for (int i = 0; i < 2; ++i)
+			{
+				const long long t = usage.getValue(static_cast<stats::ResourceCounter>(i));
+				if (t < 0)
+					buffer.append(prefix[i]).append(unavailable);
+				else
+					buffer.append(prefix[i]).formatTime(t, units, false);
+			}
+
+			for (int i = 2; i < static_cast<int>(stats::ResourceCounter::COUNT); ++i)
+				appendCounter(buffer.append(prefix[i]), usage.getValue(static_cast<stats::ResourceCounter>(i)), unavailable);
+		}
+
+		void TestWriter::formatIoUsage(FormattedBuffer& buffer, const stats::IoUsage& io, bool bLimitExceeded) const
+		{
+			const char* const* prefix = i18n::getSequence(i18n::IO_PREFIXES_SEQ, 6);
+			const char* unavailable = i18n::getString(i18n::COUNTER_UNAVAILABLE);
+
+			for (int i = 0; i < static_cast<int>(stats::IoCounter::COUNT); ++i)
+				appendCounter(buffer.append(prefix[i]), io.getValue(static_cast<stats::IoCounter>(i)), unavailable);
+
+			if (bLimitExceeded)
+				buffer.appendFormat(i18n::getString(i18n::IO_LIMIT), stats::getMaxIoPerCase());
+		}
+
+		void TestWriter::formatBenchEnvironment(FormattedBuffer& buffer, const stats::BenchEnvironment& env) const
+		{
+			const char* const* prefix = i18n::getSequence(i18n::ENV_PREFIXES_SEQ, 8);
+			const char* unavailable = i18n::getString(i18n::COUNTER_UNAVAILABLE);
+
+			buffer.append(prefix[0]).append(env.cpuModel[0] ? env.cpuModel : unavailable)
+					.append(prefix[1]).appendFormat("%u", env.nbCpus)
+					.append(prefix[2]).append(env.kernel[0] ? env.kernel : unavailable)
+					.append(prefix[3]).append(env.governor[0] ? env.governor : unavailable)
+					.append(prefix[4]);
+
+			if (env.turbo < 0)
+				buffer.append(unavailable);
+			else
+				buffer.append(i18n::getString(env.turbo ? i18n::ENV_TURBO_ON : i18n::ENV_TURBO_OFF));
+
+			buffer.append(prefix[5]);
+			if (env.loadAverage < 0.0)
+				buffer.append(unavailable);
+			else
+				buffer.appendFormat("%0.2f", env.loadAverage);
+
+			buffer.append(prefix[6]);
+			if (env.noise < 0.0)
+				buffer.append(unavailable);
+			else
+				buffer.appendFormat("%0.2f%%", env.noise * 100.0);
+
+			buffer.append(prefix[7]).append(i18n::getString(env.bPriorityRaised ? i18n::ENV_PRIORITY_RAISED : i18n::ENV_PRIORITY_NORMAL));
+		}
+
+		void TestWriter::formatEnvironmentWarning(FormattedBuffer& buffer, const stats::BenchEnvironment& env, stats::EnvironmentWarning warning) const
+		{
+			switch (warning)
+			{
+			case stats::EnvironmentWarning::GOVERNOR:
+				buffer.appendFormat(i18n::getString(i18n::ENV_WARNING_GOVERNOR), env.governor);
+				break;
+
+			case stats::EnvironmentWarning::TURBO:
+				buffer.append(i18n::getString(i18n::ENV_WARNING_TURBO));
+				break;
+
+			case stats::EnvironmentWarning::LOAD:
+				buffer.appendFormat(i18n::getString(i18n::ENV_WARNING_LOAD), env.loadAverage);
+				break;
+
+			case stats::EnvironmentWarning::NOISE:
+				buffer.appendFormat(i18n::getString(i18n::ENV_WARNING_NOISE), env.noise * 100.0);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		bool TestWriter::formatBaselineComparison(FormattedBuffer& buffer, const BaselineComparison& comparison) const
+		{
+			i18n::StringId header;
+			switch (comparison.verdict)
+			{
+			case BaselineVerdict::REGRESSION:
+				header = i18n::BASELINE_REGRESSION;
+				break;
+
+			case BaselineVerdict::IMPROVEMENT:
+				header = i18n::BASELINE_IMPROVEMENT;
+				break;
+
+			case BaselineVerdict::UNCHANGED:
+				if (!m_bVerbose)
+					return false;
+
+				header = i18n::BASELINE_UNCHANGED;
+				break;
+
+			case BaselineVerdict::NOT_ENOUGH_SAMPLES:
+				if (m_bVerbose)
+					buffer.appendFormat(i18n::getString(i18n::BASELINE_NOT_ENOUGH), comparison.testName, comparison.nbBaselineSamples, comparison.nbSamples);
+
+				return m_bVerbose;
+
+			default:
+				if (m_bVerbose)
+					buffer.appendFormat(i18n::getString(i18n::BASELINE_NEW_TEST), comparison.testName);
+
+				return m_bVerbose;
+			}
+
+			const char* const* units = i18n::getSequence(i18n::TIME_UNITS_SEQ, 5);
+			buffer.appendFormat(i18n::getString(header), comparison.testName)
+					.formatPreciseTime(comparison.baselineMedian, units)
+					.append(i18n::getString(i18n::BASELINE_MEDIANS))
+					.formatPreciseTime(comparison.median, units)
+					.appendFormat(i18n::getString(i18n::BASELINE_DETAILS), comparison.relativeChange * 100.0, comparison.pValue, comparison.nbBaselineSamples, comparison.nbSamples);
+
+			return true;
+		}
 	}
 }
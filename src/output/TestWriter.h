@@ -16,6 +16,18 @@
 
 namespace easyTest
 {
+	struct RangeMeasure;
+	struct ScalingMeasure;
+	struct ABMeasure;
+	struct ScopeTiming;
+	class LatencyHistogram;
+	enum struct Complexity : unsigned char;
+
+	namespace stats
+	{
+		enum struct EnvironmentWarning : unsigned char;
+	}
+
 	namespace output
 	{
 		class FormattedBuffer;
@@ -48,6 +60,79 @@ namespace easyTest
 			const char* getBinaryAssertFailText(AssertType type) const;
 			const char* getRuntimeErrorText(RTErrorType type) const;
 
+			//Returns nullptr for Complexity::ANY
+			const char* getComplexityName(Complexity complexity) const;
+
+			//Appends the iterations, times per iteration and throughputs of a
+			//benchmark result on a single line (without any line feed)
+			void formatBenchmarkResult(FormattedBuffer& buffer, const BenchmarkResult& result) const;
+
+			//Same as above for the cold cache result of a benchmark case,
+			//followed by its ratio to the warm cache median time if pWarm is
+			//not nullptr
+			void formatColdBenchmarkResult(FormattedBuffer& buffer, const BenchmarkResult& cold, const BenchmarkResult* pWarm) const;
+
+			//Appends the iterations and times per iteration of one input size
+			//of a range benchmark result, then its complexity fit, each on a
+			//single line (without any line feed)
+			void formatRangeMeasure(FormattedBuffer& buffer, const RangeMeasure& measure) const;
+			void formatComplexityFit(FormattedBuffer& buffer, const ComplexityResult& result) const;
+
+			//Appends the iterations, throughputs, efficiency, fairness and CPU
+			//time per iteration of one thread count of a scaling benchmark
+			//result on a single line (without any line feed)
+			void formatScalingMeasure(FormattedBuffer& buffer, const ScalingMeasure& measure) const;
+
+			//Appends the iterations, rounds and times per iteration of one
+			//body of an A/B benchmark result on a single line (without any
+			//line feed)
+			void formatABMeasure(FormattedBuffer& buffer, const ABMeasure& measure, size_t nbRounds) const;
+
+			//Appends the verdict of an A/B benchmark result, then its time
+			//ratio and confidence interval, on a single line (without any
+			//line feed)
+			void formatABVerdict(FormattedBuffer& buffer, const ABResult& result) const;
+
+			//Appends the number of runs and the total real and thread times
+			//of one TIMED_SCOPE site on a single line (without any line
+			//feed)
+			void formatScopeTiming(FormattedBuffer& buffer, const ScopeTiming& timing) const;
+
+			//Appends the number of recorded latencies, their min, mean,
+			//p50, p90, p99, p99.9 and max on a single line (without any line
+			//feed)
+			void formatLatencies(FormattedBuffer& buffer, const LatencyHistogram& latencies) const;
+
+			//Appends all performance counters values on a single line
+			//(without line feed), unavailable counters are written as such.
+			void formatPerfCounters(FormattedBuffer& buffer, const stats::PerfCounters& counters) const;
+
+			//Appends the heap allocation statistics of a test case on a
+			//single line (without line feed).
+			void formatAllocStats(FormattedBuffer& buffer, const stats::AllocTracker& tracker) const;
+
+			//Appends the operating system resources used by a test case on a
+			//single line (without line feed), unavailable values are written
+			//as such.
+			void formatResourceUsage(FormattedBuffer& buffer, const stats::ResourceUsage& usage) const;
+
+			//Appends the I/O of a test case on a single line (without line
+			//feed), followed by the I/O limit if bLimitExceeded is true.
+			void formatIoUsage(FormattedBuffer& buffer, const stats::IoUsage& io, bool bLimitExceeded) const;
+
+			//Appends the benchmark environment on a single line (without
+			//line feed), unavailable values are written as such.
+			void formatBenchEnvironment(FormattedBuffer& buffer, const stats::BenchEnvironment& env) const;
+
+			//Appends the text of a raised environment warning (without line
+			//feed).
+			void formatEnvironmentWarning(FormattedBuffer& buffer, const stats::BenchEnvironment& env, stats::EnvironmentWarning warning) const;
+
+			//Appends a baseline comparison on a single line (with its line
+			//feed). Unchanged and incomparable test cases are only written in
+			//verbose mode, the function returns false if nothing is written.
+			bool formatBaselineComparison(FormattedBuffer& buffer, const BaselineComparison& comparison) const;
+
 		private:
 			TestWriter(const TestWriter&) = delete;
 			TestWriter& operator=(const TestWriter&) = delete;
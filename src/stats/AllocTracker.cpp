@@ -0,0 +1,388 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "AllocTracker.h"
+
+#include <cstdlib>
+#include <cerrno>
+#include <new>
+#include <malloc.h>
+
+#include "../../include/NoAllocScope.h"
+
+#ifdef __GNUC__ //GNU-compatible compilers: g++, mingw and clang
+#ifdef __EXCEPTIONS
+#define HAS_EXCEPTIONS 1
+#endif
+#elif defined(_MSC_VER) //Visual C++ compiler
+#ifdef _CPPUNWIND
+#define HAS_EXCEPTIONS 1
+#endif
+#else
+#error Unsupported compiler: currently supported compilers are\
+       gnu-compatible ones (gcc, mingw and clang) and Visual C++
+#endif
+
+//By default, no allocation function is replaced: the library defines no
+//global allocator symbol and allocations are never counted.
+//When built with EASYTEST_NEW_HOOKS, operator new/delete are replaced.
+//When built with EASYTEST_MALLOC_HOOKS and the GNU C library, the whole
+//malloc family is replaced instead and forwards to the glibc implementation,
+//so that allocations from C code are counted too. This replacement conflicts
+//with sanitizers, Valgrind and other allocators (jemalloc, tcmalloc...).
+#if defined(EASYTEST_MALLOC_HOOKS) && defined(__GLIBC__)
+#define INTERPOSE_MALLOC 1
+
+extern "C"
+{
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t nbElements, size_t size);
+	void* __libc_realloc(void* ptr, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void* __libc_valloc(size_t size);
+	void* __libc_pvalloc(size_t size);
+	void __libc_free(void* ptr);
+}
+#elif defined(EASYTEST_NEW_HOOKS) || defined(EASYTEST_MALLOC_HOOKS)
+#define REPLACE_NEW 1
+#endif //EASYTEST_MALLOC_HOOKS && __GLIBC__
+
+namespace
+{
+	bool s_bEnabled = false;
+
+	//Trivial type: zero-initialized without any thread-local guard nor
+	//allocation, so that it can be used from the allocation functions
+	struct ThreadAllocState
+	{
+		bool bCounting;
+		unsigned int nbTrackers;
+		unsigned int nbScopes;
+		size_t nbAllocs;
+		size_t nbBytes;
+		long long liveBytes;
+		long long peakLiveBytes;
+	};
+
+	thread_local ThreadAllocState t_allocState;
+
+	inline void updateCounting(ThreadAllocState& state)
+	{
+		state.bCounting = (state.nbTrackers || state.nbScopes);
+	}
+
+	inline long long getBlockSize(void* ptr)
+	{
+#ifdef _WIN32
+		return static_cast<long long>(_msize(ptr));
+#else
+		return static_cast<long long>(malloc_usable_size(ptr));
+#endif //_WIN32
+	}
+
+	inline void countAlloc(void* ptr)
+	{
+		ThreadAllocState& state = t_allocState;
+		if (state.bCounting && ptr)
+		{
+			const long long size = getBlockSize(ptr);
+			state.nbAllocs++;
+			state.nbBytes += static_cast<size_t>(size);
+			state.liveBytes += size;
+			if (state.liveBytes > state.peakLiveBytes)
+				state.peakLiveBytes = state.liveBytes;
+		}
+	}
+
+	inline void countFree(void* ptr)
+	{
+		ThreadAllocState& state = t_allocState;
+		if (state.bCounting && ptr)
+			state.liveBytes -= getBlockSize(ptr);
+	}
+
+#ifdef REPLACE_NEW
+	void* allocateBlock(size_t size, bool bNoThrow)
+	{
+		if (!size)
+			size = 1;
+
+		for (;;)
+		{
+			void* ptr = std::malloc(size);
+			if (ptr)
+			{
+				countAlloc(ptr);
+				return ptr;
+			}
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+			{
+#ifdef HAS_EXCEPTIONS
+				if (!bNoThrow)
+					throw std::bad_alloc();
+#endif //HAS_EXCEPTIONS
+				return nullptr;
+			}
+
+#ifdef HAS_EXCEPTIONS
+			if (bNoThrow)
+			{
+				try
+				{
+					handler();
+				}
+				catch (...)
+				{
+					return nullptr;
+				}
+			}
+			else
+#endif //HAS_EXCEPTIONS
+				handler();
+		}
+	}
+
+	void freeBlock(void* ptr)
+	{
+		countFree(ptr);
+		std::free(ptr);
+	}
+#endif //REPLACE_NEW
+}
+
+#ifdef INTERPOSE_MALLOC
+extern "C"
+{
+	void* malloc(size_t size) noexcept
+	{
+		void* ptr = __libc_malloc(size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	void* calloc(size_t nbElements, size_t size) noexcept
+	{
+		void* ptr = __libc_calloc(nbElements, size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	//A reallocation always counts as a new allocation, even if the block is
+	//resized in place
+	void* realloc(void* ptr, size_t size) noexcept
+	{
+		if (!t_allocState.bCounting)
+			return __libc_realloc(ptr, size);
+
+		const long long oldSize = ptr ? getBlockSize(ptr) : 0;
+		void* newPtr = __libc_realloc(ptr, size);
+		if (newPtr || !size)
+		{
+			t_allocState.liveBytes -= oldSize;
+			countAlloc(newPtr);
+		}
+
+		return newPtr;
+	}
+
+	void* reallocarray(void* ptr, size_t nbElements, size_t size) noexcept
+	{
+		if (size && (nbElements > static_cast<size_t>(-1) / size))
+		{
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		return realloc(ptr, nbElements * size);
+	}
+
+	void free(void* ptr) noexcept
+	{
+		countFree(ptr);
+		__libc_free(ptr);
+	}
+
+	void* memalign(size_t alignment, size_t size) noexcept
+	{
+		void* ptr = __libc_memalign(alignment, size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) noexcept
+	{
+		void* ptr = __libc_memalign(alignment, size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	void* valloc(size_t size) noexcept
+	{
+		void* ptr = __libc_valloc(size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	void* pvalloc(size_t size) noexcept
+	{
+		void* ptr = __libc_pvalloc(size);
+		countAlloc(ptr);
+		return ptr;
+	}
+
+	int posix_memalign(void** pPtr, size_t alignment, size_t size) noexcept
+	{
+		if (!alignment || (alignment % sizeof(void*)) || (alignment & (alignment - 1)))
+			return EINVAL;
+
+		void* ptr = __libc_memalign(alignment, size);
+		if (!ptr)
+			return ENOMEM;
+
+		countAlloc(ptr);
+		*pPtr = ptr;
+		return 0;
+	}
+}
+#elif defined(REPLACE_NEW)
+void* operator new(size_t size)
+{
+	return allocateBlock(size, false);
+}
+
+void* operator new[](size_t size)
+{
+	return allocateBlock(size, false);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateBlock(size, true);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateBlock(size, true);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	freeBlock(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	freeBlock(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	freeBlock(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	freeBlock(ptr);
+}
+#endif //INTERPOSE_MALLOC || REPLACE_NEW
+
+namespace easyTest
+{
+	void NoAllocScope::begin()
+	{
+		ThreadAllocState& state = t_allocState;
+		state.nbScopes++;
+		updateCounting(state);
+		m_nbAllocs = state.nbAllocs;
+	}
+
+	void NoAllocScope::end()
+	{
+		ThreadAllocState& state = t_allocState;
+		m_nbAllocs = state.nbAllocs - m_nbAllocs;
+		if (state.nbScopes)
+			state.nbScopes--;
+
+		updateCounting(state);
+	}
+
+	namespace stats
+	{
+		bool isAllocTrackingAvailable()
+		{
+#if defined(INTERPOSE_MALLOC) || defined(REPLACE_NEW)
+			return true;
+#else
+			return false;
+#endif //INTERPOSE_MALLOC || REPLACE_NEW
+		}
+
+		bool setAllocTrackingEnabled(bool bEnabled)
+		{
+			if (bEnabled && !isAllocTrackingAvailable())
+				return false;
+
+			s_bEnabled = bEnabled;
+			return true;
+		}
+
+		bool isAllocTrackingEnabled()
+		{
+			return s_bEnabled;
+		}
+
+		void AllocTracker::start()
+		{
+			if (m_bRunning)
+				return;
+
+			ThreadAllocState& state = t_allocState;
+			state.nbTrackers++;
+			updateCounting(state);
+
+			//The thread peak is restored on stop() so that nested trackers
+			//keep the peak of the enclosing ones
+			m_enclosingPeakLiveBytes = state.peakLiveBytes;
+			state.peakLiveBytes = state.liveBytes;
+
+			m_nbAllocs = state.nbAllocs;
+			m_nbBytes = state.nbBytes;
+			m_startLiveBytes = state.liveBytes;
+			m_bRunning = true;
+		}
+
+		void AllocTracker::stop()
+		{
+			if (!m_bRunning)
+				return;
+
+			ThreadAllocState& state = t_allocState;
+			m_nbAllocs = state.nbAllocs - m_nbAllocs;
+			m_nbBytes = state.nbBytes - m_nbBytes;
+			m_peakLiveBytes = state.peakLiveBytes - m_startLiveBytes;
+			if (m_enclosingPeakLiveBytes > state.peakLiveBytes)
+				state.peakLiveBytes = m_enclosingPeakLiveBytes;
+
+			if (state.nbTrackers)
+				state.nbTrackers--;
+
+			updateCounting(state);
+			m_bRunning = false;
+		}
+
+		void resetAllocScopes()
+		{
+			ThreadAllocState& state = t_allocState;
+			state.nbScopes = 0;
+			updateCounting(state);
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _ALLOCTRACKER_H_
+#define _ALLOCTRACKER_H_
+
+#include <cstddef>
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Heap allocations are only intercepted by builds made with allocation
+		//hooks: operator new/delete are replaced when built with
+		//EASYTEST_NEW_HOOKS (ALLOC_HOOKS=new), the whole malloc family is
+		//replaced when built with EASYTEST_MALLOC_HOOKS (ALLOC_HOOKS=malloc)
+		//and the GNU C library. Other builds count no allocation at all.
+		//Allocations are only counted on threads where an AllocTracker is
+		//running or a NoAllocScope is open, any other allocation costs a
+		//single thread-local flag test.
+		bool isAllocTrackingAvailable();
+
+		//Per test case allocation statistics are disabled by default, they
+		//must be enabled before starting the runner. Returns false if
+		//allocation tracking is not available in this build.
+		bool setAllocTrackingEnabled(bool bEnabled);
+		bool isAllocTrackingEnabled();
+
+		//Counts the heap allocations of the calling thread between start()
+		//and stop(), which must be called by the same thread. Sizes are the
+		//usable sizes of the allocated blocks, which may be slightly larger
+		//than the requested sizes. The peak of live bytes is the maximum
+		//growth of the allocated memory since start(): blocks allocated
+		//before start() and freed before stop() reduce it. Trackers may be
+		//nested, each one keeps its own peak.
+		class AllocTracker final
+		{
+		public:
+			AllocTracker() = default;
+
+			void start();
+			void stop();
+
+			size_t getNbAllocs() const
+			{
+				return m_nbAllocs;
+			}
+
+			size_t getNbBytes() const
+			{
+				return m_nbBytes;
+			}
+
+			long long getPeakLiveBytes() const
+			{
+				return m_peakLiveBytes;
+			}
+
+		private:
+			AllocTracker(const AllocTracker&) = delete;
+			AllocTracker& operator=(const AllocTracker&) = delete;
+
+			bool m_bRunning = false;
+			size_t m_nbAllocs = 0;
+			size_t m_nbBytes = 0;
+			long long m_startLiveBytes = 0;
+			long long m_peakLiveBytes = 0;
+			long long m_enclosingPeakLiveBytes = 0; //thread peak of live bytes when started
+		};
+
+		//Closes all NoAllocScope instances of the calling thread, which are
+		//left open when a runtime error interrupts their body
+		void resetAllocScopes();
+	}
+}
+
+#endif //_ALLOCTRACKER_H_
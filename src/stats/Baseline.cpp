@@ -0,0 +1,567 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "Baseline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include "../../include/Benchmark.h"
+#include "../../include/CaseMetrics.h"
+#include "CodeTimer.h"
+#include "BenchmarkStats.h"
+
+namespace
+{
+	const char BASELINE_MAGIC[8] = {'E', 'T', 'B', 'A', 'S', 'E', '1', '\0'};
+
+	//Maximum size of a test name read from a baseline file
+	const uint32_t MAX_TEST_NAME_SIZE = 4096;
+
+	std::FILE* openFile(const char* path, const char* mode)
+	{
+#if defined(_WIN32) && defined(_MSC_VER) //Visual C++ compiler
+		std::FILE* pFile = nullptr;
+		fopen_s(&pFile, path, mode);
+		return pFile;
+#else
+		return std::fopen(path, mode);
+#endif //_WIN32 && _MSC_VER
+	}
+
+	bool readUInt32(std::FILE* pFile, uint32_t& value)
+	{
+		return (std::fread(&value, sizeof(value), 1, pFile) == 1);
+	}
+
+	bool writeUInt32(std::FILE* pFile, size_t value)
+	{
+		const uint32_t v = static_cast<uint32_t>(value);
+		return (std::fwrite(&v, sizeof(v), 1, pFile) == 1);
+	}
+
+	struct RankedSample
+	{
+		double value;
+		bool bGroupA;
+
+		bool operator<(const RankedSample& other) const
+		{
+			return value < other.value;
+		}
+	};
+
+	//Median of nbSamples samples, samples are left untouched
+	double computeMedian(const double* samples, size_t nbSamples)
+	{
+		double* sorted = new(std::nothrow) double[nbSamples];
+		if (!sorted)
+			return 0.0;
+
+		std::memcpy(sorted, samples, nbSamples * sizeof(double));
+		std::sort(sorted, sorted + nbSamples);
+		const double median = easyTest::stats::computeQuantile(sorted, nbSamples, 0.5);
+		delete[] sorted;
+		return median;
+	}
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		BaselineData::~BaselineData()
+		{
+			clear();
+		}
+
+		void BaselineData::clear()
+		{
+			for (size_t i = 0; i < m_nbEntries; ++i)
+			{
+				delete[] m_entries[i].name;
+				delete[] m_entries[i].samples;
+			}
+
+			delete[] m_entries;
+			m_entries = nullptr;
+			m_nbEntries = 0;
+			m_capacity = 0;
+		}
+
+		BaselineData::Entry* BaselineData::findEntry(const char* name) const
+		{
+			for (size_t i = 0; i < m_nbEntries; ++i)
+			{
+				if (!std::strcmp(m_entries[i].name, name))
+					return m_entries + i;
+			}
+
+			return nullptr;
+		}
+
+		BaselineData::Entry* BaselineData::addEntry(char* name)
+		{
+			if (m_nbEntries == m_capacity)
+			{
+				const size_t capacity = m_capacity ? 2 * m_capacity : 16;
+				Entry* entries = new(std::nothrow) Entry[capacity];
+				if (!entries)
+					return nullptr;
+
+				if (m_entries)
+				{
+					std::memcpy(entries, m_entries, m_nbEntries * sizeof(Entry));
+					delete[] m_entries;
+				}
+
+				m_entries = entries;
+				m_capacity = capacity;
+			}
+
+			Entry* pEntry = m_entries + m_nbEntries++;
+			pEntry->name = name;
+			pEntry->samples = nullptr;
+			pEntry->nbSamples = 0;
+			pEntry->capacity = 0;
+			return pEntry;
+		}
+
+		BaselineData::Entry* BaselineData::getEntry(const char* testSuiteName, const char* testCaseName, const char* metricName)
+		{
+			const size_t suiteLen = std::strlen(testSuiteName);
+			const size_t caseLen = std::strlen(testCaseName);
+			const size_t metricLen = metricName ? std::strlen(metricName) + 1 : 0;
+			char* name = new(std::nothrow) char[suiteLen + caseLen + metricLen + 3];
+			if (!name)
+				return nullptr;
+
+			std::memcpy(name, testSuiteName, suiteLen);
+			name[suiteLen] = ':';
+			name[suiteLen + 1] = ':';
+			std::memcpy(name + suiteLen + 2, testCaseName, caseLen + 1);
+			if (metricName)
+			{
+				name[suiteLen + caseLen + 2] = '@';
+				std::memcpy(name + suiteLen + caseLen + 3, metricName, metricLen);
+			}
+
+			Entry* pEntry = findEntry(name);
+			if (pEntry)
+				delete[] name;
+			else
+			{
+				pEntry = addEntry(name);
+				if (!pEntry)
+					delete[] name;
+			}
+
+			return pEntry;
+		}
+
+		bool BaselineData::addEntrySamples(Entry& entry, const double* samples, size_t nbSamples)
+		{
+			if (entry.nbSamples + nbSamples > MAX_BASELINE_SAMPLES)
+				nbSamples = MAX_BASELINE_SAMPLES - entry.nbSamples;
+
+			if (entry.nbSamples + nbSamples > entry.capacity)
+			{
+				size_t capacity = entry.capacity ? 2 * entry.capacity : 32;
+				while (capacity < entry.nbSamples + nbSamples)
+					capacity *= 2;
+
+				if (capacity > MAX_BASELINE_SAMPLES)
+					capacity = MAX_BASELINE_SAMPLES;
+
+				double* newSamples = new(std::nothrow) double[capacity];
+				if (!newSamples)
+					return false;
+
+				if (entry.samples)
+				{
+					std::memcpy(newSamples, entry.samples, entry.nbSamples * sizeof(double));
+					delete[] entry.samples;
+				}
+
+				entry.samples = newSamples;
+				entry.capacity = capacity;
+			}
+
+			if (nbSamples)
+			{
+				std::memcpy(entry.samples + entry.nbSamples, samples, nbSamples * sizeof(double));
+				entry.nbSamples += nbSamples;
+			}
+
+			return true;
+		}
+
+		bool BaselineData::addSamples(const char* testSuiteName, const char* testCaseName, const double* samples, size_t nbSamples)
+		{
+			if (!testSuiteName || !testCaseName || (!samples && nbSamples))
+				return false;
+
+			Entry* pEntry = getEntry(testSuiteName, testCaseName, nullptr);
+			return pEntry && addEntrySamples(*pEntry, samples, nbSamples);
+		}
+
+		bool BaselineData::addMetricSample(const char* testSuiteName, const char* testCaseName, const char* metricName, double value)
+		{
+			if (!testSuiteName || !testCaseName || !metricName)
+				return false;
+
+			Entry* pEntry = getEntry(testSuiteName, testCaseName, metricName);
+			return pEntry && addEntrySamples(*pEntry, &value, 1);
+		}
+
+		bool BaselineData::isMetric(const char* testName)
+		{
+			//Test suite and test case names are C++ identifiers
+			return testName && std::strchr(testName, '@');
+		}
+
+		size_t BaselineData::getSamples(const char* testName, const double*& samples) const
+		{
+			const Entry* pEntry = testName ? findEntry(testName) : nullptr;
+			if (!pEntry)
+			{
+				samples = nullptr;
+				return 0;
+			}
+
+			samples = pEntry->samples;
+			return pEntry->nbSamples;
+		}
+
+		bool BaselineData::load(const char* path)
+		{
+			clear();
+			if (!path)
+				return false;
+
+			std::FILE* pFile = openFile(path, "rb");
+			if (!pFile)
+				return false;
+
+			char magic[sizeof(BASELINE_MAGIC)];
+			uint32_t nbEntries = 0;
+			bool bRet = (std::fread(magic, sizeof(magic), 1, pFile) == 1) && !std::memcmp(magic, BASELINE_MAGIC, sizeof(magic)) && readUInt32(pFile, nbEntries);
+
+			for (uint32_t i = 0; bRet && (i < nbEntries); ++i)
+			{
+				uint32_t nameSize = 0;
+				uint32_t nbSamples = 0;
+				bRet = readUInt32(pFile, nameSize) && nameSize && (nameSize <= MAX_TEST_NAME_SIZE);
+				if (!bRet)
+					break;
+
+				char* name = new(std::nothrow) char[nameSize + 1];
+				bRet = name && (std::fread(name, 1, nameSize, pFile) == nameSize) && readUInt32(pFile, nbSamples) && (nbSamples <= MAX_BASELINE_SAMPLES);
+				if (!bRet)
+				{
+					delete[] name;
+					break;
+				}
+
+				name[nameSize] = '\0';
+				double* samples = nbSamples ? new(std::nothrow) double[nbSamples] : nullptr;
+				bRet = (samples || !nbSamples) && (std::fread(samples, sizeof(double), nbSamples, pFile) == nbSamples) && !findEntry(name);
+
+				Entry* pEntry = bRet ? addEntry(name) : nullptr;
+				if (!pEntry)
+				{
+					delete[] name;
+					delete[] samples;
+					bRet = false;
+					break;
+				}
+
+				pEntry->samples = samples;
+				pEntry->nbSamples = nbSamples;
+				pEntry->capacity = nbSamples;
+			}
+
+			std::fclose(pFile);
+			if (!bRet)
+				clear();
+
+			return bRet;
+		}
+
+		bool BaselineData::save(const char* path) const
+		{
+			if (!path)
+				return false;
+
+			std::FILE* pFile = openFile(path, "wb");
+			if (!pFile)
+				return false;
+
+			bool bRet = (std::fwrite(BASELINE_MAGIC, sizeof(BASELINE_MAGIC), 1, pFile) == 1) && writeUInt32(pFile, m_nbEntries);
+			for (size_t i = 0; bRet && (i < m_nbEntries); ++i)
+			{
+				const Entry& entry = m_entries[i];
+				const size_t nameSize = std::strlen(entry.name);
+				bRet = writeUInt32(pFile, nameSize) && (std::fwrite(entry.name, 1, nameSize, pFile) == nameSize)
+						&& writeUInt32(pFile, entry.nbSamples) && (std::fwrite(entry.samples, sizeof(double), entry.nbSamples, pFile) == entry.nbSamples);
+			}
+
+			return !std::fclose(pFile) && bRet;
+		}
+
+		double mannWhitneyPValue(const double* samplesA, size_t nbSamplesA, const double* samplesB, size_t nbSamplesB)
+		{
+			if (!nbSamplesA || !nbSamplesB)
+				return 1.0;
+
+			const size_t n = nbSamplesA + nbSamplesB;
+			RankedSample* ranked = new(std::nothrow) RankedSample[n];
+			if (!ranked)
+				return -1.0;
+
+			for (size_t i = 0; i < nbSamplesA; ++i)
+			{
+				ranked[i].value = samplesA[i];
+				ranked[i].bGroupA = true;
+			}
+
+			for (size_t i = 0; i < nbSamplesB; ++i)
+			{
+				ranked[nbSamplesA + i].value = samplesB[i];
+				ranked[nbSamplesA + i].bGroupA = false;
+			}
+
+			std::sort(ranked, ranked + n);
+
+			//Tied values all get the mean of their ranks
+			double rankSumA = 0.0;
+			double tieCorrection = 0.0;
+			for (size_t i = 0; i < n;)
+			{
+				size_t j = i + 1;
+				while ((j < n) && (ranked[j].value == ranked[i].value))
+					j++;
+
+				const double rank = (i + j + 1) / 2.0;
+				for (size_t k = i; k < j; ++k)
+				{
+					if (ranked[k].bGroupA)
+						rankSumA += rank;
+				}
+
+				const double t = static_cast<double>(j - i);
+				tieCorrection += t * t * t - t;
+				i = j;
+			}
+
+			delete[] ranked;
+
+			const double na = static_cast<double>(nbSamplesA);
+			const double nb = static_cast<double>(nbSamplesB);
+			const double u = rankSumA - na * (na + 1.0) / 2.0;
+			const double mean = na * nb / 2.0;
+			const double variance = na * nb / 12.0 * ((n + 1.0) - tieCorrection / (static_cast<double>(n) * (n - 1.0)));
+			if (variance <= 0.0)
+				return 1.0;
+
+			double z = (std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+			if (z < 0.0)
+				z = 0.0;
+
+			return std::erfc(z / std::sqrt(2.0));
+		}
+
+		void compareWithBaseline(BaselineComparison& comparison, const double* baselineSamples, size_t nbBaselineSamples, const double* samples, size_t nbSamples, double alpha, double minEffect)
+		{
+			comparison.nbBaselineSamples = nbBaselineSamples;
+			comparison.nbSamples = nbSamples;
+			comparison.baselineMedian = nbBaselineSamples ? computeMedian(baselineSamples, nbBaselineSamples) : 0.0;
+			comparison.median = nbSamples ? computeMedian(samples, nbSamples) : 0.0;
+			comparison.relativeChange = 0.0;
+			comparison.pValue = 1.0;
+
+			if (!nbBaselineSamples)
+			{
+				comparison.verdict = BaselineVerdict::NEW_TEST;
+				return;
+			}
+
+			if ((nbBaselineSamples < MIN_BASELINE_SAMPLES) || (nbSamples < MIN_BASELINE_SAMPLES))
+			{
+				comparison.verdict = BaselineVerdict::NOT_ENOUGH_SAMPLES;
+				return;
+			}
+
+			if (comparison.baselineMedian > 0.0)
+				comparison.relativeChange = comparison.median / comparison.baselineMedian - 1.0;
+
+			comparison.pValue = mannWhitneyPValue(baselineSamples, nbBaselineSamples, samples, nbSamples);
+
+			comparison.verdict = BaselineVerdict::UNCHANGED;
+			if ((comparison.pValue >= 0.0) && (comparison.pValue < alpha))
+			{
+				if (comparison.relativeChange > minEffect)
+					comparison.verdict = BaselineVerdict::REGRESSION;
+				else if (comparison.relativeChange < -minEffect)
+					comparison.verdict = BaselineVerdict::IMPROVEMENT;
+			}
+		}
+
+		bool BaselineRecorder::loadBaseline(const char* path)
+		{
+			m_bHasBaseline = m_baseline.load(path);
+			return m_bHasBaseline;
+		}
+
+		void BaselineRecorder::compareAll()
+		{
+			m_nbRegressions = 0;
+			for (size_t i = 0; i < m_samples.getNbTests(); ++i)
+			{
+				BaselineComparison comparison = {};
+				comparison.testName = m_samples.getTestName(i);
+				if (BaselineData::isMetric(comparison.testName))
+					continue;
+
+				const double* samples = nullptr;
+				const double* baselineSamples = nullptr;
+				const size_t nbSamples = m_samples.getSamples(comparison.testName, samples);
+				const size_t nbBaselineSamples = m_baseline.getSamples(comparison.testName, baselineSamples);
+				compareWithBaseline(comparison, baselineSamples, nbBaselineSamples, samples, nbSamples, m_alpha, m_minEffect);
+
+				if (comparison.verdict == BaselineVerdict::REGRESSION)
+					m_nbRegressions++;
+
+				if (m_pListener)
+					m_pListener->onBaselineComparison(comparison);
+			}
+		}
+
+		void BaselineRecorder::onEvent(const TestEvent& event)
+		{
+			switch (event.type)
+			{
+			case TestEventType::TESTRUNNER_START:
+				m_samples.clear();
+				m_nbRegressions = 0;
+				break;
+
+			case TestEventType::TESTRUNNER_FINISH:
+				if (m_bHasBaseline)
+					compareAll();
+				break;
+
+			case TestEventType::TESTCASE_FINISH:
+				//The total time of a range benchmark case depends on the
+				//calibration of each range and the one of a scaling or an A/B
+				//benchmark case on the target time, they are not recorded
+				if (event.testCaseFinish.bSuccess && !event.testCaseFinish.pComplexity && !event.testCaseFinish.pScaling && !event.testCaseFinish.pAB)
+				{
+					const BenchmarkResult* pBenchmark = event.testCaseFinish.pBenchmark;
+					double realTime = 0.0;
+					if (!pBenchmark && event.testCaseFinish.pTimer)
+						realTime = static_cast<double>(event.testCaseFinish.pTimer->getElapsedRealTime());
+
+					while (m_samplesLock.test_and_set(std::memory_order_acquire));
+
+					if (pBenchmark)
+						m_samples.addSamples(event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, pBenchmark->samples, pBenchmark->nbSamples);
+					else if (event.testCaseFinish.pTimer)
+						m_samples.addSamples(event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, &realTime, 1);
+
+					m_samplesLock.clear(std::memory_order_release);
+				}
+
+				//Metrics do not depend on the kind of test case
+				if (event.testCaseFinish.bSuccess && event.testCaseFinish.pMetrics)
+				{
+					const CaseMetrics& metrics = *event.testCaseFinish.pMetrics;
+
+					while (m_samplesLock.test_and_set(std::memory_order_acquire));
+
+					for (size_t i = 0; i < metrics.getNbMetrics(); ++i)
+						m_samples.addMetricSample(event.testCaseFinish.testSuiteName, event.testCaseFinish.testCaseName, metrics.getMetric(i).name, metrics.getMetric(i).value);
+
+					m_samplesLock.clear(std::memory_order_release);
+				}
+				break;
+
+			default:
+				break;
+			}
+
+			if (m_pListener)
+				m_pListener->onEvent(event);
+		}
+
+		void BaselineRecorder::onTrace(unsigned int workerThreadIdx, const SrcInfo& info, const char* format, std::va_list& varArgs)
+		{
+			if (m_pListener)
+				m_pListener->onTrace(workerThreadIdx, info, format, varArgs);
+		}
+
+		void BaselineRecorder::onUnaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName)
+		{
+			if (m_pListener)
+				m_pListener->onUnaryAssertFailure(workerThreadIdx, info, type, varName);
+		}
+
+		void BaselineRecorder::onBinaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName)
+		{
+			if (m_pListener)
+				m_pListener->onBinaryAssertFailure(workerThreadIdx, info, type, varAName, varBName);
+		}
+
+		void BaselineRecorder::onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB)
+		{
+			if (m_pListener)
+				m_pListener->onStringAssertFailure(workerThreadIdx, info, type, varAName, varBName, mismatchIdx, contextA, contextB);
+		}
+
+		void BaselineRecorder::onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report)
+		{
+			if (m_pListener)
+				m_pListener->onDataAssertFailure(workerThreadIdx, info, type, varAName, varBName, report);
+		}
+
+		void BaselineRecorder::onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport)
+		{
+			if (m_pListener)
+				m_pListener->onGoldenAssertFailure(workerThreadIdx, info, varName, goldenPath, status, dataSize, goldenSize, pReport);
+		}
+
+		void BaselineRecorder::onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest)
+		{
+			if (m_pListener)
+				m_pListener->onDigestAssertFailure(workerThreadIdx, info, type, varName, expectedDigest, actualDigest);
+		}
+
+		void BaselineRecorder::onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers)
+		{
+			if (m_pListener)
+				m_pListener->onLatencyAssertFailure(workerThreadIdx, info, type, bodyName, maxTime, measuredTime, nbRuns, nbOutliers);
+		}
+
+		void BaselineRecorder::onBaselineComparison(const BaselineComparison& comparison)
+		{
+			if (m_pListener)
+				m_pListener->onBaselineComparison(comparison);
+		}
+
+		void BaselineRecorder::onRuntimeError(unsigned int workerThreadIdx, RTErrorType type, const char* exceptionDetails)
+		{
+			if (m_pListener)
+				m_pListener->onRuntimeError(workerThreadIdx, type, exceptionDetails);
+		}
+	}
+}
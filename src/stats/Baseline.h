@@ -0,0 +1,173 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _BASELINE_H_
+#define _BASELINE_H_
+
+#include <atomic>
+
+#include "../ITestListener.h"
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Maximum number of timing samples kept per test case
+		const size_t MAX_BASELINE_SAMPLES = 1000;
+
+		//Minimum number of samples on both sides for a comparison to be
+		//statistically meaningful
+		const size_t MIN_BASELINE_SAMPLES = 3;
+
+		const double DEFAULT_BASELINE_ALPHA = 0.05;
+		const double DEFAULT_BASELINE_MIN_EFFECT = 0.05;
+
+		//Timing samples (in ns) of a set of test cases, identified by their
+		//full name "suite::case", and values of the metrics recorded by these
+		//test cases, identified by "suite::case@metric". Samples are stored
+		//in a compact binary file using the native byte order.
+		class BaselineData final
+		{
+		public:
+			BaselineData() = default;
+			~BaselineData();
+
+			//Returns false on memory allocation failure, samples beyond
+			//MAX_BASELINE_SAMPLES are ignored
+			bool addSamples(const char* testSuiteName, const char* testCaseName, const double* samples, size_t nbSamples);
+
+			//Adds one value of metric metricName, returns false on memory
+			//allocation failure
+			bool addMetricSample(const char* testSuiteName, const char* testCaseName, const char* metricName, double value);
+
+			//Returns true if testName identifies the values of a metric
+			//rather than timing samples
+			static bool isMetric(const char* testName);
+
+			//Returns the number of samples of testName (0 if unknown)
+			size_t getSamples(const char* testName, const double*& samples) const;
+
+			size_t getNbTests() const
+			{
+				return m_nbEntries;
+			}
+
+			const char* getTestName(size_t idx) const
+			{
+				return (idx < m_nbEntries) ? m_entries[idx].name : nullptr;
+			}
+
+			bool load(const char* path);
+			bool save(const char* path) const;
+
+			void clear();
+
+		private:
+			BaselineData(const BaselineData&) = delete;
+			BaselineData& operator=(const BaselineData&) = delete;
+
+			struct Entry
+			{
+				char* name;
+				double* samples;
+				size_t nbSamples;
+				size_t capacity;
+			};
+
+			Entry* findEntry(const char* name) const;
+			Entry* addEntry(char* name);
+
+			//Returns the entry named "suite::case" or "suite::case@metric"
+			//(metricName not null), added if unknown
+			Entry* getEntry(const char* testSuiteName, const char* testCaseName, const char* metricName);
+			bool addEntrySamples(Entry& entry, const double* samples, size_t nbSamples);
+
+			Entry* m_entries = nullptr;
+			size_t m_nbEntries = 0;
+			size_t m_capacity = 0;
+		};
+
+		//Two-sided p-value of the Mann-Whitney U test between samplesA and
+		//samplesB (normal approximation with tie and continuity corrections).
+		//Returns 1 if any of the sample sets is empty or all samples are
+		//equal, and a negative value on memory allocation failure.
+		double mannWhitneyPValue(const double* samplesA, size_t nbSamplesA, const double* samplesB, size_t nbSamplesB);
+
+		//Compares the samples of one test case with its baseline samples. A
+		//regression (or an improvement) is only reported if the difference is
+		//significant (p-value lower than alpha) and if the median changes by
+		//more than minEffect (relative value, 0.05 for 5%).
+		void compareWithBaseline(BaselineComparison& comparison, const double* baselineSamples, size_t nbBaselineSamples, const double* samples, size_t nbSamples, double alpha, double minEffect);
+
+		//Test listener collecting the timing samples of all test cases
+		//(the real time of ordinary cases, the per-iteration times of
+		//benchmark cases) and the metrics they record, and forwarding all
+		//notifications to another listener. When a baseline is loaded, the
+		//timings of every test case are compared with its baseline at the
+		//end of the runner, through onBaselineComparison() notifications
+		//sent right before the TESTRUNNER_FINISH event. Metrics are only
+		//saved, never compared.
+		class BaselineRecorder final : public ITestListener
+		{
+		public:
+			BaselineRecorder(ITestListener* pListener, double alpha, double minEffect) : m_pListener(pListener), m_alpha(alpha), m_minEffect(minEffect) {}
+
+			//Must be called before starting the runner
+			bool loadBaseline(const char* path);
+
+			//Must be called after the runner termination
+			bool saveBaseline(const char* path) const
+			{
+				return m_samples.save(path);
+			}
+
+			size_t getNbRegressions() const
+			{
+				return m_nbRegressions;
+			}
+
+			virtual void onEvent(const TestEvent& event) override final;
+
+			virtual void onTrace(unsigned int workerThreadIdx, const SrcInfo& info, const char* format, std::va_list& varArgs) override final;
+
+			virtual void onUnaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName) override final;
+			virtual void onBinaryAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName) override final;
+			virtual void onStringAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, size_t mismatchIdx, const char* contextA, const char* contextB) override final;
+			virtual void onDataAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varAName, const char* varBName, const compare::DataDiffReport& report) override final;
+			virtual void onGoldenAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, const char* varName, const char* goldenPath, compare::GoldenStatus status, size_t dataSize, size_t goldenSize, const compare::DataDiffReport* pReport) override final;
+			virtual void onDigestAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* varName, const char* expectedDigest, const char* actualDigest) override final;
+			virtual void onLatencyAssertFailure(unsigned int workerThreadIdx, const SrcInfo& info, AssertType type, const char* bodyName, long long maxTime, double measuredTime, size_t nbRuns, size_t nbOutliers) override final;
+
+			virtual void onBaselineComparison(const BaselineComparison& comparison) override final;
+
+			virtual void onRuntimeError(unsigned int workerThreadIdx, RTErrorType type, const char* exceptionDetails) override final;
+
+		private:
+			BaselineRecorder(const BaselineRecorder&) = delete;
+			BaselineRecorder& operator=(const BaselineRecorder&) = delete;
+
+			void compareAll();
+
+			ITestListener* const m_pListener;
+			const double m_alpha;
+			const double m_minEffect;
+
+			BaselineData m_baseline;
+			bool m_bHasBaseline = false;
+
+			//Samples are added by all worker-threads
+			BaselineData m_samples;
+			std::atomic_flag m_samplesLock = ATOMIC_FLAG_INIT;
+
+			size_t m_nbRegressions = 0;
+		};
+	}
+}
+
+#endif //_BASELINE_H_
@@ -0,0 +1,246 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "BenchEnvironment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "BenchmarkStats.h"
+#include "Chrono.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif //__linux__
+
+namespace
+{
+	const size_t NOISE_CALIBRATION_RUNS = 101;
+	const unsigned int NOISE_CALIBRATION_LOOPS = 10000;
+
+	//Removes trailing blanks and line feeds
+	void trimString(char* str)
+	{
+		for (size_t n = std::strlen(str); n && ((str[n - 1] == ' ') || (str[n - 1] == '\t') || (str[n - 1] == '\n') || (str[n - 1] == '\r')); --n)
+			str[n - 1] = '\0';
+	}
+
+#ifdef __linux__
+	const int RAISED_NICE_VALUE = -10;
+
+	void copyString(char* dst, size_t dstSize, const char* src)
+	{
+		//Long values are truncated
+		size_t n = 0;
+		for (; (n + 1 < dstSize) && src[n]; ++n)
+			dst[n] = src[n];
+
+		dst[n] = '\0';
+		trimString(dst);
+	}
+
+	//Reads the first line of a small procfs or sysfs file, returns false if
+	//the file cannot be read
+	bool readFirstLine(const char* path, char* line, size_t lineSize)
+	{
+		std::FILE* pFile = std::fopen(path, "r");
+		if (!pFile)
+			return false;
+
+		char buffer[256];
+		const bool bRead = (std::fgets(buffer, sizeof(buffer), pFile) != nullptr);
+		std::fclose(pFile);
+
+		if (bRead)
+			copyString(line, lineSize, buffer);
+
+		return bRead;
+	}
+
+	//The "model name" field of /proc/cpuinfo only exists on x86 systems,
+	//others are left unavailable
+	void readCpuModel(char* model, size_t modelSize)
+	{
+		std::FILE* pFile = std::fopen("/proc/cpuinfo", "r");
+		if (!pFile)
+			return;
+
+		char line[512];
+		while (std::fgets(line, sizeof(line), pFile))
+		{
+			if (!std::strncmp(line, "model name", 10))
+			{
+				const char* pValue = std::strchr(line, ':');
+				if (pValue)
+				{
+					for (++pValue; *pValue == ' '; ++pValue);
+					copyString(model, modelSize, pValue);
+				}
+				break;
+			}
+		}
+
+		std::fclose(pFile);
+	}
+
+	int readTurboState()
+	{
+		char value[16];
+
+		//intel_pstate driver
+		if (readFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo", value, sizeof(value)))
+			return (std::atoi(value) != 0) ? 0 : 1;
+
+		//acpi-cpufreq and amd-pstate drivers
+		if (readFirstLine("/sys/devices/system/cpu/cpufreq/boost", value, sizeof(value)))
+			return (std::atoi(value) != 0) ? 1 : 0;
+
+		return -1;
+	}
+#elif defined(_WIN32)
+	bool readRegistryString(const char* key, const char* name, char* value, size_t valueSize)
+	{
+		DWORD size = static_cast<DWORD>(valueSize);
+		if (RegGetValueA(HKEY_LOCAL_MACHINE, key, name, RRF_RT_REG_SZ, nullptr, value, &size) != ERROR_SUCCESS)
+		{
+			value[0] = '\0';
+			return false;
+		}
+
+		trimString(value);
+		return true;
+	}
+#endif //__linux__
+
+	//Fixed amount of work which cannot be optimized away
+	void runCalibrationLoop()
+	{
+		volatile unsigned int value = 1;
+		for (unsigned int i = 0; i < NOISE_CALIBRATION_LOOPS; ++i)
+			value = value * 1664525u + 1013904223u;
+	}
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		void collectBenchEnvironment(BenchEnvironment& env)
+		{
+			env.cpuModel[0] = '\0';
+			env.kernel[0] = '\0';
+			env.governor[0] = '\0';
+			env.nbCpus = 1;
+			env.turbo = -1;
+			env.loadAverage = -1.0;
+			env.noise = -1.0;
+			env.bPriorityRaised = false;
+
+#ifdef __linux__
+			readCpuModel(env.cpuModel, sizeof(env.cpuModel));
+
+			struct utsname name;
+			if (!uname(&name))
+				std::snprintf(env.kernel, sizeof(env.kernel), "%s %s", name.sysname, name.release);
+
+			const long nbCpus = sysconf(_SC_NPROCESSORS_ONLN);
+			if (nbCpus > 1)
+				env.nbCpus = static_cast<unsigned int>(nbCpus);
+
+			//Governors are usually the same for all CPUs, only the first one
+			//is checked
+			readFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", env.governor, sizeof(env.governor));
+			env.turbo = readTurboState();
+
+			double loadAverage = 0.0;
+			if (getloadavg(&loadAverage, 1) == 1)
+				env.loadAverage = loadAverage;
+
+#elif defined(_WIN32)
+			readRegistryString("HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", "ProcessorNameString", env.cpuModel, sizeof(env.cpuModel));
+
+			char build[32];
+			if (readRegistryString("SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion", "CurrentBuildNumber", build, sizeof(build)))
+				std::snprintf(env.kernel, sizeof(env.kernel), "Windows build %s", build);
+
+			SYSTEM_INFO sysInfo = {};
+			GetNativeSystemInfo(&sysInfo);
+			if (sysInfo.dwNumberOfProcessors > 1)
+				env.nbCpus = sysInfo.dwNumberOfProcessors;
+#endif //__linux__
+		}
+
+		double measureNoise()
+		{
+			const Chrono chrono(Chrono::Type::REAL_TIME);
+			double times[NOISE_CALIBRATION_RUNS];
+
+			//The first run warms up caches and CPU frequency
+			runCalibrationLoop();
+
+			for (size_t i = 0; i < NOISE_CALIBRATION_RUNS; ++i)
+			{
+				const long long start = chrono.tick();
+				runCalibrationLoop();
+				times[i] = static_cast<double>(chrono.tick() - start);
+			}
+
+			std::sort(times, times + NOISE_CALIBRATION_RUNS);
+			const double median = computeQuantile(times, NOISE_CALIBRATION_RUNS, 0.5);
+			if (median <= 0.0)
+				return -1.0;
+
+			for (size_t i = 0; i < NOISE_CALIBRATION_RUNS; ++i)
+				times[i] = std::fabs(times[i] - median);
+
+			std::sort(times, times + NOISE_CALIBRATION_RUNS);
+			return computeQuantile(times, NOISE_CALIBRATION_RUNS, 0.5) / median;
+		}
+
+		bool raiseThreadPriority()
+		{
+#ifdef __linux__
+			//Under Linux, the nice value is a per thread attribute
+			return !setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), RAISED_NICE_VALUE);
+#elif defined(_WIN32)
+			return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST) != 0;
+#endif //__linux__
+		}
+
+		bool hasEnvironmentWarning(const BenchEnvironment& env, EnvironmentWarning warning)
+		{
+			switch (warning)
+			{
+			case EnvironmentWarning::GOVERNOR:
+				return env.governor[0] && std::strcmp(env.governor, "performance");
+
+			case EnvironmentWarning::TURBO:
+				return (env.turbo > 0);
+
+			case EnvironmentWarning::LOAD:
+				return (env.loadAverage >= LOAD_AVERAGE_WARNING_THRESHOLD);
+
+			case EnvironmentWarning::NOISE:
+				return (env.noise > NOISE_WARNING_THRESHOLD);
+
+			default:
+				return false;
+			}
+		}
+	}
+}
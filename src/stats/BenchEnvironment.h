@@ -0,0 +1,69 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _BENCHENVIRONMENT_H_
+#define _BENCHENVIRONMENT_H_
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Thresholds above which the benchmark environment is reported as
+		//unstable
+		const double LOAD_AVERAGE_WARNING_THRESHOLD = 1.0; //one busy CPU on average
+		const double NOISE_WARNING_THRESHOLD = 0.05; //5% of relative dispersion
+
+		//Machine state recorded with benchmark results, so that results
+		//obtained on different machines or in different conditions can be
+		//told apart. Strings are empty and numeric values are negative when
+		//unavailable.
+		struct BenchEnvironment
+		{
+			char cpuModel[128];
+			char kernel[160];
+			char governor[32];		//CPU frequency scaling governor of the first CPU
+			unsigned int nbCpus;	//online logical CPUs
+			int turbo;				//1 if turbo boost is enabled, 0 if disabled
+			double loadAverage;		//over the last minute
+			double noise;			//median absolute deviation of the calibration loop times, relative to their median
+			bool bPriorityRaised;	//true if the runner threads scheduling priority has been raised
+		};
+
+		enum struct EnvironmentWarning : unsigned char
+		{
+			GOVERNOR,	//the frequency scaling governor is not "performance"
+			TURBO,		//turbo boost is enabled
+			LOAD,		//the load average is above LOAD_AVERAGE_WARNING_THRESHOLD
+			NOISE,		//the noise is above NOISE_WARNING_THRESHOLD
+			COUNT
+		};
+
+		//Reads the CPU model, kernel, frequency governor, turbo state and
+		//load average of the machine. Under Linux they are read from procfs,
+		//sysfs and uname(), under Windows only the CPU model, the kernel
+		//version and the number of CPUs are available. The noise is not
+		//measured and bPriorityRaised is set to false.
+		void collectBenchEnvironment(BenchEnvironment& env);
+
+		//Runs a short fixed calibration loop (a few ms in total) many times
+		//in the calling thread and returns the median absolute deviation of
+		//its times relative to their median, or -1 if it cannot be measured.
+		double measureNoise();
+
+		//Raises the scheduling priority of the calling thread (nice value
+		//of -10 under Linux, which needs the CAP_SYS_NICE capability, and
+		//THREAD_PRIORITY_HIGHEST under Windows). Returns false if the
+		//priority cannot be changed.
+		bool raiseThreadPriority();
+
+		bool hasEnvironmentWarning(const BenchEnvironment& env, EnvironmentWarning warning);
+	}
+}
+
+#endif //_BENCHENVIRONMENT_H_
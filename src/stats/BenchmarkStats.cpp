@@ -0,0 +1,1176 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "BenchmarkStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Chrono.h"
+#include "../TestRunner.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif //__linux__
+
+namespace
+{
+	const easyTest::stats::Chrono s_realTimeChrono(easyTest::stats::Chrono::Type::REAL_TIME);
+	const easyTest::stats::Chrono s_threadTimeChrono(easyTest::stats::Chrono::Type::THREAD_TIME);
+
+	const long long MIN_BENCHMARK_TARGET_TIME = 1000000; //1 ms
+
+	long long s_targetTime = easyTest::stats::DEFAULT_BENCHMARK_TARGET_TIME;
+
+	//Scaling benchmark threads check the shared deadline about every
+	//SCALING_CHECK_PERIOD, with batches of at most SCALING_MAX_BATCH
+	//iterations
+	const long long SCALING_CHECK_PERIOD = 50000; //50 µs
+	const size_t SCALING_MAX_BATCH = 1 << 20;
+
+	//Threads waiting at a barrier let other threads run, as there may be
+	//more threads than CPUs
+	inline void yieldThread()
+	{
+#ifdef __linux__
+		sched_yield();
+#elif defined(_WIN32)
+		SwitchToThread();
+#endif //__linux__
+	}
+
+	//Runs the benchmark body once with nbIterations iterations, returns false
+	//if the body fails or does not run its iteration loop until the end.
+	bool runBatch(easyTest::BenchmarkState& state, easyTest::TestSuite* pSuite, easyTest::BenchmarkBody body, const void* pUserData)
+	{
+		return body(pSuite, pUserData, state) && state.isFinished();
+	}
+
+	//Pins the calling thread to one CPU (the one it runs on under Linux, the
+	//first one of the process under Windows) until the instance is
+	//destroyed, which restores the previous affinity of the thread. Nothing
+	//is changed if the affinity cannot be read or set.
+	class CpuPin final
+	{
+	public:
+		CpuPin()
+		{
+#ifdef __linux__
+			CPU_ZERO(&m_previous);
+			const int cpu = sched_getcpu();
+			if ((cpu >= 0) && !sched_getaffinity(0, sizeof(m_previous), &m_previous))
+			{
+				cpu_set_t cpuSet;
+				CPU_ZERO(&cpuSet);
+				CPU_SET(cpu, &cpuSet);
+				m_bPinned = !sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+			}
+
+#elif defined(_WIN32)
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+			if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) && processMask)
+				m_previous = SetThreadAffinityMask(GetCurrentThread(), processMask & (~processMask + 1));
+#endif //__linux__
+		}
+
+		~CpuPin()
+		{
+#ifdef __linux__
+			if (m_bPinned)
+				sched_setaffinity(0, sizeof(m_previous), &m_previous);
+
+#elif defined(_WIN32)
+			if (m_previous)
+				SetThreadAffinityMask(GetCurrentThread(), m_previous);
+#endif //__linux__
+		}
+
+	private:
+		CpuPin(const CpuPin&) = delete;
+		CpuPin& operator=(const CpuPin&) = delete;
+
+#ifdef __linux__
+		cpu_set_t m_previous;
+		bool m_bPinned = false;
+#elif defined(_WIN32)
+		DWORD_PTR m_previous = 0;
+#endif //__linux__
+	};
+}
+
+namespace easyTest
+{
+#ifdef _MSC_VER //Visual C++ compiler
+	//Must not be inlined so that the pointed value is considered as used
+	void useCharPointer(const volatile char*)
+	{
+	}
+#endif //_MSC_VER
+
+	void BenchmarkState::pauseTiming()
+	{
+		if (m_bStarted && !m_bFinished && !m_bPaused)
+		{
+			m_elapsedRealTime += s_realTimeChrono.tick() - m_startRealTime;
+			m_elapsedThreadTime += s_threadTimeChrono.tick() - m_startThreadTime;
+			m_bPaused = true;
+		}
+	}
+
+	void BenchmarkState::resumeTiming()
+	{
+		if (m_bPaused)
+		{
+			m_bPaused = false;
+			m_startThreadTime = s_threadTimeChrono.tick();
+			m_startRealTime = s_realTimeChrono.tick();
+		}
+	}
+
+	bool BenchmarkState::nextStep()
+	{
+		if (m_pSync)
+			return nextScalingStep();
+
+		if (!m_bStarted)
+		{
+			m_bStarted = true;
+			if (!m_nbIterations)
+			{
+				m_bFinished = true;
+				return false;
+			}
+
+			//Data caches are evicted right before timing starts, so that
+			//the work done by the body before its loop is evicted too
+			if (m_evictionBuffer)
+				stats::evictCaches(m_evictionBuffer, m_evictionSize);
+
+			//Iterations whose latencies are recorded all go through
+			//nextStep()
+			m_nbRemaining = m_nbIterations - 1;
+			if (m_bRecordIterations)
+			{
+				m_nbLatencyIterations = m_nbRemaining;
+				m_nbRemaining = 0;
+			}
+
+			m_startThreadTime = s_threadTimeChrono.tick();
+			m_startRealTime = s_realTimeChrono.tick();
+			return true;
+		}
+
+		if (!m_bFinished)
+		{
+			const long long now = s_realTimeChrono.tick();
+			if (m_bRecordIterations)
+			{
+				const long long elapsed = m_elapsedRealTime + (m_bPaused ? 0 : now - m_startRealTime);
+				m_pLatencies->record(elapsed - m_iterationStartTime);
+				m_iterationStartTime = elapsed;
+
+				if (m_nbLatencyIterations)
+				{
+					m_nbLatencyIterations--;
+					return true;
+				}
+			}
+
+			if (!m_bPaused)
+			{
+				m_elapsedRealTime += now - m_startRealTime;
+				m_elapsedThreadTime += s_threadTimeChrono.tick() - m_startThreadTime;
+			}
+
+			m_bFinished = true;
+		}
+
+		return false;
+	}
+
+	//Shared by all threads of one thread count of a scaling benchmark case
+	struct ScalingSync
+	{
+		unsigned int nbThreads;
+		long long duration;
+		std::atomic_uint nbStarted;
+		std::atomic_uint nbStopped;
+		std::atomic<long long> deadline; //0 until all threads have reached the start barrier
+		std::atomic_bool bAborted;
+
+		//The last thread reaching the start barrier sets the deadline, which
+		//releases the others. bWait is false for threads which leave the
+		//benchmark without running their loop.
+		void enterStart(bool bWait)
+		{
+			if (nbStarted.fetch_add(1, std::memory_order_acq_rel) + 1 == nbThreads)
+				deadline.store(s_realTimeChrono.tick() + duration, std::memory_order_release);
+			else if (bWait)
+			{
+				while (!deadline.load(std::memory_order_acquire))
+					yieldThread();
+			}
+		}
+
+		void enterStop(bool bWait)
+		{
+			nbStopped.fetch_add(1, std::memory_order_acq_rel);
+			if (bWait)
+			{
+				while (nbStopped.load(std::memory_order_acquire) < nbThreads)
+					yieldThread();
+			}
+		}
+	};
+
+	struct ScalingThread
+	{
+		TestSuite* pSuite;
+		BenchmarkBody body;
+		const void* pUserData;
+		ScalingSync* pSync;
+		unsigned int threadIdx;
+		thread_t threadHandle;
+
+		bool bSuccess;
+		size_t nbIterations;
+		long long realTime;
+		long long threadTime;
+
+		void run()
+		{
+			BenchmarkState state(pSync, threadIdx, pSync->nbThreads);
+			bSuccess = body(pSuite, pUserData, state) && state.isFinished();
+			state.leaveScaling();
+
+			nbIterations = state.m_nbScalingIterations;
+			realTime = state.m_elapsedRealTime;
+			threadTime = state.m_elapsedThreadTime;
+		}
+
+		static threadproc_ret _callconv runThread(void* pUserData)
+		{
+			static_cast<ScalingThread*>(pUserData)->run();
+			return 0;
+		}
+	};
+
+	bool BenchmarkState::nextScalingStep()
+	{
+		if (!m_bStarted)
+		{
+			m_bStarted = true;
+			m_pSync->enterStart(true);
+
+			m_batchSize = 1;
+			m_nbScalingIterations = 1;
+			m_startThreadTime = s_threadTimeChrono.tick();
+			m_startRealTime = s_realTimeChrono.tick();
+			m_lastCheckTime = m_startRealTime;
+			if (!m_pSync->bAborted.load(std::memory_order_relaxed))
+				return true;
+
+			m_nbScalingIterations = 0;
+		}
+
+		if (!m_bFinished)
+		{
+			const long long now = s_realTimeChrono.tick();
+			if (m_nbScalingIterations && (now < m_pSync->deadline.load(std::memory_order_relaxed)) && !m_pSync->bAborted.load(std::memory_order_relaxed))
+			{
+				if ((now - m_lastCheckTime < SCALING_CHECK_PERIOD) && (m_batchSize < SCALING_MAX_BATCH))
+					m_batchSize *= 2;
+
+				m_lastCheckTime = now;
+				m_nbRemaining = m_batchSize - 1;
+				m_nbScalingIterations += m_batchSize;
+				return true;
+			}
+
+			if (!m_bPaused)
+			{
+				m_elapsedRealTime += now - m_startRealTime;
+				m_elapsedThreadTime += s_threadTimeChrono.tick() - m_startThreadTime;
+			}
+
+			m_bFinished = true;
+			m_pSync->enterStop(true);
+		}
+
+		return false;
+	}
+
+	void BenchmarkState::leaveScaling()
+	{
+		if (!m_pSync || m_bFinished)
+			return;
+
+		//Other threads stop as soon as they check the deadline
+		m_pSync->bAborted.store(true, std::memory_order_relaxed);
+		if (!m_bStarted)
+			m_pSync->enterStart(false);
+
+		m_pSync->enterStop(false);
+		m_bFinished = true;
+	}
+
+	bool BenchmarkState::runScaling(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, unsigned int maxThreads, ScalingResult& result)
+	{
+		result.nbMeasures = 0;
+		if (!body)
+			return false;
+
+#ifndef EASYTEST_NO_THREADS
+		if (!maxThreads)
+			maxThreads = stats::getAffinityCpuCount();
+		else if (maxThreads > BENCHMARK_MAX_THREADS)
+			maxThreads = BENCHMARK_MAX_THREADS;
+#else //EASYTEST_NO_THREADS is defined
+		maxThreads = 1;
+#endif //!EASYTEST_NO_THREADS
+
+		//Thread counts double from 1 while they are lower than maxThreads,
+		//which is always the last one
+		size_t nbMeasures = 1;
+		for (unsigned int nbThreads = 1; nbThreads < maxThreads; nbThreads *= 2)
+			nbMeasures++;
+
+		long long targetTime = stats::getBenchmarkTargetTime() / static_cast<long long>(nbMeasures);
+		if (targetTime < MIN_BENCHMARK_TARGET_TIME)
+			targetTime = MIN_BENCHMARK_TARGET_TIME;
+
+		ScalingThread* threads = new(std::nothrow) ScalingThread[maxThreads];
+		if (!threads)
+			return false;
+
+		bool bRet = true;
+		unsigned int nbThreads = 1;
+		for (size_t i = 0; bRet && (i < nbMeasures); ++i)
+		{
+			if (i == nbMeasures - 1)
+				nbThreads = maxThreads;
+
+			ScalingSync sync;
+			sync.nbThreads = nbThreads;
+			sync.duration = targetTime;
+			sync.nbStarted.store(0, std::memory_order_relaxed);
+			sync.nbStopped.store(0, std::memory_order_relaxed);
+			sync.deadline.store(0, std::memory_order_relaxed);
+			sync.bAborted.store(false, std::memory_order_relaxed);
+
+			for (unsigned int j = 0; j < nbThreads; ++j)
+			{
+				ScalingThread& thread = threads[j];
+				thread.pSuite = pSuite;
+				thread.body = body;
+				thread.pUserData = pUserData;
+				thread.pSync = &sync;
+				thread.threadIdx = j;
+				thread.threadHandle = 0;
+				thread.bSuccess = false;
+				thread.nbIterations = 0;
+				thread.realTime = thread.threadTime = 0;
+			}
+
+			//Extra threads inherit the affinity of the calling thread. The
+			//threads which cannot be created are replaced by aborted
+			//arrivals at both barriers.
+#ifndef EASYTEST_NO_THREADS
+			for (unsigned int j = 1; j < nbThreads; ++j)
+			{
+				ScalingThread& thread = threads[j];
+				bool bCreated = false;
+
+#ifdef __linux__
+				bCreated = !pthread_create(&thread.threadHandle, nullptr, &ScalingThread::runThread, &thread);
+
+#elif defined(_WIN32)
+				thread.threadHandle = _beginthreadex(nullptr, 0, &ScalingThread::runThread, &thread, 0, nullptr);
+				bCreated = (thread.threadHandle != 0);
+#endif //__linux__
+
+				if (!bCreated)
+				{
+					thread.threadHandle = 0;
+					sync.bAborted.store(true, std::memory_order_relaxed);
+					sync.enterStart(false);
+					sync.enterStop(false);
+				}
+			}
+#endif //!EASYTEST_NO_THREADS
+
+			threads[0].run();
+
+#ifndef EASYTEST_NO_THREADS
+			for (unsigned int j = 1; j < nbThreads; ++j)
+			{
+				ScalingThread& thread = threads[j];
+				if (thread.threadHandle)
+				{
+#ifdef __linux__
+					pthread_join(thread.threadHandle, nullptr);
+
+#elif defined(_WIN32)
+					HANDLE hThread = reinterpret_cast<HANDLE>(thread.threadHandle);
+					WaitForSingleObject(hThread, INFINITE);
+					CloseHandle(hThread);
+#endif //__linux__
+				}
+			}
+#endif //!EASYTEST_NO_THREADS
+
+			for (unsigned int j = 0; bRet && (j < nbThreads); ++j)
+				bRet = threads[j].bSuccess;
+
+			if (bRet)
+			{
+				ScalingMeasure& measure = result.measures[i];
+				measure.nbThreads = nbThreads;
+
+				size_t nbIterations[BENCHMARK_MAX_THREADS];
+				long long realTimes[BENCHMARK_MAX_THREADS];
+				long long threadTimes[BENCHMARK_MAX_THREADS];
+				for (unsigned int j = 0; j < nbThreads; ++j)
+				{
+					nbIterations[j] = threads[j].nbIterations;
+					realTimes[j] = threads[j].realTime;
+					threadTimes[j] = threads[j].threadTime;
+				}
+
+				stats::computeScalingMeasure(measure, nbIterations, realTimes, threadTimes, (i > 0) ? result.measures[0].throughput : 0.0);
+				result.nbMeasures = i + 1;
+			}
+
+			nbThreads *= 2;
+		}
+
+		delete[] threads;
+		return bRet;
+	}
+
+	bool BenchmarkState::run(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, BenchmarkResult& result, LatencyHistogram* pLatencies)
+	{
+		return runSamples(pSuite, body, pUserData, 0, stats::getBenchmarkTargetTime(), result, pLatencies);
+	}
+
+	bool BenchmarkState::runCold(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, BenchmarkResult& result)
+	{
+		result.nbIterations = 0;
+		result.nbSamples = 0;
+		if (!body)
+			return false;
+
+		const size_t evictionSize = stats::getCacheEvictionSize();
+		unsigned char* evictionBuffer = new(std::nothrow) unsigned char[evictionSize];
+		if (!evictionBuffer)
+			return false;
+
+		//Faults the pages of the buffer in, so that evictions only stream
+		//over it
+		std::memset(evictionBuffer, 0, evictionSize);
+
+		const long long targetTime = stats::getBenchmarkTargetTime();
+		size_t nbSamples = BENCHMARK_MAX_SAMPLES;
+		long long totalThreadTime = 0;
+		size_t bytesPerIteration = 0;
+		size_t itemsPerIteration = 0;
+		bool bRet = true;
+
+		//Sample 0 is the discarded first iteration
+		for (size_t i = 0; i <= nbSamples; ++i)
+		{
+			const long long startTime = s_realTimeChrono.tick();
+
+			BenchmarkState state(1, 0);
+			state.m_evictionBuffer = evictionBuffer;
+			state.m_evictionSize = evictionSize;
+			if (!runBatch(state, pSuite, body, pUserData))
+			{
+				bRet = false;
+				break;
+			}
+
+			if (!i)
+			{
+				//The eviction usually lasts much longer than the iteration,
+				//both are part of the duration of one sample
+				const long long sampleTime = s_realTimeChrono.tick() - startTime;
+				if ((sampleTime > 0) && (targetTime / sampleTime < static_cast<long long>(nbSamples)))
+				{
+					nbSamples = static_cast<size_t>(targetTime / sampleTime);
+					if (nbSamples < stats::MIN_BENCHMARK_SAMPLES)
+						nbSamples = stats::MIN_BENCHMARK_SAMPLES;
+				}
+
+				continue;
+			}
+
+			result.samples[i - 1] = static_cast<double>(state.m_elapsedRealTime);
+			totalThreadTime += state.m_elapsedThreadTime;
+			bytesPerIteration = state.m_bytesPerIteration;
+			itemsPerIteration = state.m_itemsPerIteration;
+		}
+
+		delete[] evictionBuffer;
+		if (!bRet)
+			return false;
+
+		result.nbIterations = 1;
+		result.nbSamples = nbSamples;
+		result.cpuTime = static_cast<double>(totalThreadTime) / nbSamples;
+		stats::computeBenchmarkStats(result, bytesPerIteration, itemsPerIteration);
+		return true;
+	}
+
+	bool BenchmarkState::runAB(TestSuite* pSuite, BenchmarkBody bodyA, const char* nameA, BenchmarkBody bodyB, const char* nameB, const void* pUserData, ABResult& result)
+	{
+		result.nbRounds = 0;
+		result.a.name = nameA;
+		result.b.name = nameB;
+		result.a.nbIterations = result.b.nbIterations = 0;
+		if (!bodyA || !bodyB)
+			return false;
+
+		//Each body gets half of the target time
+		const long long targetTime = stats::getBenchmarkTargetTime();
+		const long long minBatchTime = targetTime / static_cast<long long>(2 * BENCHMARK_MAX_AB_ROUNDS);
+		long long batchTimeA = 0;
+		long long batchTimeB = 0;
+		const size_t nbIterationsA = calibrate(pSuite, bodyA, pUserData, 0, minBatchTime, batchTimeA);
+		const size_t nbIterationsB = nbIterationsA ? calibrate(pSuite, bodyB, pUserData, 0, minBatchTime, batchTimeB) : 0;
+		if (!nbIterationsB)
+			return false;
+
+		//Slow bodies, whose single iterations already last longer than
+		//minBatchTime, get less rounds
+		size_t nbRounds = BENCHMARK_MAX_AB_ROUNDS;
+		const long long roundTime = batchTimeA + batchTimeB;
+		if ((roundTime > 4 * minBatchTime) && (targetTime / roundTime < static_cast<long long>(nbRounds)))
+		{
+			nbRounds = static_cast<size_t>(targetTime / roundTime);
+			if (nbRounds < stats::MIN_BENCHMARK_SAMPLES)
+				nbRounds = stats::MIN_BENCHMARK_SAMPLES;
+		}
+
+		double timesA[BENCHMARK_MAX_AB_ROUNDS];
+		double timesB[BENCHMARK_MAX_AB_ROUNDS];
+		long long threadTimeA = 0;
+		long long threadTimeB = 0;
+		{
+			const CpuPin pin;
+			for (size_t i = 0; i < nbRounds; ++i)
+			{
+				BenchmarkState stateA(nbIterationsA, 0);
+				BenchmarkState stateB(nbIterationsB, 0);
+				const bool bSuccess = (i & 1) ? (runBatch(stateB, pSuite, bodyB, pUserData) && runBatch(stateA, pSuite, bodyA, pUserData))
+											  : (runBatch(stateA, pSuite, bodyA, pUserData) && runBatch(stateB, pSuite, bodyB, pUserData));
+				if (!bSuccess)
+					return false;
+
+				timesA[i] = static_cast<double>(stateA.m_elapsedRealTime) / nbIterationsA;
+				timesB[i] = static_cast<double>(stateB.m_elapsedRealTime) / nbIterationsB;
+				threadTimeA += stateA.m_elapsedThreadTime;
+				threadTimeB += stateB.m_elapsedThreadTime;
+			}
+		}
+
+		result.a.nbIterations = nbIterationsA;
+		result.b.nbIterations = nbIterationsB;
+		result.a.cpuTime = static_cast<double>(threadTimeA) / (static_cast<double>(nbIterationsA) * nbRounds);
+		result.b.cpuTime = static_cast<double>(threadTimeB) / (static_cast<double>(nbIterationsB) * nbRounds);
+		result.nbRounds = nbRounds;
+		stats::computeABStats(result, timesA, timesB);
+		return true;
+	}
+
+	bool BenchmarkState::runRange(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t minRange, size_t maxRange, size_t multiplier, ComplexityResult& result)
+	{
+		result.nbRanges = 0;
+		result.bestFit = Complexity::ANY;
+		result.coefficient = result.cpuCoefficient = result.rms = 0.0;
+		if (!body || !minRange || (maxRange < minRange) || (multiplier < 2))
+			return false;
+
+		//Input sizes grow geometrically from minRange while they are lower
+		//than maxRange, which is always the last one
+		size_t nbRanges = 1;
+		if (maxRange > minRange)
+		{
+			for (size_t range = minRange; (range <= (maxRange - 1) / multiplier) && (nbRanges < BENCHMARK_MAX_RANGES - 1); range *= multiplier)
+				nbRanges++;
+
+			nbRanges++;
+		}
+
+		long long targetTime = stats::getBenchmarkTargetTime() / static_cast<long long>(nbRanges);
+		if (targetTime < MIN_BENCHMARK_TARGET_TIME)
+			targetTime = MIN_BENCHMARK_TARGET_TIME;
+
+		size_t range = minRange;
+		for (size_t i = 0; i < nbRanges; ++i)
+		{
+			//The last range is always maxRange
+			if (i == nbRanges - 1)
+				range = maxRange;
+
+			BenchmarkResult measure;
+			if (!runSamples(pSuite, body, pUserData, range, targetTime, measure, nullptr))
+				return false;
+
+			RangeMeasure& rangeMeasure = result.ranges[i];
+			rangeMeasure.range = range;
+			rangeMeasure.nbIterations = measure.nbIterations;
+			rangeMeasure.nbSamples = measure.nbSamples;
+			rangeMeasure.medianTime = measure.medianTime;
+			rangeMeasure.meanTime = measure.meanTime;
+			rangeMeasure.cpuTime = measure.cpuTime;
+			result.nbRanges = i + 1;
+
+			range *= multiplier;
+		}
+
+		stats::fitComplexity(result);
+		return true;
+	}
+
+	size_t BenchmarkState::calibrate(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t range, long long minSampleTime, long long& sampleTime)
+	{
+		//The number of iterations grows until one batch lasts at least
+		//minSampleTime
+		size_t nbIterations = 1;
+		for (;;)
+		{
+			BenchmarkState state(nbIterations, range);
+			if (!runBatch(state, pSuite, body, pUserData))
+				return 0;
+
+			sampleTime = state.m_elapsedRealTime;
+			if ((sampleTime >= minSampleTime) || (nbIterations >= stats::MAX_BENCHMARK_ITERATIONS))
+				return nbIterations;
+
+			double nextIterations;
+			if (sampleTime <= minSampleTime / 10)
+				nextIterations = nbIterations * 10.0;
+			else
+				nextIterations = nbIterations * 1.2 * minSampleTime / sampleTime;
+
+			if (nextIterations > stats::MAX_BENCHMARK_ITERATIONS)
+				nbIterations = stats::MAX_BENCHMARK_ITERATIONS;
+			else if (nextIterations <= nbIterations)
+				nbIterations++;
+			else
+				nbIterations = static_cast<size_t>(nextIterations);
+		}
+	}
+
+	bool BenchmarkState::runSamples(TestSuite* pSuite, BenchmarkBody body, const void* pUserData, size_t range, long long targetTime, BenchmarkResult& result, LatencyHistogram* pLatencies)
+	{
+		result.nbIterations = 0;
+		result.nbSamples = 0;
+		if (!body)
+			return false;
+
+		const long long minSampleTime = targetTime / stats::DEFAULT_BENCHMARK_SAMPLES;
+		long long sampleTime = 0;
+		const size_t nbIterations = calibrate(pSuite, body, pUserData, range, minSampleTime, sampleTime);
+		if (!nbIterations)
+			return false;
+
+		//Slow bodies, for which a single iteration already lasts much longer
+		//than minSampleTime, are sampled less often so that a benchmark case
+		//lasts about the target time
+		size_t nbSamples = stats::DEFAULT_BENCHMARK_SAMPLES;
+		if (sampleTime > 2 * minSampleTime)
+		{
+			nbSamples = static_cast<size_t>(targetTime / sampleTime);
+			if (nbSamples < stats::MIN_BENCHMARK_SAMPLES)
+				nbSamples = stats::MIN_BENCHMARK_SAMPLES;
+			else if (nbSamples > stats::DEFAULT_BENCHMARK_SAMPLES)
+				nbSamples = stats::DEFAULT_BENCHMARK_SAMPLES;
+		}
+
+		long long totalThreadTime = 0;
+		size_t bytesPerIteration = 0;
+		size_t itemsPerIteration = 0;
+		for (size_t i = 0; i < nbSamples; ++i)
+		{
+			BenchmarkState state(nbIterations, range);
+			state.m_pLatencies = pLatencies;
+			if (!runBatch(state, pSuite, body, pUserData))
+				return false;
+
+			result.samples[i] = static_cast<double>(state.m_elapsedRealTime) / nbIterations;
+			totalThreadTime += state.m_elapsedThreadTime;
+			bytesPerIteration = state.m_bytesPerIteration;
+			itemsPerIteration = state.m_itemsPerIteration;
+		}
+
+		result.nbIterations = nbIterations;
+		result.nbSamples = nbSamples;
+		result.cpuTime = static_cast<double>(totalThreadTime) / (static_cast<double>(nbIterations) * nbSamples);
+		stats::computeBenchmarkStats(result, bytesPerIteration, itemsPerIteration);
+		return true;
+	}
+
+	namespace stats
+	{
+		void setBenchmarkTargetTime(long long targetTime)
+		{
+			s_targetTime = (targetTime < MIN_BENCHMARK_TARGET_TIME) ? MIN_BENCHMARK_TARGET_TIME : targetTime;
+		}
+
+		long long getBenchmarkTargetTime()
+		{
+			return s_targetTime;
+		}
+
+		unsigned int getAffinityCpuCount()
+		{
+#ifdef __linux__
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			if (!sched_getaffinity(0, sizeof(cpuSet), &cpuSet))
+			{
+				const int n = CPU_COUNT(&cpuSet);
+				if (n > 0)
+					return static_cast<unsigned int>(n);
+			}
+
+			const long n = sysconf(_SC_NPROCESSORS_ONLN);
+			return (n > 1) ? static_cast<unsigned int>(n) : 1;
+
+#elif defined(_WIN32)
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+			unsigned int n = 0;
+			if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+			{
+				for (; processMask; processMask &= processMask - 1)
+					n++;
+			}
+
+			return n ? n : 1;
+#endif //__linux__
+		}
+
+		size_t getLastLevelCacheSize()
+		{
+			size_t maxSize = 0;
+
+#ifdef __linux__
+			//One directory per cache of the CPU, instruction caches excluded
+			for (int i = 0; i < 16; ++i)
+			{
+				char path[64];
+				char value[32] = {};
+				std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+				std::FILE* pFile = std::fopen(path, "r");
+				if (!pFile)
+					break;
+
+				const bool bInstruction = std::fgets(value, sizeof(value), pFile) && !std::strncmp(value, "Instruction", 11);
+				std::fclose(pFile);
+				if (bInstruction)
+					continue;
+
+				//Sizes are written as "32K" or "16M"
+				std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+				pFile = std::fopen(path, "r");
+				if (!pFile)
+					continue;
+
+				if (std::fgets(value, sizeof(value), pFile))
+				{
+					char* pEnd = nullptr;
+					size_t size = static_cast<size_t>(std::strtoull(value, &pEnd, 10));
+					if (pEnd && (*pEnd == 'K'))
+						size *= 1024;
+					else if (pEnd && (*pEnd == 'M'))
+						size *= 1024 * 1024;
+
+					if (size > maxSize)
+						maxSize = size;
+				}
+
+				std::fclose(pFile);
+			}
+
+#elif defined(_WIN32)
+			DWORD length = 0;
+			GetLogicalProcessorInformation(nullptr, &length);
+
+			const DWORD nbInfos = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+			SYSTEM_LOGICAL_PROCESSOR_INFORMATION* infos = nbInfos ? new(std::nothrow) SYSTEM_LOGICAL_PROCESSOR_INFORMATION[nbInfos] : nullptr;
+			if (infos && GetLogicalProcessorInformation(infos, &length))
+			{
+				for (DWORD i = 0; i < nbInfos; ++i)
+				{
+					if ((infos[i].Relationship == RelationCache) && (infos[i].Cache.Type != CacheInstruction) && (infos[i].Cache.Size > maxSize))
+						maxSize = infos[i].Cache.Size;
+				}
+			}
+
+			delete[] infos;
+#endif //__linux__
+
+			return maxSize;
+		}
+
+		size_t getCacheEvictionSize()
+		{
+			const size_t cacheSize = getLastLevelCacheSize();
+			if (!cacheSize)
+				return DEFAULT_CACHE_EVICTION_SIZE;
+
+			return (2 * cacheSize > MIN_CACHE_EVICTION_SIZE) ? 2 * cacheSize : MIN_CACHE_EVICTION_SIZE;
+		}
+
+		void evictCaches(unsigned char* buffer, size_t size)
+		{
+			for (size_t i = 0; i < size; i += CACHE_LINE_SIZE)
+				buffer[i]++;
+
+			clobberMemory();
+		}
+
+		void computeScalingMeasure(ScalingMeasure& measure, const size_t* nbIterations, const long long* realTimes, const long long* threadTimes, double singleThroughput)
+		{
+			measure.nbIterations = 0;
+			measure.minThreadIterations = measure.maxThreadIterations = 0;
+			measure.realTime = measure.cpuTime = 0.0;
+			measure.throughput = measure.threadThroughput = 0.0;
+			measure.efficiency = measure.fairness = 0.0;
+			if (!measure.nbThreads)
+				return;
+
+			long long totalThreadTime = 0;
+			for (unsigned int i = 0; i < measure.nbThreads; ++i)
+			{
+				measure.nbIterations += nbIterations[i];
+				if (!i || (nbIterations[i] < measure.minThreadIterations))
+					measure.minThreadIterations = nbIterations[i];
+
+				if (nbIterations[i] > measure.maxThreadIterations)
+					measure.maxThreadIterations = nbIterations[i];
+
+				if (realTimes[i] > measure.realTime)
+					measure.realTime = static_cast<double>(realTimes[i]);
+
+				//Threads may pause their timing, so each one has its own
+				//throughput
+				if (realTimes[i] > 0)
+					measure.throughput += nbIterations[i] * 1000000000.0 / realTimes[i];
+
+				totalThreadTime += threadTimes[i];
+			}
+
+			if (measure.nbIterations)
+				measure.cpuTime = static_cast<double>(totalThreadTime) / measure.nbIterations;
+
+			measure.threadThroughput = measure.throughput / measure.nbThreads;
+
+			if (measure.maxThreadIterations)
+				measure.fairness = static_cast<double>(measure.minThreadIterations) / measure.maxThreadIterations;
+
+			//The single thread measure is its own reference
+			if (singleThroughput <= 0.0)
+				singleThroughput = (measure.nbThreads == 1) ? measure.throughput : 0.0;
+
+			if (singleThroughput > 0.0)
+				measure.efficiency = measure.throughput / (measure.nbThreads * singleThroughput);
+		}
+
+		double computeQuantile(const double* sortedValues, size_t nbValues, double q)
+		{
+			if (!nbValues)
+				return 0.0;
+
+			if (q <= 0.0)
+				return sortedValues[0];
+
+			if (q >= 1.0)
+				return sortedValues[nbValues - 1];
+
+			const double pos = q * (nbValues - 1);
+			const size_t idx = static_cast<size_t>(pos);
+			if (idx + 1 >= nbValues)
+				return sortedValues[nbValues - 1];
+
+			const double frac = pos - idx;
+			return sortedValues[idx] + frac * (sortedValues[idx + 1] - sortedValues[idx]);
+		}
+
+		void computeBenchmarkStats(BenchmarkResult& result, size_t bytesPerIteration, size_t itemsPerIteration)
+		{
+			const size_t n = (result.nbSamples > BENCHMARK_MAX_SAMPLES) ? BENCHMARK_MAX_SAMPLES : result.nbSamples;
+			if (!n)
+			{
+				result.minTime = result.medianTime = result.meanTime = result.madTime = result.maxTime = 0.0;
+				result.bytesPerSecond = result.itemsPerSecond = 0.0;
+				return;
+			}
+
+			double sorted[BENCHMARK_MAX_SAMPLES];
+			double sum = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				sorted[i] = result.samples[i];
+				sum += sorted[i];
+			}
+
+			std::sort(sorted, sorted + n);
+
+			result.minTime = sorted[0];
+			result.medianTime = computeQuantile(sorted, n, 0.5);
+			result.meanTime = sum / n;
+			//With a few samples, higher quantiles would only be
+			//interpolations of the slowest one
+			result.maxTime = sorted[n - 1];
+
+			for (size_t i = 0; i < n; ++i)
+				sorted[i] = std::fabs(sorted[i] - result.medianTime);
+
+			std::sort(sorted, sorted + n);
+			result.madTime = computeQuantile(sorted, n, 0.5);
+
+			if (result.medianTime > 0.0)
+			{
+				result.bytesPerSecond = bytesPerIteration * 1.0e9 / result.medianTime;
+				result.itemsPerSecond = itemsPerIteration * 1.0e9 / result.medianTime;
+			}
+			else
+				result.bytesPerSecond = result.itemsPerSecond = 0.0;
+		}
+
+		void computeABStats(ABResult& result, double* timesA, double* timesB)
+		{
+			const size_t n = (result.nbRounds > BENCHMARK_MAX_AB_ROUNDS) ? BENCHMARK_MAX_AB_ROUNDS : result.nbRounds;
+			result.verdict = ABVerdict::SAME;
+			if (!n)
+			{
+				result.a.medianTime = result.a.meanTime = result.b.medianTime = result.b.meanTime = 0.0;
+				result.ratio = result.lowRatio = result.highRatio = 1.0;
+				return;
+			}
+
+			double ratios[BENCHMARK_MAX_AB_ROUNDS];
+			double sumA = 0.0;
+			double sumB = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				ratios[i] = (timesA[i] > 0.0) ? timesB[i] / timesA[i] : 1.0;
+				sumA += timesA[i];
+				sumB += timesB[i];
+			}
+
+			std::sort(timesA, timesA + n);
+			std::sort(timesB, timesB + n);
+			std::sort(ratios, ratios + n);
+
+			result.a.medianTime = computeQuantile(timesA, n, 0.5);
+			result.a.meanTime = sumA / n;
+			result.b.medianTime = computeQuantile(timesB, n, 0.5);
+			result.b.meanTime = sumB / n;
+			result.ratio = computeQuantile(ratios, n, 0.5);
+
+			//The number of ratios lower than the true median follows a
+			//binomial distribution of parameters n and 0.5, whose normal
+			//approximation gives the ranks bounding the confidence interval
+			size_t k = static_cast<size_t>(std::floor((n - 1.96 * std::sqrt(static_cast<double>(n))) / 2.0));
+			if (k < 1)
+				k = 1;
+
+			result.lowRatio = ratios[k - 1];
+			result.highRatio = ratios[n - k];
+
+			if (result.lowRatio > 1.0)
+				result.verdict = ABVerdict::A_FASTER;
+			else if (result.highRatio < 1.0)
+				result.verdict = ABVerdict::B_FASTER;
+		}
+
+		double evaluateComplexity(Complexity complexity, size_t range)
+		{
+			const double n = static_cast<double>(range);
+			switch (complexity)
+			{
+			case Complexity::O_1:
+				return 1.0;
+
+			case Complexity::O_LOG_N:
+				return std::log2(n);
+
+			case Complexity::O_N:
+				return n;
+
+			case Complexity::O_N_LOG_N:
+				return n * std::log2(n);
+
+			case Complexity::O_N_SQUARED:
+				return n * n;
+
+			default:
+				return 0.0;
+			}
+		}
+
+		double fitComplexityClass(const ComplexityResult& result, Complexity complexity, double& coefficient, double& cpuCoefficient)
+		{
+			coefficient = cpuCoefficient = 0.0;
+
+			const size_t n = (result.nbRanges > BENCHMARK_MAX_RANGES) ? BENCHMARK_MAX_RANGES : result.nbRanges;
+			if (!n || (complexity == Complexity::ANY))
+				return -1.0;
+
+			//Least squares fit of time = coefficient * f(range). Errors are
+			//relative to the measured times: with geometric ranges, absolute
+			//errors would only depend on the largest ones.
+			double sumTimeF = 0.0, sumCpuF = 0.0, sumF2 = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				const double t = result.ranges[i].medianTime;
+				if (t <= 0.0)
+					return -1.0;
+
+				const double f = evaluateComplexity(complexity, result.ranges[i].range) / t;
+				sumTimeF += f;
+				sumCpuF += result.ranges[i].cpuTime * f / t;
+				sumF2 += f * f;
+			}
+
+			if (sumF2 <= 0.0)
+				return -1.0;
+
+			coefficient = sumTimeF / sumF2;
+			cpuCoefficient = sumCpuF / sumF2;
+
+			double sumError2 = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				const double t = result.ranges[i].medianTime;
+				const double error = (t - coefficient * evaluateComplexity(complexity, result.ranges[i].range)) / t;
+				sumError2 += error * error;
+			}
+
+			return std::sqrt(sumError2 / n);
+		}
+
+		void fitComplexity(ComplexityResult& result)
+		{
+			result.bestFit = Complexity::ANY;
+			result.coefficient = result.cpuCoefficient = result.rms = 0.0;
+
+			const size_t n = (result.nbRanges > BENCHMARK_MAX_RANGES) ? BENCHMARK_MAX_RANGES : result.nbRanges;
+			if (n < 2)
+				return;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (result.ranges[i].medianTime <= 0.0)
+					return;
+			}
+
+			//Classes are tried from the lowest to the highest
+			for (int c = 0; c < static_cast<int>(Complexity::ANY); ++c)
+			{
+				const Complexity complexity = static_cast<Complexity>(c);
+
+				double coefficient = 0.0, cpuCoefficient = 0.0;
+				const double rms = fitComplexityClass(result, complexity, coefficient, cpuCoefficient);
+				if (rms < 0.0)
+					continue;
+
+				if ((result.bestFit == Complexity::ANY) || (rms < result.rms - COMPLEXITY_RMS_MARGIN))
+				{
+					result.bestFit = complexity;
+					result.coefficient = coefficient;
+					result.cpuCoefficient = cpuCoefficient;
+					result.rms = rms;
+				}
+			}
+		}
+
+		bool fitsComplexity(const ComplexityResult& result, Complexity expected)
+		{
+			if (expected == Complexity::ANY)
+				return true;
+
+			if (result.bestFit == Complexity::ANY)
+				return false;
+
+			if (result.bestFit <= expected)
+				return true;
+
+			double coefficient = 0.0, cpuCoefficient = 0.0;
+			const double rms = fitComplexityClass(result, expected, coefficient, cpuCoefficient);
+			return (rms >= 0.0) && (rms <= result.rms + COMPLEXITY_CHECK_MARGIN);
+		}
+
+		bool measureLatency(LatencyBody body, const void* pUserData, const LatencyOptions& options, bool bCPUTime, double q, LatencyMeasure& measure)
+		{
+			measure.time = 0.0;
+			measure.nbRuns = 0;
+			measure.nbOutliers = 0;
+
+			const size_t nbRuns = options.nbRuns;
+			if (!body || !nbRuns)
+				return false;
+
+			double* times = new(std::nothrow) double[2 * nbRuns];
+			if (!times)
+				return false;
+
+			for (size_t i = 0; i < options.nbWarmupRuns; ++i)
+				body(pUserData);
+
+			const Chrono& chrono = bCPUTime ? s_threadTimeChrono : s_realTimeChrono;
+			for (size_t i = 0; i < nbRuns; ++i)
+			{
+				const long long start = chrono.tick();
+				body(pUserData);
+				times[i] = static_cast<double>(chrono.tick() - start);
+			}
+
+			std::sort(times, times + nbRuns);
+			size_t nbKept = nbRuns;
+
+			if (options.outlierThreshold > 0.0)
+			{
+				const double median = computeQuantile(times, nbRuns, 0.5);
+				double* deviations = times + nbRuns;
+				for (size_t i = 0; i < nbRuns; ++i)
+					deviations[i] = std::fabs(times[i] - median);
+
+				std::sort(deviations, deviations + nbRuns);
+				const double limit = median + options.outlierThreshold * computeQuantile(deviations, nbRuns, 0.5);
+
+				//Times are sorted, outliers are all at the end
+				while ((nbKept > 1) && (times[nbKept - 1] > limit))
+					nbKept--;
+			}
+
+			measure.time = computeQuantile(times, nbKept, q);
+			measure.nbRuns = nbRuns;
+			measure.nbOutliers = nbRuns - nbKept;
+
+			delete[] times;
+			return true;
+		}
+	}
+}
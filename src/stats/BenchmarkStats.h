@@ -0,0 +1,136 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _BENCHMARKSTATS_H_
+#define _BENCHMARKSTATS_H_
+
+#include <cstddef>
+
+#include "../../include/Benchmark.h"
+
+namespace easyTest
+{
+
+	namespace stats
+	{
+		//Default approximate duration of the measured samples of one
+		//benchmark case, calibration is not included.
+		const long long DEFAULT_BENCHMARK_TARGET_TIME = 100000000; //in ns
+
+		//Number of samples collected when a sample is short enough, long
+		//samples are collected at least MIN_BENCHMARK_SAMPLES times.
+		const size_t DEFAULT_BENCHMARK_SAMPLES = 20;
+		const size_t MIN_BENCHMARK_SAMPLES = 5;
+
+		//Maximum number of iterations of one sample
+		const size_t MAX_BENCHMARK_ITERATIONS = 1000000000;
+
+		//The target time must be set before starting any test suite as it is
+		//not protected against concurrent accesses. Values lower than 1 ms
+		//are clamped to 1 ms.
+		void setBenchmarkTargetTime(long long targetTime); //in ns
+		long long getBenchmarkTargetTime(); //in ns
+
+		//Returns the q quantile (0 <= q <= 1) of nbValues sorted values,
+		//linearly interpolated between the two closest ranks. Returns 0 if
+		//nbValues is 0.
+		double computeQuantile(const double* sortedValues, size_t nbValues, double q);
+
+		//Computes min, median, mean, median absolute deviation and max times,
+		//then throughputs, from the result.nbSamples per-iteration times of
+		//result.samples (which are left in collection order). The CPU time is
+		//not modified.
+		void computeBenchmarkStats(BenchmarkResult& result, size_t bytesPerIteration, size_t itemsPerIteration);
+
+		//Computes the median and mean times of both bodies of an A/B
+		//benchmark case from the result.nbRounds per-iteration times of
+		//timesA and timesB (which are sorted in place), then the median of
+		//their round by round ratios, its 95% confidence interval (from the
+		//ranks of the sign test) and the verdict. The CPU times are not
+		//modified.
+		void computeABStats(ABResult& result, double* timesA, double* timesB);
+
+		//Value of the complexity function of a class for an input size
+		//(log2 for logarithms), 0 for Complexity::ANY.
+		double evaluateComplexity(Complexity complexity, size_t range);
+
+		//A more complex class must lower the relative RMS error by more than
+		//this margin to be chosen as best fit, so that measurement noise does
+		//not make simple bodies look more complex than they are.
+		const double COMPLEXITY_RMS_MARGIN = 0.01;
+
+		//A best fit greater than the expected complexity only fails a range
+		//benchmark case if the expected class has a relative RMS error
+		//higher by more than this margin. Noisy measures (a loaded machine)
+		//cannot tell O(n) from O(n log n) apart, while an O(n log n) body
+		//fitted with O(n) over 256 to 65536 already gives a 24% error.
+		const double COMPLEXITY_CHECK_MARGIN = 0.10;
+
+		//Fits the median times of the result.nbRanges measured ranges with
+		//complexity, and returns its relative RMS error (-1 if it cannot be
+		//fitted, when a median time is 0).
+		double fitComplexityClass(const ComplexityResult& result, Complexity complexity, double& coefficient, double& cpuCoefficient);
+
+		//Fits the median times of the result.nbRanges measured ranges with
+		//each complexity class and sets the best fit, its coefficients and
+		//RMS error. Errors are relative to the measured times so that all
+		//ranges weigh the same. The best fit is Complexity::ANY if less than
+		//2 ranges have been measured or if any median time is 0.
+		//result.expected is not modified.
+		void fitComplexity(ComplexityResult& result);
+
+		//true if the fitted result does not exceed the expected complexity
+		//(see COMPLEXITY_CHECK_MARGIN), always true for Complexity::ANY
+		bool fitsComplexity(const ComplexityResult& result, Complexity expected);
+
+		//Number of CPUs the calling thread may run on: its affinity mask
+		//under Linux, the process one under Windows. Always at least 1.
+		unsigned int getAffinityCpuCount();
+
+		//Size of the buffers streamed over to evict the data caches: twice
+		//the size of the last level cache, at least
+		//MIN_CACHE_EVICTION_SIZE, and DEFAULT_CACHE_EVICTION_SIZE if the
+		//cache size is unknown
+		const size_t MIN_CACHE_EVICTION_SIZE = 8 * 1024 * 1024;
+		const size_t DEFAULT_CACHE_EVICTION_SIZE = 64 * 1024 * 1024;
+		const size_t CACHE_LINE_SIZE = 64;
+
+		//Size in bytes of the largest data or unified cache of the CPU, read
+		//from sysfs under Linux. 0 if unknown.
+		size_t getLastLevelCacheSize();
+		size_t getCacheEvictionSize();
+
+		//Reads and writes one byte of each cache line of buffer, which
+		//replaces the data cache lines of the calling thread CPU if the
+		//buffer is larger than its caches
+		void evictCaches(unsigned char* buffer, size_t size);
+
+		//Computes the totals, throughputs, efficiency and fairness of a
+		//scaling measure from the iterations, real and thread CPU times (in
+		//ns) of its measure.nbThreads threads. The efficiency is relative to
+		//singleThroughput, the throughput of 1 thread, or to the measure
+		//itself if it is not greater than 0 and the measure has 1 thread.
+		void computeScalingMeasure(ScalingMeasure& measure, const size_t* nbIterations, const long long* realTimes, const long long* threadTimes, double singleThroughput);
+
+		struct LatencyMeasure
+		{
+			double time;		//q quantile of the kept runs, in ns
+			size_t nbRuns;		//number of measured runs (warm-up excluded)
+			size_t nbOutliers;	//number of discarded runs
+		};
+
+		//Runs body options.nbWarmupRuns + options.nbRuns times and computes
+		//the q quantile of the real times (or thread CPU times if bCPUTime is
+		//true) of the measured runs, after outliers removal. Returns false if
+		//options.nbRuns is 0 or on memory allocation failure.
+		bool measureLatency(LatencyBody body, const void* pUserData, const LatencyOptions& options, bool bCPUTime, double q, LatencyMeasure& measure);
+	}
+}
+
+#endif //_BENCHMARKSTATS_H_
@@ -15,12 +15,148 @@
 #endif //!CLOCK_MONOTONIC_RAW || !CLOCK_PROCESS_CPUTIME_ID || !CLOCK_THREAD_CPUTIME_ID
 #endif //__linux__
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TSC_SUPPORTED
+#ifdef _MSC_VER //Visual C++ compiler
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif //_MSC_VER
+#endif //x86 CPUs
+
+namespace
+{
+	easyTest::stats::RealTimeClock s_realTimeClock = easyTest::stats::RealTimeClock::OS;
+
+#ifdef TSC_SUPPORTED
+	//Duration of the TSC calibration against the OS clock, in ns
+	const long long TSC_CALIBRATION_TIME = 20000000;
+
+	double s_tscPeriod = 0.0; //in ns
+
+	inline unsigned long long readTsc()
+	{
+		return __rdtsc();
+	}
+
+	//Reads the OS real-time clock, in ns
+	long long readOsClock()
+	{
+#ifdef __linux__
+		timespec now = {};
+		if (clock_gettime(CLOCK_MONOTONIC_RAW, &now))
+			return -1;
+
+		return now.tv_sec * 1000000000LL + now.tv_nsec;
+
+#elif defined(_WIN32)
+		LARGE_INTEGER freq, counter;
+		if (!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&counter) || (freq.QuadPart <= 0))
+			return -1;
+
+		return static_cast<long long>(static_cast<double>(counter.QuadPart) * 1.0e9 / freq.QuadPart);
+#endif //__linux__
+	}
+
+	//The TSC is read right before and after the OS clock, so that the
+	//OS clock cost is evenly shared
+	bool sampleClocks(long long& osTime, unsigned long long& tsc)
+	{
+		const unsigned long long before = readTsc();
+		osTime = readOsClock();
+		const unsigned long long after = readTsc();
+
+		tsc = before + (after - before) / 2;
+		return osTime >= 0;
+	}
+
+	//Returns the TSC period in ns, 0 on failure
+	double calibrateTsc()
+	{
+		long long startTime, endTime;
+		unsigned long long startTsc, endTsc;
+		if (!sampleClocks(startTime, startTsc))
+			return 0.0;
+
+		do
+		{
+			if (!sampleClocks(endTime, endTsc))
+				return 0.0;
+		} while (endTime - startTime < TSC_CALIBRATION_TIME);
+
+		if (endTsc <= startTsc)
+			return 0.0;
+
+		return static_cast<double>(endTime - startTime) / static_cast<double>(endTsc - startTsc);
+	}
+#endif //TSC_SUPPORTED
+}
+
 namespace easyTest
 {
 	namespace stats
 	{
-		Chrono::Chrono(Type type)
+		bool isTscClockAvailable()
 		{
+#ifdef TSC_SUPPORTED
+			//Invariant TSC flag: CPUID.80000007H:EDX[8]
+#ifdef _MSC_VER //Visual C++ compiler
+			int regs[4] = {};
+			__cpuid(regs, 0x80000000);
+			if (static_cast<unsigned int>(regs[0]) < 0x80000007)
+				return false;
+
+			__cpuid(regs, 0x80000007);
+			return (regs[3] & 0x100) != 0;
+#else
+			unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+			if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+				return false;
+
+			return (edx & 0x100) != 0;
+#endif //_MSC_VER
+
+#else //TSC_SUPPORTED not defined
+			return false;
+#endif //TSC_SUPPORTED
+		}
+
+		bool setRealTimeClock(RealTimeClock clock)
+		{
+			if (clock == RealTimeClock::TSC)
+			{
+#ifdef TSC_SUPPORTED
+				if (s_tscPeriod <= 0.0)
+				{
+					if (!isTscClockAvailable())
+						return false;
+
+					s_tscPeriod = calibrateTsc();
+					if (s_tscPeriod <= 0.0)
+						return false;
+				}
+#else //TSC_SUPPORTED not defined
+				return false;
+#endif //TSC_SUPPORTED
+			}
+
+			s_realTimeClock = clock;
+			return true;
+		}
+
+		RealTimeClock getRealTimeClock()
+		{
+			return s_realTimeClock;
+		}
+
+		Chrono::Chrono(Type type) : m_type(type)
+		{
+#ifdef TSC_SUPPORTED
+			if (m_type == Type::REAL_TIME)
+				m_tscTimestamp = readTsc();
+#endif //TSC_SUPPORTED
+
 #ifdef __linux__
 			switch (type)
 			{
@@ -56,8 +192,6 @@ namespace easyTest
 			m_timestamp = now.tv_sec * 1000000000 + now.tv_nsec;
 
 #elif defined(_WIN32)
-			m_type = type;
-
 			switch (m_type)
 			{
 			case Type::REAL_TIME:
@@ -104,6 +238,11 @@ namespace easyTest
 
 		long long Chrono::tick() const
 		{
+#ifdef TSC_SUPPORTED
+			if ((m_type == Type::REAL_TIME) && (s_realTimeClock == RealTimeClock::TSC))
+				return static_cast<long long>(static_cast<double>(readTsc() - m_tscTimestamp) * s_tscPeriod);
+#endif //TSC_SUPPORTED
+
 #ifdef __linux__
 			if (m_clockId >= 0)
 			{
@@ -24,6 +24,25 @@ namespace easyTest
 {
 	namespace stats
 	{
+		enum struct RealTimeClock : unsigned char
+		{
+			OS,		//CLOCK_MONOTONIC_RAW under Linux, QueryPerformanceCounter under Windows
+			TSC		//Invariant time-stamp counter of x86 CPUs, calibrated against the OS clock
+		};
+
+		//true if the CPU has an invariant TSC (constant rate in all power
+		//states), which is then synchronized between all cores
+		bool isTscClockAvailable();
+
+		//Selects the clock used by all REAL_TIME chronos. Reading the TSC
+		//costs a few ns where the OS clock may cost tens of ns, but the TSC
+		//must first be calibrated against the OS clock, which takes about
+		//20 ms. Returns false and keeps the current clock if the TSC is not
+		//available. The clock must be selected before starting any measure
+		//as it is not protected against concurrent accesses.
+		bool setRealTimeClock(RealTimeClock clock);
+		RealTimeClock getRealTimeClock();
+
 		class Chrono final
 		{
 		public:
@@ -46,14 +65,16 @@ namespace easyTest
 			Chrono(const Chrono&) = delete;
 			Chrono& operator=(const Chrono&) = delete;
 
+			Type m_type = Type::REAL_TIME;
+
 #ifdef __linux__
 			clockid_t m_clockId = 0;
 #elif defined(_WIN32)
-			Type m_type = Type::REAL_TIME;
 			LARGE_INTEGER m_counterFreq = {};
 #endif //__linux
 
 			long long m_timestamp = 0;
+			unsigned long long m_tscTimestamp = 0; //REAL_TIME only
 		};
 	}
 }
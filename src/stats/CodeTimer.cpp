@@ -46,5 +46,29 @@ namespace easyTest
 				m_bRunning = false;
 			}
 		}
+
+		bool CodeTimer::setElapsedTimes(long long realTime, long long processTime, long long threadTime)
+		{
+			if (m_bRunning)
+				return false;
+
+			m_timestamp[0] = (realTime > 0) ? realTime : 0;
+			m_timestamp[1] = (processTime > 0) ? processTime : 0;
+			m_timestamp[2] = (threadTime > 0) ? threadTime : 0;
+			return true;
+		}
+
+		void CodeTimer::subtract(const CodeTimer& timer)
+		{
+			if (!m_bRunning && !timer.m_bRunning)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					m_timestamp[i] -= timer.m_timestamp[i];
+					if (m_timestamp[i] < 0)
+						m_timestamp[i] = 0;
+				}
+			}
+		}
 	}
 }
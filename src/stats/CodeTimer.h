@@ -42,6 +42,14 @@ namespace easyTest
 				return m_bRunning ? 0 : m_timestamp[2];
 			}
 
+			//Sets the elapsed times of a stopped timer, negative times are
+			//set to 0. Returns false if the timer is running.
+			bool setElapsedTimes(long long realTime, long long processTime, long long threadTime);
+
+			//Subtracts the elapsed times of another stopped timer, times
+			//never go below 0. Does nothing if any timer is running.
+			void subtract(const CodeTimer& timer);
+
 		private:
 			CodeTimer(const CodeTimer&) = delete;
 			CodeTimer& operator=(const CodeTimer&) = delete;
@@ -0,0 +1,194 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "IoUsage.h"
+
+#ifdef __linux__
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif //__linux__
+
+namespace
+{
+	bool s_bEnabled = false;
+	long long s_maxIoPerCase = 0;
+
+#ifdef __linux__
+	//Same order as the IoCounter enum
+	const char* const COUNTER_NAMES[] = {"rchar", "wchar", "syscr", "syscw", "read_bytes", "write_bytes"};
+
+	int openThreadIoFile()
+	{
+		int fd = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			//Linux kernels older than 3.17 have no /proc/thread-self
+			char path[64];
+			std::snprintf(path, sizeof(path), "/proc/self/task/%ld/io", static_cast<long>(syscall(SYS_gettid)));
+			fd = open(path, O_RDONLY | O_CLOEXEC);
+		}
+
+		return fd;
+	}
+#endif //__linux__
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		void setIoAccountingEnabled(bool bEnabled)
+		{
+			s_bEnabled = bEnabled;
+		}
+
+		bool isIoAccountingEnabled()
+		{
+			return s_bEnabled;
+		}
+
+		void setMaxIoPerCase(long long maxBytes)
+		{
+			s_maxIoPerCase = (maxBytes > 0) ? maxBytes : 0;
+		}
+
+		long long getMaxIoPerCase()
+		{
+			return s_maxIoPerCase;
+		}
+
+		IoUsage::IoUsage()
+		{
+			for (int i = 0; i < NB_COUNTERS; ++i)
+				m_values[i] = -1;
+
+#ifdef __linux__
+			m_fd = openThreadIoFile();
+#endif //__linux__
+		}
+
+		IoUsage::~IoUsage()
+		{
+#ifdef __linux__
+			if (m_fd >= 0)
+				close(m_fd);
+#endif //__linux__
+		}
+
+		bool IoUsage::isAvailable() const
+		{
+#ifdef __linux__
+			return (m_fd >= 0);
+#else
+			return false;
+#endif //__linux__
+		}
+
+		bool IoUsage::start()
+		{
+			if (m_bRunning)
+				return false;
+
+			m_startSampleSize = sample(m_values);
+			m_bRunning = true;
+			return true;
+		}
+
+		//Reading the accounting file is itself a read system call, the one
+		//done by start() is removed from the deltas
+		void IoUsage::stop()
+		{
+			if (m_bRunning)
+			{
+				long long values[NB_COUNTERS];
+				sample(values);
+
+				for (int i = 0; i < NB_COUNTERS; ++i)
+				{
+					if ((values[i] < 0) || (m_values[i] < 0))
+						m_values[i] = -1;
+					else
+						m_values[i] = (values[i] > m_values[i]) ? values[i] - m_values[i] : 0;
+				}
+
+				if (m_values[static_cast<int>(IoCounter::READ_SYSCALLS)] > 0)
+					m_values[static_cast<int>(IoCounter::READ_SYSCALLS)]--;
+
+				if (m_values[static_cast<int>(IoCounter::READ_CHARS)] > 0)
+				{
+					m_values[static_cast<int>(IoCounter::READ_CHARS)] -= m_startSampleSize;
+					if (m_values[static_cast<int>(IoCounter::READ_CHARS)] < 0)
+						m_values[static_cast<int>(IoCounter::READ_CHARS)] = 0;
+				}
+
+				m_bRunning = false;
+			}
+		}
+
+		long long IoUsage::getTotalChars() const
+		{
+			const long long nbRead = getValue(IoCounter::READ_CHARS);
+			const long long nbWritten = getValue(IoCounter::WRITTEN_CHARS);
+			if ((nbRead < 0) || (nbWritten < 0))
+				return -1;
+
+			return nbRead + nbWritten;
+		}
+
+		long long IoUsage::sample(long long values[NB_COUNTERS]) const
+		{
+			for (int i = 0; i < NB_COUNTERS; ++i)
+				values[i] = -1;
+
+#ifdef __linux__
+			if (m_fd < 0)
+				return 0;
+
+			char buffer[512];
+			const ssize_t size = pread(m_fd, buffer, sizeof(buffer) - 1, 0);
+			if (size <= 0)
+				return 0;
+
+			buffer[size] = '\0';
+
+			//One "name: value" pair per line
+			for (const char* pLine = buffer; *pLine;)
+			{
+				const char* pSeparator = std::strchr(pLine, ':');
+				if (!pSeparator)
+					break;
+
+				for (int i = 0; i < NB_COUNTERS; ++i)
+				{
+					const size_t nameLength = std::strlen(COUNTER_NAMES[i]);
+					if ((static_cast<size_t>(pSeparator - pLine) == nameLength) && !std::strncmp(pLine, COUNTER_NAMES[i], nameLength))
+					{
+						values[i] = std::strtoll(pSeparator + 1, nullptr, 10);
+						break;
+					}
+				}
+
+				pLine = std::strchr(pSeparator, '\n');
+				if (!pLine)
+					break;
+
+				pLine++;
+			}
+
+			return size;
+#else
+			return 0;
+#endif //__linux__
+		}
+	}
+}
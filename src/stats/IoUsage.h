@@ -0,0 +1,94 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _IOUSAGE_H_
+#define _IOUSAGE_H_
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Same fields and order as /proc/<pid>/task/<tid>/io
+		enum struct IoCounter : unsigned char
+		{
+			READ_CHARS,			//bytes read through read-like system calls (page cache included)
+			WRITTEN_CHARS,		//bytes written through write-like system calls
+			READ_SYSCALLS,
+			WRITE_SYSCALLS,
+			READ_BYTES,			//bytes actually fetched from the storage layer
+			WRITTEN_BYTES,		//bytes actually sent to the storage layer
+			COUNT
+		};
+
+		//I/O accounting is disabled by default as it costs two reads of a
+		//procfs file per test case. It must be enabled before starting the
+		//runner.
+		void setIoAccountingEnabled(bool bEnabled);
+		bool isIoAccountingEnabled();
+
+		//Maximum number of bytes read and written (READ_CHARS +
+		//WRITTEN_CHARS) by one test case, 0 (default) for no limit. A test
+		//case exceeding it fails. Setting a limit does not enable I/O
+		//accounting.
+		void setMaxIoPerCase(long long maxBytes);
+		long long getMaxIoPerCase();
+
+		//Counts the I/O of the calling thread between start() and stop().
+		//The thread accounting file is opened by the constructor, so an
+		//instance must be created and used by the same thread.
+		//I/O accounting is only supported under Linux (kernel built with
+		//task I/O accounting), otherwise all values are -1.
+		class IoUsage final
+		{
+		public:
+			IoUsage();
+			~IoUsage();
+
+			bool start();
+			void stop();
+
+			bool isRunning() const
+			{
+				return m_bRunning;
+			}
+
+			//false if the thread accounting file cannot be read
+			bool isAvailable() const;
+
+			//-1 if the counter is unavailable
+			long long getValue(IoCounter counter) const
+			{
+				return m_bRunning ? -1 : m_values[static_cast<int>(counter)];
+			}
+
+			//READ_CHARS + WRITTEN_CHARS, -1 if unavailable
+			long long getTotalChars() const;
+
+		private:
+			IoUsage(const IoUsage&) = delete;
+			IoUsage& operator=(const IoUsage&) = delete;
+
+			static const int NB_COUNTERS = static_cast<int>(IoCounter::COUNT);
+
+			//Fills values with the current totals of the thread and returns
+			//the number of bytes read from the accounting file
+			long long sample(long long values[NB_COUNTERS]) const;
+
+			bool m_bRunning = false;
+			long long m_values[NB_COUNTERS];
+			long long m_startSampleSize = 0;
+
+#ifdef __linux__
+			int m_fd = -1;
+#endif //__linux__
+		};
+	}
+}
+
+#endif //_IOUSAGE_H_
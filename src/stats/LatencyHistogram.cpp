@@ -0,0 +1,322 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../../include/LatencyHistogram.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+	//Appends a formatted field to a serialized histogram, keeping track of
+	//the full length like snprintf()
+	void appendField(char* buffer, size_t bufferSize, size_t& length, const char* format, long long value)
+	{
+		char field[32];
+		const int n = std::snprintf(field, sizeof(field), format, value);
+		if (n <= 0)
+			return;
+
+		for (int i = 0; i < n; ++i, ++length)
+		{
+			if (length + 1 < bufferSize)
+				buffer[length] = field[i];
+		}
+	}
+
+	//Parses an unsigned integer followed by separator, returns nullptr if
+	//the string does not match
+	const char* parseField(const char* str, char separator, unsigned long long& value)
+	{
+		if ((*str < '0') || (*str > '9'))
+			return nullptr;
+
+		char* pEnd = nullptr;
+		value = std::strtoull(str, &pEnd, 10);
+		return (*pEnd == separator) ? pEnd + 1 : nullptr;
+	}
+}
+
+namespace easyTest
+{
+	LatencyHistogram::LatencyHistogram(int precision, long long maxValue)
+	{
+		initLayout(precision, maxValue);
+	}
+
+	LatencyHistogram::~LatencyHistogram()
+	{
+		delete[] m_counts;
+	}
+
+	void LatencyHistogram::reset()
+	{
+		if (m_counts && m_totalCount)
+			std::memset(m_counts, 0, m_nbCounts * sizeof(size_t));
+
+		m_totalCount = 0;
+		m_sum = 0.0;
+		m_min = m_maxValue;
+		m_max = 0;
+	}
+
+	void LatencyHistogram::setPrecision(int precision)
+	{
+		if (precision < LATENCY_HISTOGRAM_MIN_PRECISION)
+			precision = LATENCY_HISTOGRAM_MIN_PRECISION;
+		else if (precision > LATENCY_HISTOGRAM_MAX_PRECISION)
+			precision = LATENCY_HISTOGRAM_MAX_PRECISION;
+
+		if (precision != m_precision)
+			initLayout(precision, m_maxValue);
+	}
+
+	long long LatencyHistogram::getValueAtPercentile(double percentile) const
+	{
+		if (!m_totalCount)
+			return 0;
+
+		if (percentile < 0.0)
+			percentile = 0.0;
+		else if (percentile > 100.0)
+			percentile = 100.0;
+
+		size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * m_totalCount));
+		if (rank < 1)
+			rank = 1;
+		else if (rank > m_totalCount)
+			rank = m_totalCount;
+
+		size_t count = 0;
+		for (size_t i = 0; i < m_nbCounts; ++i)
+		{
+			count += m_counts[i];
+			if (count >= rank)
+			{
+				const long long value = getLowestValue(i) + getBucketWidth(i) - 1;
+				return (value < m_max) ? value : m_max;
+			}
+		}
+
+		return m_max;
+	}
+
+	bool LatencyHistogram::merge(const LatencyHistogram& other)
+	{
+		if (!other.m_totalCount)
+			return true;
+
+		if (!m_counts && !allocateCounts())
+			return false;
+
+		if ((other.m_precision == m_precision) && (other.m_maxValue == m_maxValue))
+		{
+			for (size_t i = 0; i < m_nbCounts; ++i)
+				m_counts[i] += other.m_counts[i];
+		}
+		else
+		{
+			for (size_t i = 0; i < other.m_nbCounts; ++i)
+			{
+				if (other.m_counts[i])
+				{
+					long long value = other.getLowestValue(i) + other.getBucketWidth(i) / 2;
+					if (value > m_maxValue)
+						value = m_maxValue;
+
+					m_counts[getIndex(value)] += other.m_counts[i];
+				}
+			}
+		}
+
+		m_totalCount += other.m_totalCount;
+		m_sum += other.m_sum;
+
+		const long long otherMin = (other.m_min < m_maxValue) ? other.m_min : m_maxValue;
+		const long long otherMax = (other.m_max < m_maxValue) ? other.m_max : m_maxValue;
+		if (otherMin < m_min)
+			m_min = otherMin;
+
+		if (otherMax > m_max)
+			m_max = otherMax;
+
+		return true;
+	}
+
+	//Format: "precision/maxValue/totalCount/min/max/sum/" followed by the
+	//non-empty sub-buckets as comma separated "gap:count" pairs, the gap
+	//being the number of empty sub-buckets before each one
+	size_t LatencyHistogram::serialize(char* buffer, size_t bufferSize) const
+	{
+		size_t length = 0;
+		appendField(buffer, bufferSize, length, "%lld/", m_precision);
+		appendField(buffer, bufferSize, length, "%lld/", m_maxValue);
+		appendField(buffer, bufferSize, length, "%lld/", static_cast<long long>(m_totalCount));
+		appendField(buffer, bufferSize, length, "%lld/", getMin());
+		appendField(buffer, bufferSize, length, "%lld/", m_max);
+		appendField(buffer, bufferSize, length, "%lld/", std::llround(m_sum));
+
+		if (m_totalCount)
+		{
+			size_t nextIdx = 0;
+			for (size_t i = 0; i < m_nbCounts; ++i)
+			{
+				if (m_counts[i])
+				{
+					appendField(buffer, bufferSize, length, nextIdx ? ",%lld:" : "%lld:", static_cast<long long>(i - nextIdx));
+					appendField(buffer, bufferSize, length, "%lld", static_cast<long long>(m_counts[i]));
+					nextIdx = i + 1;
+				}
+			}
+		}
+
+		if (bufferSize)
+			buffer[(length < bufferSize) ? length : bufferSize - 1] = '\0';
+
+		return length;
+	}
+
+	bool LatencyHistogram::deserialize(const char* str)
+	{
+		unsigned long long header[6] = {};
+		const char* pNext = str;
+		for (int i = 0; pNext && (i < 6); ++i)
+			pNext = parseField(pNext, '/', header[i]);
+
+		if (!pNext || (header[0] < static_cast<unsigned long long>(LATENCY_HISTOGRAM_MIN_PRECISION)) || (header[0] > static_cast<unsigned long long>(LATENCY_HISTOGRAM_MAX_PRECISION))
+			|| !header[1] || (header[1] > 0x7FFFFFFFFFFFFFFFULL) || (header[3] > header[4]) || (header[4] > header[1]))
+			return false;
+
+		if ((static_cast<int>(header[0]) != m_precision) || (static_cast<long long>(header[1]) != m_maxValue))
+			initLayout(static_cast<int>(header[0]), static_cast<long long>(header[1]));
+		else
+			reset();
+
+		if (!header[2])
+			return !*pNext;
+
+		if (!m_counts && !allocateCounts())
+			return false;
+
+		size_t nextIdx = 0;
+		size_t totalCount = 0;
+		while (*pNext)
+		{
+			unsigned long long gap = 0;
+			unsigned long long count = 0;
+			pNext = parseField(pNext, ':', gap);
+			if (pNext && (gap < m_nbCounts - nextIdx))
+			{
+				char* pEnd = nullptr;
+				count = std::strtoull(pNext, &pEnd, 10);
+				pNext = ((pEnd != pNext) && ((*pEnd == ',') || !*pEnd)) ? pEnd : nullptr;
+			}
+			else
+				pNext = nullptr;
+
+			if (!pNext || !count)
+			{
+				reset();
+				return false;
+			}
+
+			nextIdx += static_cast<size_t>(gap);
+			m_counts[nextIdx++] = static_cast<size_t>(count);
+			totalCount += static_cast<size_t>(count);
+
+			if (*pNext == ',')
+				pNext++;
+		}
+
+		m_totalCount = totalCount;
+		if (totalCount != header[2])
+		{
+			reset();
+			return false;
+		}
+
+		m_min = static_cast<long long>(header[3]);
+		m_max = static_cast<long long>(header[4]);
+		m_sum = static_cast<double>(header[5]);
+		return true;
+	}
+
+	long long LatencyHistogram::getLowestValue(size_t index) const
+	{
+		const size_t subBucketHalfCount = static_cast<size_t>(1) << m_subBucketHalfCountMagnitude;
+		int bucketIdx = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+		size_t subBucketIdx = (index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+		if (bucketIdx < 0)
+		{
+			subBucketIdx -= subBucketHalfCount;
+			bucketIdx = 0;
+		}
+
+		return static_cast<long long>(subBucketIdx) << bucketIdx;
+	}
+
+	long long LatencyHistogram::getBucketWidth(size_t index) const
+	{
+		const int bucketIdx = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+		return (bucketIdx > 0) ? (1LL << bucketIdx) : 1;
+	}
+
+	void LatencyHistogram::initLayout(int precision, long long maxValue)
+	{
+		if (precision < LATENCY_HISTOGRAM_MIN_PRECISION)
+			precision = LATENCY_HISTOGRAM_MIN_PRECISION;
+		else if (precision > LATENCY_HISTOGRAM_MAX_PRECISION)
+			precision = LATENCY_HISTOGRAM_MAX_PRECISION;
+
+		m_precision = precision;
+		m_maxValue = (maxValue > 1) ? maxValue : 1;
+
+		//Sub-buckets of bucket 0 are 1 wide, 2 * 10^precision of them keep
+		//precision significant digits in all buckets
+		long long largestSingleUnitValue = 2;
+		for (int i = 0; i < precision; ++i)
+			largestSingleUnitValue *= 10;
+
+		int subBucketCountMagnitude = 1;
+		while ((1LL << subBucketCountMagnitude) < largestSingleUnitValue)
+			subBucketCountMagnitude++;
+
+		m_subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+		m_subBucketMask = (1ULL << subBucketCountMagnitude) - 1;
+
+		//Each next bucket doubles the range of trackable values
+		unsigned long long smallestUntrackableValue = 1ULL << subBucketCountMagnitude;
+		size_t nbBuckets = 1;
+		while (smallestUntrackableValue <= static_cast<unsigned long long>(m_maxValue))
+		{
+			smallestUntrackableValue <<= 1;
+			nbBuckets++;
+		}
+
+		m_nbCounts = (nbBuckets + 1) << m_subBucketHalfCountMagnitude;
+
+		delete[] m_counts;
+		m_counts = nullptr;
+		m_totalCount = 0;
+		reset();
+	}
+
+	bool LatencyHistogram::allocateCounts()
+	{
+		m_counts = new(std::nothrow) size_t[m_nbCounts];
+		if (!m_counts)
+			return false;
+
+		std::memset(m_counts, 0, m_nbCounts * sizeof(size_t));
+		return true;
+	}
+}
@@ -0,0 +1,198 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif //__linux__
+
+namespace
+{
+	bool s_bEnabled = false;
+
+#ifdef __linux__
+	struct CounterDesc
+	{
+		uint32_t type;
+		uint64_t config;
+	};
+
+	//Same order as the PerfCounter enum
+	const CounterDesc COUNTER_DESCS[] =
+	{
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+		{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}
+	};
+
+	//Counts the calling thread on any CPU, kernel and hypervisor events are
+	//excluded so that counters can be opened with the default
+	//perf_event_paranoid setting
+	int openCounter(const CounterDesc& desc, int groupFd)
+	{
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = desc.type;
+		attr.config = desc.config;
+		attr.disabled = (groupFd < 0) ? 1 : 0; //group members follow their leader
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+	}
+
+	//Returns -1 if the counter has never been scheduled
+	long long readCounter(int fd)
+	{
+		uint64_t values[3] = {}; //value, time enabled, time running
+		if (read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || !values[2])
+			return -1;
+
+		//Counter multiplexed with other events: its value is extrapolated
+		if (values[2] < values[1])
+			return static_cast<long long>(static_cast<double>(values[0]) * values[1] / values[2]);
+
+		return static_cast<long long>(values[0]);
+	}
+#endif //__linux__
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		void setPerfCountersEnabled(bool bEnabled)
+		{
+			s_bEnabled = bEnabled;
+		}
+
+		bool arePerfCountersEnabled()
+		{
+			return s_bEnabled;
+		}
+
+		PerfCounters::PerfCounters()
+		{
+			for (int i = 0; i < NB_COUNTERS; ++i)
+				m_values[i] = -1;
+
+#ifdef __linux__
+			//Hardware counters are opened as a single group so that they are
+			//always scheduled together and their ratios (IPC) stay
+			//meaningful, the first counter successfully opened is the group
+			//leader
+			for (int i = 0; i < NB_COUNTERS; ++i)
+			{
+				if (COUNTER_DESCS[i].type == PERF_TYPE_HARDWARE)
+				{
+					m_fd[i] = openCounter(COUNTER_DESCS[i], m_groupFd);
+					if ((m_fd[i] >= 0) && (m_groupFd < 0))
+						m_groupFd = m_fd[i];
+				}
+				else
+					m_fd[i] = openCounter(COUNTER_DESCS[i], -1);
+			}
+#endif //__linux__
+		}
+
+		PerfCounters::~PerfCounters()
+		{
+#ifdef __linux__
+			//Group members must be closed before their leader
+			for (int i = NB_COUNTERS - 1; i >= 0; --i)
+			{
+				if ((m_fd[i] >= 0) && (m_fd[i] != m_groupFd))
+					close(m_fd[i]);
+			}
+
+			if (m_groupFd >= 0)
+				close(m_groupFd);
+#endif //__linux__
+		}
+
+		bool PerfCounters::isAvailable() const
+		{
+#ifdef __linux__
+			for (int i = 0; i < NB_COUNTERS; ++i)
+			{
+				if (m_fd[i] >= 0)
+					return true;
+			}
+#endif //__linux__
+
+			return false;
+		}
+
+		bool PerfCounters::start()
+		{
+			if (m_bRunning)
+				return false;
+
+#ifdef __linux__
+			for (int i = 0; i < NB_COUNTERS; ++i)
+			{
+				if ((m_fd[i] >= 0) && (m_fd[i] == m_groupFd))
+				{
+					ioctl(m_fd[i], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+					ioctl(m_fd[i], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+				}
+				else if ((m_fd[i] >= 0) && (COUNTER_DESCS[i].type != PERF_TYPE_HARDWARE))
+				{
+					ioctl(m_fd[i], PERF_EVENT_IOC_RESET, 0);
+					ioctl(m_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif //__linux__
+
+			m_bRunning = true;
+			return true;
+		}
+
+		void PerfCounters::stop()
+		{
+			if (m_bRunning)
+			{
+#ifdef __linux__
+				for (int i = 0; i < NB_COUNTERS; ++i)
+				{
+					if ((m_fd[i] >= 0) && (m_fd[i] == m_groupFd))
+						ioctl(m_fd[i], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+					else if ((m_fd[i] >= 0) && (COUNTER_DESCS[i].type != PERF_TYPE_HARDWARE))
+						ioctl(m_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+				}
+
+				for (int i = 0; i < NB_COUNTERS; ++i)
+					m_values[i] = (m_fd[i] >= 0) ? readCounter(m_fd[i]) : -1;
+#endif //__linux__
+
+				m_bRunning = false;
+			}
+		}
+
+		double PerfCounters::getIPC() const
+		{
+			const long long nbCycles = getValue(PerfCounter::CYCLES);
+			const long long nbInstructions = getValue(PerfCounter::INSTRUCTIONS);
+			if ((nbCycles <= 0) || (nbInstructions < 0))
+				return -1.0;
+
+			return static_cast<double>(nbInstructions) / nbCycles;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _PERFCOUNTERS_H_
+#define _PERFCOUNTERS_H_
+
+namespace easyTest
+{
+	namespace stats
+	{
+		enum struct PerfCounter : unsigned char
+		{
+			CYCLES,
+			INSTRUCTIONS,
+			CACHE_MISSES,
+			BRANCH_MISSES,
+			PAGE_FAULTS,
+			COUNT
+		};
+
+		//Hardware performance counters are disabled by default as opening
+		//them costs a few system calls per worker-thread. They must be
+		//enabled before starting the runner.
+		void setPerfCountersEnabled(bool bEnabled);
+		bool arePerfCountersEnabled();
+
+		//Counts the events of the calling thread only (user space), between
+		//start() and stop(). Counters are opened by the constructor, so an
+		//instance must be created and used by the same thread.
+		//Counters are only supported under Linux, through perf_event_open.
+		//Counters which cannot be opened (no PMU, perf_event_paranoid
+		//restrictions, other platforms) are unavailable: their value is -1.
+		//Values of multiplexed counters are scaled to the whole measure.
+		class PerfCounters final
+		{
+		public:
+			PerfCounters();
+			~PerfCounters();
+
+			bool start();
+			void stop();
+
+			bool isRunning() const
+			{
+				return m_bRunning;
+			}
+
+			//false if no counter can be opened
+			bool isAvailable() const;
+
+			//-1 if the counter is unavailable
+			long long getValue(PerfCounter counter) const
+			{
+				return m_bRunning ? -1 : m_values[static_cast<int>(counter)];
+			}
+
+			//Instructions per cycle, negative if unavailable
+			double getIPC() const;
+
+		private:
+			PerfCounters(const PerfCounters&) = delete;
+			PerfCounters& operator=(const PerfCounters&) = delete;
+
+			static const int NB_COUNTERS = static_cast<int>(PerfCounter::COUNT);
+
+			bool m_bRunning = false;
+			long long m_values[NB_COUNTERS];
+
+#ifdef __linux__
+			int m_fd[NB_COUNTERS];
+			int m_groupFd = -1; //leader of the hardware counters group
+#endif //__linux__
+		};
+	}
+}
+
+#endif //_PERFCOUNTERS_H_
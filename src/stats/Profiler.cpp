@@ -0,0 +1,451 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "Profiler.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <csignal>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+//Older versions of the GNU C library do not define this sigevent field
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif //sigev_notify_thread_id
+#endif //__linux__
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Unique stacks sampled by one thread, all frames of all stacks are
+		//stored in the same array
+		struct ProfileData
+		{
+			struct Stack
+			{
+				const char* testSuiteName;
+				const char* testCaseName;
+				size_t count;
+				size_t hash;
+				size_t firstFrame;
+				int depth;	//-1 for the samples lost when the ring was full
+			};
+
+			Stack* stacks = nullptr;
+			size_t nbStacks = 0;
+			size_t stacksCapacity = 0;
+
+			void** frames = nullptr;
+			size_t nbFrames = 0;
+			size_t framesCapacity = 0;
+
+			ProfileData* pNext = nullptr;
+
+			~ProfileData()
+			{
+				delete[] stacks;
+				delete[] frames;
+			}
+		};
+	}
+}
+
+namespace
+{
+	using easyTest::stats::ProfileData;
+	using easyTest::stats::ThreadProfiler;
+
+	bool s_bEnabled = false;
+
+	//Profiles of the destroyed ThreadProfiler instances
+	std::atomic<ProfileData*> s_pProfiles(nullptr);
+
+#ifdef __linux__
+	thread_local ThreadProfiler* s_pThreadProfiler = nullptr;
+
+	size_t hashFrames(void* const* frames, int depth)
+	{
+		//FNV-1a on the frame addresses
+		size_t hash = static_cast<size_t>(14695981039346656037ULL);
+		for (int i = 0; i < depth; ++i)
+		{
+			hash ^= reinterpret_cast<size_t>(frames[i]);
+			hash *= static_cast<size_t>(1099511628211ULL);
+		}
+
+		return hash;
+	}
+
+	//Counts one more sample of a stack, looking for an existing stack from
+	//firstStack, returns false if the stack cannot be allocated
+	bool addStack(ProfileData& data, size_t firstStack, const char* testSuiteName, const char* testCaseName, void* const* frames, int depth, size_t count)
+	{
+		const size_t hash = hashFrames(frames, depth);
+		for (size_t i = firstStack; i < data.nbStacks; ++i)
+		{
+			ProfileData::Stack& stack = data.stacks[i];
+			if ((stack.hash == hash) && (stack.depth == depth) && ((depth <= 0) || !std::memcmp(data.frames + stack.firstFrame, frames, depth * sizeof(void*))))
+			{
+				stack.count += count;
+				return true;
+			}
+		}
+
+		if (data.nbStacks == data.stacksCapacity)
+		{
+			const size_t capacity = data.stacksCapacity ? 2 * data.stacksCapacity : 64;
+			ProfileData::Stack* stacks = new(std::nothrow) ProfileData::Stack[capacity];
+			if (!stacks)
+				return false;
+
+			if (data.stacks)
+			{
+				std::memcpy(stacks, data.stacks, data.nbStacks * sizeof(ProfileData::Stack));
+				delete[] data.stacks;
+			}
+
+			data.stacks = stacks;
+			data.stacksCapacity = capacity;
+		}
+
+		const size_t nbFrames = (depth > 0) ? static_cast<size_t>(depth) : 0;
+		if (data.nbFrames + nbFrames > data.framesCapacity)
+		{
+			size_t capacity = data.framesCapacity ? 2 * data.framesCapacity : 1024;
+			while (capacity < data.nbFrames + nbFrames)
+				capacity *= 2;
+
+			void** allFrames = new(std::nothrow) void*[capacity];
+			if (!allFrames)
+				return false;
+
+			if (data.frames)
+			{
+				std::memcpy(allFrames, data.frames, data.nbFrames * sizeof(void*));
+				delete[] data.frames;
+			}
+
+			data.frames = allFrames;
+			data.framesCapacity = capacity;
+		}
+
+		ProfileData::Stack& stack = data.stacks[data.nbStacks++];
+		stack.testSuiteName = testSuiteName;
+		stack.testCaseName = testCaseName;
+		stack.count = count;
+		stack.hash = hash;
+		stack.firstFrame = data.nbFrames;
+		stack.depth = depth;
+
+		if (nbFrames)
+			std::memcpy(data.frames + data.nbFrames, frames, nbFrames * sizeof(void*));
+
+		data.nbFrames += nbFrames;
+		return true;
+	}
+
+	struct sigaction s_defaultSignalHandler = {};
+
+	//Symbols are formatted by backtrace_symbols() as
+	//"module(function+offset) [address]", or "module(+offset) [address]"
+	//for the functions which are not in the dynamic symbol table
+	void writeFrame(std::FILE* pFile, const char* symbol)
+	{
+		const char* pOpen = std::strchr(symbol, '(');
+		const char* pPlus = pOpen ? std::strchr(pOpen, '+') : nullptr;
+		const char* pClose = pOpen ? std::strchr(pOpen, ')') : nullptr;
+		if (!pPlus || (pClose && (pClose < pPlus)))
+			pPlus = pClose;
+
+		if (pOpen && pPlus && (pPlus > pOpen + 1))
+		{
+			char name[512];
+			size_t nameLen = static_cast<size_t>(pPlus - pOpen - 1);
+			if (nameLen >= sizeof(name))
+				nameLen = sizeof(name) - 1;
+
+			std::memcpy(name, pOpen + 1, nameLen);
+			name[nameLen] = '\0';
+
+			int status = 0;
+			char* demangledName = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+			std::fputs(demangledName ? demangledName : name, pFile);
+			std::free(demangledName);
+			return;
+		}
+
+		//Unknown function, written as the module base name and the offset
+		const char* pModuleEnd = pOpen ? pOpen : std::strchr(symbol, ' ');
+		if (!pModuleEnd)
+			pModuleEnd = symbol + std::strlen(symbol);
+
+		const char* pModule = symbol;
+		for (const char* p = symbol; p < pModuleEnd; ++p)
+		{
+			if (*p == '/')
+				pModule = p + 1;
+		}
+
+		std::fwrite(pModule, 1, static_cast<size_t>(pModuleEnd - pModule), pFile);
+		if (pOpen && pClose && (pClose > pOpen + 1))
+			std::fwrite(pOpen + 1, 1, static_cast<size_t>(pClose - pOpen - 1), pFile);
+	}
+#endif //__linux__
+
+	//Writes the stacks of pFirst and of all the profiles chained to it
+	bool writeProfiles(const char* path, const ProfileData* pFirst)
+	{
+		if (!path)
+			return false;
+
+		std::FILE* pFile = std::fopen(path, "w");
+		if (!pFile)
+			return false;
+
+		for (const ProfileData* pData = pFirst; pData; pData = pData->pNext)
+		{
+			for (size_t i = 0; i < pData->nbStacks; ++i)
+			{
+				const ProfileData::Stack& stack = pData->stacks[i];
+				std::fprintf(pFile, "%s::%s", stack.testSuiteName, stack.testCaseName);
+
+				if (stack.depth < 0)
+					std::fputs(";[lost samples]", pFile);
+#ifdef __linux__
+				else
+				{
+					//Frames are sampled from the innermost one
+					void* const* frames = pData->frames + stack.firstFrame;
+					char** symbols = backtrace_symbols(frames, stack.depth);
+					for (int j = stack.depth - 1; j >= 0; --j)
+					{
+						std::fputc(';', pFile);
+						if (symbols)
+							writeFrame(pFile, symbols[j]);
+						else
+							std::fprintf(pFile, "%p", frames[j]);
+					}
+
+					std::free(symbols);
+				}
+#endif //__linux__
+
+				std::fprintf(pFile, " %zu\n", stack.count);
+			}
+		}
+
+		const bool bWritten = !std::ferror(pFile);
+		return (std::fclose(pFile) == 0) && bWritten;
+	}
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		bool setProfilingEnabled(bool bEnabled)
+		{
+#ifdef __linux__
+			if (bEnabled == s_bEnabled)
+				return true;
+
+			if (bEnabled)
+			{
+				//backtrace() loads the unwinder of libgcc on its first call,
+				//which is not safe in a signal handler
+				void* frame = nullptr;
+				backtrace(&frame, 1);
+
+				struct sigaction signalHandler = {};
+				signalHandler.sa_handler = &ThreadProfiler::onSignal;
+				signalHandler.sa_flags = SA_RESTART;
+				sigemptyset(&signalHandler.sa_mask);
+				if (sigaction(SIGPROF, &signalHandler, &s_defaultSignalHandler))
+					return false;
+			}
+			else
+				sigaction(SIGPROF, &s_defaultSignalHandler, nullptr);
+
+			s_bEnabled = bEnabled;
+			return true;
+#else
+			return !bEnabled;
+#endif //__linux__
+		}
+
+		bool isProfilingEnabled()
+		{
+			return s_bEnabled;
+		}
+
+		ThreadProfiler::ThreadProfiler(bool bLocal) : m_nbSamples(0), m_bSampling(false), m_bLocal(bLocal)
+		{
+#ifdef __linux__
+			if (s_pThreadProfiler)
+				return;
+
+			m_samples = new(std::nothrow) Sample[PROFILE_RING_SIZE];
+			m_pData = new(std::nothrow) ProfileData();
+			if (!m_samples || !m_pData)
+				return;
+
+			struct sigevent event = {};
+			event.sigev_notify = SIGEV_THREAD_ID;
+			event.sigev_signo = SIGPROF;
+			event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+			if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &m_timer))
+				return;
+
+			m_bHasTimer = true;
+			s_pThreadProfiler = this;
+#endif //__linux__
+		}
+
+		ThreadProfiler::~ThreadProfiler()
+		{
+#ifdef __linux__
+			if (m_bHasTimer)
+			{
+				timer_delete(m_timer);
+				s_pThreadProfiler = nullptr;
+			}
+#endif //__linux__
+
+			delete[] m_samples;
+
+			if (m_pData && m_pData->nbStacks && !m_bLocal)
+			{
+				m_pData->pNext = s_pProfiles.load(std::memory_order_relaxed);
+				while (!s_pProfiles.compare_exchange_weak(m_pData->pNext, m_pData, std::memory_order_release, std::memory_order_relaxed));
+			}
+			else
+				delete m_pData;
+		}
+
+		bool ThreadProfiler::writeProfile(const char* path) const
+		{
+			//The data of an instance is only chained to the process-wide
+			//profile when the instance is destroyed
+			return writeProfiles(path, m_pData);
+		}
+
+		bool ThreadProfiler::isAvailable() const
+		{
+#ifdef __linux__
+			return m_bHasTimer;
+#else
+			return false;
+#endif //__linux__
+		}
+
+		bool ThreadProfiler::startCase()
+		{
+#ifdef __linux__
+			if (!m_bHasTimer || m_bSampling.load(std::memory_order_relaxed))
+				return false;
+
+			//All samples share the frames of the caller of startCase() and
+			//above (the worker thread function), they are removed from the
+			//profile
+			void* frames[SKIPPED_FRAMES + PROFILE_MAX_FRAMES];
+			const int depth = backtrace(frames, SKIPPED_FRAMES + PROFILE_MAX_FRAMES);
+			m_baseDepth = ((depth > 1) && (depth < SKIPPED_FRAMES + PROFILE_MAX_FRAMES)) ? depth - 1 : 0;
+
+			m_nbSamples.store(0, std::memory_order_relaxed);
+			m_bSampling.store(true, std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+
+			struct itimerspec period = {};
+			period.it_interval.tv_nsec = PROFILE_SAMPLING_PERIOD_NS;
+			period.it_value.tv_nsec = PROFILE_SAMPLING_PERIOD_NS;
+			if (timer_settime(m_timer, 0, &period, nullptr))
+			{
+				m_bSampling.store(false, std::memory_order_relaxed);
+				return false;
+			}
+
+			return true;
+#else
+			return false;
+#endif //__linux__
+		}
+
+		void ThreadProfiler::stopCase(const char* testSuiteName, const char* testCaseName)
+		{
+#ifdef __linux__
+			if (!m_bSampling.load(std::memory_order_relaxed))
+				return;
+
+			m_bSampling.store(false, std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+
+			struct itimerspec period = {};
+			timer_settime(m_timer, 0, &period, nullptr);
+
+			const size_t nbSamples = m_nbSamples.load(std::memory_order_relaxed);
+			const size_t nbKeptSamples = (nbSamples < PROFILE_RING_SIZE) ? nbSamples : PROFILE_RING_SIZE;
+			size_t nbLostSamples = nbSamples - nbKeptSamples;
+
+			const size_t firstStack = m_pData->nbStacks;
+			for (size_t i = 0; i < nbKeptSamples; ++i)
+			{
+				const Sample& sample = m_samples[i];
+				int depth = sample.depth - SKIPPED_FRAMES;
+
+				//Truncated stacks do not include the worker thread frames
+				if ((sample.depth < SKIPPED_FRAMES + PROFILE_MAX_FRAMES) && (depth > m_baseDepth))
+					depth -= m_baseDepth;
+
+				if ((depth <= 0) || !addStack(*m_pData, firstStack, testSuiteName, testCaseName, sample.frames + SKIPPED_FRAMES, depth, 1))
+					nbLostSamples++;
+			}
+
+			if (nbLostSamples)
+				addStack(*m_pData, firstStack, testSuiteName, testCaseName, nullptr, -1, nbLostSamples);
+#else
+			(void)testSuiteName;
+			(void)testCaseName;
+#endif //__linux__
+		}
+
+		//Only async-signal-safe operations here: backtrace() is safe once
+		//it has been called outside of the handler
+		void ThreadProfiler::onSignal(int)
+		{
+#ifdef __linux__
+			ThreadProfiler* pProfiler = s_pThreadProfiler;
+			if (!pProfiler || !pProfiler->m_bSampling.load(std::memory_order_relaxed))
+				return;
+
+			const size_t idx = pProfiler->m_nbSamples.fetch_add(1, std::memory_order_relaxed);
+			if (idx < PROFILE_RING_SIZE)
+			{
+				const int savedErrno = errno;
+				Sample& sample = pProfiler->m_samples[idx];
+				sample.depth = backtrace(sample.frames, SKIPPED_FRAMES + PROFILE_MAX_FRAMES);
+				errno = savedErrno;
+			}
+#endif //__linux__
+		}
+
+		bool writeProfile(const char* path)
+		{
+			return writeProfiles(path, s_pProfiles.load(std::memory_order_acquire));
+		}
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <atomic>
+#include <cstddef>
+
+#ifdef __linux__
+#include <ctime>
+#endif //__linux__
+
+namespace easyTest
+{
+	namespace stats
+	{
+		//Sampling period of the profiler, in CPU time of the sampled thread
+		const long PROFILE_SAMPLING_PERIOD_NS = 1000000; //1 ms
+
+		//Maximum number of samples kept for one test case (about 4 s of CPU
+		//time), further samples are counted as lost
+		const size_t PROFILE_RING_SIZE = 4096;
+
+		//Maximum number of frames kept for one sample, deeper stacks are
+		//truncated to their innermost frames
+		const int PROFILE_MAX_FRAMES = 32;
+
+		struct ProfileData;
+
+		//The profiler is disabled by default. Enabling it installs the
+		//process-wide SIGPROF handler, so it must be enabled before starting
+		//the runner. Returns false if the profiler is not available (it is
+		//only supported under Linux).
+		bool setProfilingEnabled(bool bEnabled);
+		bool isProfilingEnabled();
+
+		//Writes the stacks sampled by all the destroyed ThreadProfiler
+		//instances to path, in the folded stacks format of flame graph
+		//tools: one "suite::case;outer;...;inner count" line per unique
+		//stack. Function names are read from the dynamic symbol table, so
+		//the executable must be linked with -rdynamic, other frames are
+		//written as "module+offset". Returns false if the file cannot be
+		//written.
+		bool writeProfile(const char* path);
+
+		//Samples the call stacks of the calling thread while it executes
+		//test cases, between startCase() and stopCase(). A CPU time timer of
+		//the thread sends it a SIGPROF signal every
+		//PROFILE_SAMPLING_PERIOD_NS, whose handler only copies the call stack
+		//into a preallocated ring of samples. The samples are gathered into
+		//unique stacks when the test case stops, and handed over to the
+		//process-wide profile when the instance is destroyed.
+		//
+		//The timer and the ring belong to the thread which creates the
+		//instance, so an instance must be created and used by the same
+		//thread, and only one instance may exist per thread.
+		//
+		//A local instance keeps its stacks instead: they are only written by
+		//its own writeProfile() and are dropped with the instance.
+		class ThreadProfiler final
+		{
+		public:
+			ThreadProfiler(bool bLocal = false);
+			~ThreadProfiler();
+
+			//false if the ring or the thread timer cannot be created
+			bool isAvailable() const;
+
+			bool startCase();
+
+			//Names must outlive the profile: test suites and test cases
+			//names are static strings
+			void stopCase(const char* testSuiteName, const char* testCaseName);
+
+			//Writes the stacks sampled by this instance only, in the same
+			//format as the free writeProfile() function
+			bool writeProfile(const char* path) const;
+
+		private:
+			ThreadProfiler(const ThreadProfiler&) = delete;
+			ThreadProfiler& operator=(const ThreadProfiler&) = delete;
+
+			//The first frames of a sample are the signal handler and the
+			//signal trampoline
+			static const int SKIPPED_FRAMES = 2;
+
+			struct Sample
+			{
+				int depth;
+				void* frames[SKIPPED_FRAMES + PROFILE_MAX_FRAMES];
+			};
+
+			friend bool setProfilingEnabled(bool bEnabled);
+
+			//SIGPROF handler, only copies the call stack of the interrupted
+			//thread
+			static void onSignal(int signal);
+
+			Sample* m_samples = nullptr;
+			std::atomic<size_t> m_nbSamples;
+			std::atomic<bool> m_bSampling;
+			int m_baseDepth = 0;
+			const bool m_bLocal;
+
+#ifdef __linux__
+			timer_t m_timer = {};
+			bool m_bHasTimer = false;
+#endif //__linux__
+
+			//Unique stacks of the profiled test cases
+			ProfileData* m_pData = nullptr;
+		};
+	}
+}
+
+#endif //_PROFILER_H_
@@ -0,0 +1,103 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "ResourceUsage.h"
+
+#ifdef __linux__
+#include <sys/time.h>
+#include <sys/resource.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif //__linux__
+
+namespace
+{
+#ifdef __linux__
+	inline long long toNs(const struct timeval& t)
+	{
+		return static_cast<long long>(t.tv_sec) * 1000000000LL + static_cast<long long>(t.tv_usec) * 1000LL;
+	}
+#elif defined(_WIN32)
+	inline long long toNs(const FILETIME& t)
+	{
+		ULARGE_INTEGER value;
+		value.LowPart = t.dwLowDateTime;
+		value.HighPart = t.dwHighDateTime;
+		return static_cast<long long>(value.QuadPart) * 100LL;
+	}
+#endif //__linux__
+}
+
+namespace easyTest
+{
+	namespace stats
+	{
+		ResourceUsage::ResourceUsage()
+		{
+			for (int i = 0; i < NB_COUNTERS; ++i)
+				m_values[i] = -1;
+		}
+
+		bool ResourceUsage::start()
+		{
+			if (m_bRunning)
+				return false;
+
+			sample(m_values);
+			m_bRunning = true;
+			return true;
+		}
+
+		void ResourceUsage::stop()
+		{
+			if (m_bRunning)
+			{
+				long long values[NB_COUNTERS];
+				sample(values);
+
+				for (int i = 0; i < NB_COUNTERS; ++i)
+				{
+					if ((values[i] < 0) || (m_values[i] < 0))
+						m_values[i] = -1;
+					else
+						m_values[i] = (values[i] > m_values[i]) ? values[i] - m_values[i] : 0;
+				}
+
+				m_bRunning = false;
+			}
+		}
+
+		void ResourceUsage::sample(long long values[NB_COUNTERS])
+		{
+			for (int i = 0; i < NB_COUNTERS; ++i)
+				values[i] = -1;
+
+#ifdef __linux__
+			struct rusage usage;
+			if (!getrusage(RUSAGE_THREAD, &usage))
+			{
+				values[static_cast<int>(ResourceCounter::USER_TIME)] = toNs(usage.ru_utime);
+				values[static_cast<int>(ResourceCounter::SYSTEM_TIME)] = toNs(usage.ru_stime);
+				values[static_cast<int>(ResourceCounter::MINOR_FAULTS)] = usage.ru_minflt;
+				values[static_cast<int>(ResourceCounter::MAJOR_FAULTS)] = usage.ru_majflt;
+				values[static_cast<int>(ResourceCounter::VOLUNTARY_SWITCHES)] = usage.ru_nvcsw;
+				values[static_cast<int>(ResourceCounter::INVOLUNTARY_SWITCHES)] = usage.ru_nivcsw;
+			}
+#elif defined(_WIN32)
+			FILETIME creationTime, exitTime, kernelTime, userTime;
+			if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+			{
+				values[static_cast<int>(ResourceCounter::USER_TIME)] = toNs(userTime);
+				values[static_cast<int>(ResourceCounter::SYSTEM_TIME)] = toNs(kernelTime);
+			}
+#endif //__linux__
+		}
+	}
+}
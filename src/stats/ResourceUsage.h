@@ -0,0 +1,67 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _RESOURCEUSAGE_H_
+#define _RESOURCEUSAGE_H_
+
+namespace easyTest
+{
+	namespace stats
+	{
+		enum struct ResourceCounter : unsigned char
+		{
+			USER_TIME,			//in ns
+			SYSTEM_TIME,		//in ns
+			MINOR_FAULTS,
+			MAJOR_FAULTS,
+			VOLUNTARY_SWITCHES,
+			INVOLUNTARY_SWITCHES,
+			COUNT
+		};
+
+		//Operating system resources used by the calling thread between
+		//start() and stop(), which must be called by the same thread.
+		//Under Linux, all values come from getrusage(RUSAGE_THREAD). Under
+		//Windows, only user and system times are available (GetThreadTimes),
+		//page faults and context switches are not counted per thread.
+		class ResourceUsage final
+		{
+		public:
+			ResourceUsage();
+
+			bool start();
+			void stop();
+
+			bool isRunning() const
+			{
+				return m_bRunning;
+			}
+
+			//-1 if the value is unavailable
+			long long getValue(ResourceCounter counter) const
+			{
+				return m_bRunning ? -1 : m_values[static_cast<int>(counter)];
+			}
+
+		private:
+			ResourceUsage(const ResourceUsage&) = delete;
+			ResourceUsage& operator=(const ResourceUsage&) = delete;
+
+			static const int NB_COUNTERS = static_cast<int>(ResourceCounter::COUNT);
+
+			//Fills values with the current totals of the calling thread
+			static void sample(long long values[NB_COUNTERS]);
+
+			bool m_bRunning = false;
+			long long m_values[NB_COUNTERS];
+		};
+	}
+}
+
+#endif //_RESOURCEUSAGE_H_
@@ -0,0 +1,37 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../../include/TimedScope.h"
+
+#include "Chrono.h"
+
+namespace
+{
+	const easyTest::stats::Chrono s_realTimeChrono(easyTest::stats::Chrono::Type::REAL_TIME);
+	const easyTest::stats::Chrono s_threadTimeChrono(easyTest::stats::Chrono::Type::THREAD_TIME);
+}
+
+namespace easyTest
+{
+	void TimedScope::start()
+	{
+		m_startThreadTime = s_threadTimeChrono.tick();
+		m_startRealTime = s_realTimeChrono.tick();
+	}
+
+	void TimedScope::stop()
+	{
+		const long long realTime = s_realTimeChrono.tick() - m_startRealTime;
+		const long long threadTime = s_threadTimeChrono.tick() - m_startThreadTime;
+
+		m_pTiming->nbCalls++;
+		m_pTiming->realTime += (realTime > 0) ? realTime : 0;
+		m_pTiming->threadTime += (threadTime > 0) ? threadTime : 0;
+	}
+}
@@ -87,6 +87,8 @@ TEST_SUITE(Asserts)
 	TEST_CASE(assertAlmostEqual);
 	TEST_CASE(assertVeryDifferent);
 
+	TEST_CASE(expectSuccess);
+
 private:
 	const bool bTrue = true;
 	const bool bFalse = false;
@@ -304,3 +306,29 @@ TEST_IMPL(Asserts, assertVeryDifferent)
 	ASSERT_TRUE(!areVeryDifferent(fa, fd, bigEpsilon, "fa", "fd", SRC_INFO()));
 	return true;
 }
+
+TEST_IMPL(Asserts, expectSuccess)
+{
+	//All expectations are met, the test case must succeed although it does
+	//not check anything itself.
+	EXPECT_TRUE(bTrue);
+	EXPECT_FALSE(bFalse);
+	EXPECT_NAN(dNaN);
+	EXPECT_INFINITE(dNegInfinity);
+	EXPECT_FINITE(dUnity);
+	EXPECT_LESS_THAN(ia, ic);
+	EXPECT_LESS_OR_EQUAL(ia, ib);
+	EXPECT_GREATER_THAN(oc, oa);
+	EXPECT_GREATER_OR_EQUAL(oa, ob);
+	EXPECT_EQUAL(fa, fb);
+	EXPECT_DIFFERENT(fa, fc);
+	EXPECT_STRING_EQUAL("abc", "abc");
+	EXPECT_STRING_DIFFERENT("abc", "abd");
+	EXPECT_ALMOST_EQUAL(fa, fd, bigEpsilon);
+	EXPECT_VERY_DIFFERENT(fa, fc, bigEpsilon);
+	EXPECT_BITWISE_EQUAL(ia, ib);
+	EXPECT_BITWISE_DIFFERENT(ia, ic);
+	EXPECT_SAME_DATA(&ia, &ib, sizeof(int));
+	EXPECT_DIFFERENT_DATA(&ia, &ic, sizeof(int));
+	return true;
+}
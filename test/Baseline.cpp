@@ -0,0 +1,88 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../include/easyTest.h"
+#include "../src/stats/Baseline.h"
+#include "TempFile.h"
+
+#include <cstdio>
+
+TEST_SUITE(Baseline)
+{
+	TEST_CASE(baselineComparison);
+	TEST_CASE(baselineFile);
+};
+
+TEST_IMPL(Baseline, baselineComparison)
+{
+	using namespace easyTest::stats;
+
+	const double low[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+	const double high[] = {6.0, 7.0, 8.0, 9.0, 10.0};
+	ASSERT_ALMOST_EQUAL(mannWhitneyPValue(low, 5, high, 5), 0.01219, 1e-4);
+	ASSERT_ALMOST_EQUAL(mannWhitneyPValue(high, 5, low, 5), 0.01219, 1e-4);
+	ASSERT_ALMOST_EQUAL(mannWhitneyPValue(low, 5, low, 5), 1.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(mannWhitneyPValue(low, 0, high, 5), 1.0, 1e-9);
+
+	easyTest::BaselineComparison comparison = {};
+	compareWithBaseline(comparison, low, 5, high, 5, DEFAULT_BASELINE_ALPHA, DEFAULT_BASELINE_MIN_EFFECT);
+	ASSERT_TRUE(comparison.verdict == easyTest::BaselineVerdict::REGRESSION);
+	ASSERT_ALMOST_EQUAL(comparison.baselineMedian, 3.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(comparison.median, 8.0, 1e-9);
+
+	compareWithBaseline(comparison, high, 5, low, 5, DEFAULT_BASELINE_ALPHA, DEFAULT_BASELINE_MIN_EFFECT);
+	ASSERT_TRUE(comparison.verdict == easyTest::BaselineVerdict::IMPROVEMENT);
+
+	//Significant but smaller than the minimum effect
+	compareWithBaseline(comparison, low, 5, high, 5, DEFAULT_BASELINE_ALPHA, 5.0);
+	ASSERT_TRUE(comparison.verdict == easyTest::BaselineVerdict::UNCHANGED);
+
+	compareWithBaseline(comparison, low, 5, high, 5, 0.01, DEFAULT_BASELINE_MIN_EFFECT);
+	ASSERT_TRUE(comparison.verdict == easyTest::BaselineVerdict::UNCHANGED);
+
+	compareWithBaseline(comparison, low, 2, high, 5, DEFAULT_BASELINE_ALPHA, DEFAULT_BASELINE_MIN_EFFECT);
+	ASSERT_TRUE(comparison.verdict == easyTest::BaselineVerdict::NOT_ENOUGH_SAMPLES);
+	return true;
+}
+
+TEST_IMPL(Baseline, baselineFile)
+{
+	using namespace easyTest::stats;
+
+	const test::TempFile baselineFile("Baseline.etb");
+	const char* const baselinePath = baselineFile.getPath();
+	ASSERT_TRUE(baselinePath != nullptr);
+
+	const double samples[] = {1.5, 2.5, 3.5};
+
+	BaselineData data;
+	ASSERT_TRUE(data.addSamples("Suite", "caseA", samples, 3));
+	ASSERT_TRUE(data.addSamples("Suite", "caseB", samples, 1));
+	ASSERT_TRUE(data.addSamples("Suite", "caseA", samples, 2));
+	ASSERT_TRUE(data.addMetricSample("Suite", "caseA", "ratio", 0.75));
+	ASSERT_EQUAL(data.getNbTests(), size_t(3));
+	ASSERT_FALSE(BaselineData::isMetric(data.getTestName(0)));
+	ASSERT_TRUE(BaselineData::isMetric(data.getTestName(2)));
+	ASSERT_TRUE(data.save(baselinePath));
+
+	BaselineData loaded;
+	ASSERT_TRUE(loaded.load(baselinePath));
+	std::remove(baselinePath);
+
+	const double* pSamples = nullptr;
+	ASSERT_EQUAL(loaded.getNbTests(), size_t(3));
+	ASSERT_EQUAL(loaded.getSamples("Suite::caseA", pSamples), size_t(5));
+	ASSERT_ALMOST_EQUAL(pSamples[4], 2.5, 1e-12);
+	ASSERT_EQUAL(loaded.getSamples("Suite::caseB", pSamples), size_t(1));
+	ASSERT_EQUAL(loaded.getSamples("Suite::caseA@ratio", pSamples), size_t(1));
+	ASSERT_ALMOST_EQUAL(pSamples[0], 0.75, 1e-12);
+	ASSERT_EQUAL(loaded.getSamples("Suite::caseC", pSamples), size_t(0));
+	ASSERT_FALSE(loaded.load(baselinePath));
+	return true;
+}
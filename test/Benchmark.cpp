@@ -0,0 +1,723 @@
+﻿/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../include/easyTest.h"
+#include "../src/stats/BenchmarkStats.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace
+{
+	bool skipLoopBody(easyTest::TestSuite*, const void*, easyTest::BenchmarkState& state)
+	{
+		//Runs only a part of the iterations
+		return state.keepRunning();
+	}
+
+	bool failingBody(easyTest::TestSuite*, const void*, easyTest::BenchmarkState& state)
+	{
+		while (state.keepRunning());
+		return false;
+	}
+
+	//Counts the calls of a cold cache benchmark body, each of which must
+	//run a single iteration
+	struct ColdRecorder
+	{
+		size_t nbCalls;
+		size_t nbBadCalls;
+
+		static bool run(easyTest::TestSuite*, const void* pUserData, easyTest::BenchmarkState& state)
+		{
+			ColdRecorder* pRecorder = const_cast<ColdRecorder*>(static_cast<const ColdRecorder*>(pUserData));
+			pRecorder->nbCalls++;
+			if (state.getNbIterations() != 1)
+				pRecorder->nbBadCalls++;
+
+			while (state.keepRunning());
+			return true;
+		}
+	};
+
+	//Larger than the first level caches, smaller than most last level ones
+	int s_coldValues[64 * 1024];
+
+	//Records the successive input sizes given to a range benchmark body
+	struct RangeRecorder
+	{
+		size_t nbRanges;
+		size_t ranges[easyTest::BENCHMARK_MAX_RANGES];
+
+		static bool run(easyTest::TestSuite*, const void* pUserData, easyTest::BenchmarkState& state)
+		{
+			RangeRecorder* pRecorder = const_cast<RangeRecorder*>(static_cast<const RangeRecorder*>(pUserData));
+			const size_t range = state.getRange();
+			if (!pRecorder->nbRanges || (pRecorder->ranges[pRecorder->nbRanges - 1] != range))
+				pRecorder->ranges[pRecorder->nbRanges++] = range;
+
+			while (state.keepRunning());
+			return true;
+		}
+	};
+
+	//Fills result with nbRanges ranges multiplied by 2 from 16, their times
+	//being coefficient * f(range)
+	void fillComplexity(easyTest::ComplexityResult& result, size_t nbRanges, easyTest::Complexity complexity, double coefficient)
+	{
+		result.nbRanges = nbRanges;
+		for (size_t i = 0; i < nbRanges; ++i)
+		{
+			result.ranges[i].range = size_t(16) << i;
+			result.ranges[i].medianTime = coefficient * easyTest::stats::evaluateComplexity(complexity, result.ranges[i].range);
+			result.ranges[i].cpuTime = result.ranges[i].medianTime / 2.0;
+		}
+	}
+
+	//Records the thread indexes given to a scaling benchmark body, failing
+	//in thread failingThreadIdx before running its loop
+	struct ScalingRecorder
+	{
+		std::atomic_uint maxThreadIdx;
+		std::atomic_uint nbBadThreadCounts;
+		unsigned int failingThreadIdx;
+
+		static bool run(easyTest::TestSuite*, const void* pUserData, easyTest::BenchmarkState& state)
+		{
+			ScalingRecorder* pRecorder = const_cast<ScalingRecorder*>(static_cast<const ScalingRecorder*>(pUserData));
+			const unsigned int threadIdx = state.getThreadIdx();
+			if (threadIdx >= state.getNbThreads())
+				pRecorder->nbBadThreadCounts++;
+
+			unsigned int maxThreadIdx = pRecorder->maxThreadIdx.load();
+			while ((threadIdx > maxThreadIdx) && !pRecorder->maxThreadIdx.compare_exchange_weak(maxThreadIdx, threadIdx));
+
+			if (threadIdx == pRecorder->failingThreadIdx)
+				return false;
+
+			while (state.keepRunning());
+			return true;
+		}
+	};
+
+	struct CountingBody
+	{
+		size_t nbCalls;
+		size_t slowPeriod;
+
+		static void run(const void* pUserData)
+		{
+			CountingBody* pBody = const_cast<CountingBody*>(static_cast<const CountingBody*>(pUserData));
+			size_t nbLoops = 10;
+			if (pBody->slowPeriod && !(++pBody->nbCalls % pBody->slowPeriod))
+				nbLoops = 2000000;
+			else if (!pBody->slowPeriod)
+				pBody->nbCalls++;
+
+			size_t sum = 0;
+			for (size_t i = 0; i < nbLoops; ++i)
+			{
+				sum += i;
+				easyTest::doNotOptimize(sum);
+			}
+		}
+	};
+}
+
+TEST_SUITE(Benchmark)
+{
+	TEST_CASE(computeStats);
+	TEST_CASE(incompleteLoops);
+	TEST_CASE(latencyMeasure);
+	TEST_CASE(latencyBudget);
+	TEST_CASE(complexityFit);
+	TEST_CASE(benchmarkRanges);
+	TEST_CASE(scalingMeasure);
+	TEST_CASE(benchmarkScaling);
+	TEST_CASE(latencyHistogram);
+	TEST_CASE(latencySerialization);
+	TEST_CASE(coldCache);
+	TEST_CASE(abComparison);
+	BENCHMARK_CASE(sumArray);
+	BENCHMARK_CASE(sumRange);
+	BENCHMARK_CASE(sharedCounter);
+	BENCHMARK_CASE(iterationLatencies);
+	BENCHMARK_CASE(sumColdArray);
+	BENCHMARK_CASE(sumArrayPairs);
+
+private:
+	std::atomic<size_t> m_sharedCounter;
+};
+
+TEST_IMPL(Benchmark, computeStats)
+{
+	double sorted[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 5, 0.5), 3.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 5, 0.25), 2.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 5, 0.99), 4.96, 1e-9);
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 4, 0.5), 2.5, 1e-9);
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 1, 0.99), 1.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(easyTest::stats::computeQuantile(sorted, 0, 0.5), 0.0, 1e-9);
+
+	easyTest::BenchmarkResult result = {};
+	const double samples[] = {12.0, 10.0, 11.0, 50.0, 10.0, 13.0, 11.0};
+	result.nbIterations = 1000;
+	result.nbSamples = sizeof(samples) / sizeof(samples[0]);
+	for (size_t i = 0; i < result.nbSamples; ++i)
+		result.samples[i] = samples[i];
+
+	easyTest::stats::computeBenchmarkStats(result, 1000, 10);
+	ASSERT_ALMOST_EQUAL(result.minTime, 10.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(result.medianTime, 11.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(result.meanTime, 117.0 / 7.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(result.madTime, 1.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(result.maxTime, 50.0, 1e-9);
+	ASSERT_ALMOST_EQUAL(result.bytesPerSecond, 1000.0 * 1.0e9 / 11.0, 1e-3);
+	ASSERT_ALMOST_EQUAL(result.itemsPerSecond, 10.0 * 1.0e9 / 11.0, 1e-3);
+
+	//Samples stay in collection order
+	ASSERT_ALMOST_EQUAL(result.samples[3], 50.0, 1e-9);
+	return true;
+}
+
+TEST_IMPL(Benchmark, incompleteLoops)
+{
+	easyTest::BenchmarkResult result = {};
+	ASSERT_FALSE(easyTest::BenchmarkState::run(this, &skipLoopBody, nullptr, result));
+	ASSERT_EQUAL(result.nbSamples, size_t(0));
+	ASSERT_FALSE(easyTest::BenchmarkState::run(this, &failingBody, nullptr, result));
+	ASSERT_EQUAL(result.nbSamples, size_t(0));
+	ASSERT_FALSE(easyTest::BenchmarkState::run(this, nullptr, nullptr, result));
+	return true;
+}
+
+TEST_IMPL(Benchmark, latencyMeasure)
+{
+	const easyTest::LatencyOptions options = {3, 10, 0.0};
+	CountingBody body = {0, 0};
+	easyTest::stats::LatencyMeasure measure;
+	ASSERT_TRUE(easyTest::stats::measureLatency(&CountingBody::run, &body, options, false, 0.99, measure));
+	ASSERT_EQUAL(body.nbCalls, size_t(13));
+	ASSERT_EQUAL(measure.nbRuns, size_t(10));
+	ASSERT_EQUAL(measure.nbOutliers, size_t(0));
+	ASSERT_GREATER_THAN(measure.time, 0.0);
+
+	const easyTest::LatencyOptions noRun = {3, 0, 0.0};
+	ASSERT_FALSE(easyTest::stats::measureLatency(&CountingBody::run, &body, noRun, false, 0.5, measure));
+
+	//One run out of 10 is much slower than the others
+	const easyTest::LatencyOptions outliers = {0, 50, 3.0};
+	CountingBody slowBody = {0, 10};
+	ASSERT_TRUE(easyTest::stats::measureLatency(&CountingBody::run, &slowBody, outliers, true, 0.99, measure));
+	ASSERT_EQUAL(measure.nbRuns, size_t(50));
+	ASSERT_GREATER_OR_EQUAL(measure.nbOutliers, size_t(5));
+	ASSERT_LESS_THAN(measure.nbOutliers, size_t(50));
+	return true;
+}
+
+TEST_IMPL(Benchmark, latencyBudget)
+{
+	ASSERT_EQUAL(getLatencyOptions().nbRuns, easyTest::DEFAULT_LATENCY_OPTIONS.nbRuns);
+	setLatencyOptions(2, 20, 5.0);
+	ASSERT_EQUAL(getLatencyOptions().nbRuns, size_t(20));
+
+	//Budgets are huge so that loaded machines never fail
+	int value = 0;
+	ASSERT_P99_BELOW(easyTest::doNotOptimize(value += 1), 1000000000LL);
+	ASSERT_MEDIAN_BELOW(easyTest::doNotOptimize(value += 1), 1000000000LL);
+	ASSERT_P99_CPU_TIME_BELOW(easyTest::doNotOptimize(value += 1), 1000000000LL);
+	EXPECT_MEDIAN_CPU_TIME_BELOW(easyTest::doNotOptimize(value += 1), 1000000000LL);
+	ASSERT_EQUAL(value, 4 * 22);
+	return true;
+}
+
+TEST_IMPL(Benchmark, complexityFit)
+{
+	using easyTest::Complexity;
+
+	easyTest::ComplexityResult result = {};
+	for (int c = 0; c < static_cast<int>(Complexity::ANY); ++c)
+	{
+		fillComplexity(result, 8, static_cast<Complexity>(c), 3.0);
+		easyTest::stats::fitComplexity(result);
+		ASSERT_TRUE(result.bestFit == static_cast<Complexity>(c));
+		ASSERT_ALMOST_EQUAL(result.coefficient, 3.0, 1e-9);
+		ASSERT_ALMOST_EQUAL(result.cpuCoefficient, 1.5, 1e-9);
+		ASSERT_ALMOST_EQUAL(result.rms, 0.0, 1e-9);
+	}
+
+	//A small noise does not make a linear body look more complex
+	fillComplexity(result, 8, Complexity::O_N, 3.0);
+	result.ranges[7].medianTime *= 1.01;
+	easyTest::stats::fitComplexity(result);
+	ASSERT_TRUE(result.bestFit == Complexity::O_N);
+	ASSERT_GREATER_THAN(result.rms, 0.0);
+
+	ASSERT_TRUE(easyTest::stats::fitsComplexity(result, Complexity::O_N));
+
+	//Times of a linear body measured on a loaded machine: O(n log n) fits
+	//slightly better, but not enough to fail an O(n) bound
+	static const double s_noisyTimes[] = {267.461, 1622.0, 11316.0, 31487.0, 108052.0};
+	result.nbRanges = 5;
+	for (size_t i = 0; i < 5; ++i)
+	{
+		result.ranges[i].range = size_t(256) << (2 * i);
+		result.ranges[i].medianTime = result.ranges[i].cpuTime = s_noisyTimes[i];
+	}
+
+	easyTest::stats::fitComplexity(result);
+	ASSERT_TRUE(result.bestFit == Complexity::O_N_LOG_N);
+	ASSERT_TRUE(easyTest::stats::fitsComplexity(result, Complexity::O_N));
+	ASSERT_FALSE(easyTest::stats::fitsComplexity(result, Complexity::O_LOG_N));
+
+	fillComplexity(result, 8, Complexity::O_N_LOG_N, 3.0);
+	easyTest::stats::fitComplexity(result);
+	ASSERT_FALSE(easyTest::stats::fitsComplexity(result, Complexity::O_N));
+	ASSERT_TRUE(easyTest::stats::fitsComplexity(result, Complexity::O_N_LOG_N));
+	ASSERT_TRUE(easyTest::stats::fitsComplexity(result, Complexity::ANY));
+
+	fillComplexity(result, 1, Complexity::O_N, 3.0);
+	easyTest::stats::fitComplexity(result);
+	ASSERT_TRUE(result.bestFit == Complexity::ANY);
+	ASSERT_FALSE(easyTest::stats::fitsComplexity(result, Complexity::O_N));
+	return true;
+}
+
+TEST_IMPL(Benchmark, benchmarkRanges)
+{
+	easyTest::ComplexityResult result = {};
+	RangeRecorder recorder = {};
+	ASSERT_TRUE(easyTest::BenchmarkState::runRange(this, &RangeRecorder::run, &recorder, 3, 100, 4, result));
+	ASSERT_EQUAL(recorder.nbRanges, size_t(4));
+	ASSERT_EQUAL(recorder.ranges[0], size_t(3));
+	ASSERT_EQUAL(recorder.ranges[1], size_t(12));
+	ASSERT_EQUAL(recorder.ranges[2], size_t(48));
+	ASSERT_EQUAL(recorder.ranges[3], size_t(100));
+	ASSERT_EQUAL(result.nbRanges, size_t(4));
+	ASSERT_EQUAL(result.ranges[3].range, size_t(100));
+	ASSERT_GREATER_THAN(result.ranges[3].nbSamples, size_t(0));
+
+	recorder.nbRanges = 0;
+	ASSERT_TRUE(easyTest::BenchmarkState::runRange(this, &RangeRecorder::run, &recorder, 7, 7, 2, result));
+	ASSERT_EQUAL(recorder.nbRanges, size_t(1));
+	ASSERT_TRUE(result.bestFit == easyTest::Complexity::ANY);
+
+	ASSERT_FALSE(easyTest::BenchmarkState::runRange(this, &RangeRecorder::run, &recorder, 0, 7, 2, result));
+	ASSERT_FALSE(easyTest::BenchmarkState::runRange(this, &RangeRecorder::run, &recorder, 8, 7, 2, result));
+	ASSERT_FALSE(easyTest::BenchmarkState::runRange(this, &RangeRecorder::run, &recorder, 1, 7, 1, result));
+	ASSERT_FALSE(easyTest::BenchmarkState::runRange(this, &failingBody, nullptr, 1, 7, 2, result));
+	ASSERT_EQUAL(result.nbRanges, size_t(0));
+	return true;
+}
+
+TEST_IMPL(Benchmark, scalingMeasure)
+{
+	const size_t nbIterations[] = {400, 300, 200, 100};
+	const long long realTimes[] = {1000000, 1000000, 1000000, 500000};
+	const long long threadTimes[] = {1000000, 1000000, 1000000, 1000000};
+
+	easyTest::ScalingMeasure single = {};
+	single.nbThreads = 1;
+	easyTest::stats::computeScalingMeasure(single, nbIterations, realTimes, threadTimes, 0.0);
+	ASSERT_EQUAL(single.nbIterations, size_t(400));
+	ASSERT_EQUAL(single.throughput, 400000.0);
+	ASSERT_EQUAL(single.efficiency, 1.0);
+	ASSERT_EQUAL(single.fairness, 1.0);
+
+	easyTest::ScalingMeasure measure = {};
+	measure.nbThreads = 4;
+	easyTest::stats::computeScalingMeasure(measure, nbIterations, realTimes, threadTimes, single.throughput);
+	ASSERT_EQUAL(measure.nbIterations, size_t(1000));
+	ASSERT_EQUAL(measure.minThreadIterations, size_t(100));
+	ASSERT_EQUAL(measure.maxThreadIterations, size_t(400));
+	ASSERT_EQUAL(measure.realTime, 1000000.0);
+	ASSERT_EQUAL(measure.cpuTime, 4000.0);
+	ASSERT_EQUAL(measure.throughput, 1100000.0);
+	ASSERT_EQUAL(measure.threadThroughput, 275000.0);
+	ASSERT_EQUAL(measure.efficiency, 0.6875);
+	ASSERT_EQUAL(measure.fairness, 0.25);
+	return true;
+}
+
+TEST_IMPL(Benchmark, benchmarkScaling)
+{
+	easyTest::ScalingResult result = {};
+	ScalingRecorder recorder;
+	recorder.maxThreadIdx = 0;
+	recorder.nbBadThreadCounts = 0;
+	recorder.failingThreadIdx = easyTest::BENCHMARK_MAX_THREADS;
+	ASSERT_TRUE(easyTest::BenchmarkState::runScaling(this, &ScalingRecorder::run, &recorder, 3, result));
+	ASSERT_EQUAL(recorder.nbBadThreadCounts.load(), 0u);
+
+#ifndef EASYTEST_NO_THREADS
+	ASSERT_EQUAL(recorder.maxThreadIdx.load(), 2u);
+	ASSERT_EQUAL(result.nbMeasures, size_t(3));
+	ASSERT_EQUAL(result.measures[1].nbThreads, 2u);
+	ASSERT_EQUAL(result.measures[2].nbThreads, 3u);
+#else //EASYTEST_NO_THREADS is defined
+	ASSERT_EQUAL(recorder.maxThreadIdx.load(), 0u);
+	ASSERT_EQUAL(result.nbMeasures, size_t(1));
+#endif //!EASYTEST_NO_THREADS
+
+	ASSERT_EQUAL(result.measures[0].nbThreads, 1u);
+	ASSERT_EQUAL(result.measures[0].efficiency, 1.0);
+	for (size_t i = 0; i < result.nbMeasures; ++i)
+	{
+		ASSERT_GREATER_OR_EQUAL(result.measures[i].nbIterations, size_t(result.measures[i].nbThreads));
+		ASSERT_GREATER_THAN(result.measures[i].throughput, 0.0);
+		ASSERT_GREATER_THAN(result.measures[i].fairness, 0.0);
+		ASSERT_LESS_OR_EQUAL(result.measures[i].fairness, 1.0);
+	}
+
+#ifndef EASYTEST_NO_THREADS
+	//A failing thread releases the others waiting at the barriers
+	recorder.failingThreadIdx = 1;
+	ASSERT_FALSE(easyTest::BenchmarkState::runScaling(this, &ScalingRecorder::run, &recorder, 4, result));
+	ASSERT_EQUAL(result.nbMeasures, size_t(1));
+#endif //!EASYTEST_NO_THREADS
+
+	ASSERT_FALSE(easyTest::BenchmarkState::runScaling(this, &failingBody, nullptr, 2, result));
+	ASSERT_EQUAL(result.nbMeasures, size_t(0));
+	return true;
+}
+
+TEST_IMPL(Benchmark, latencyHistogram)
+{
+	easyTest::LatencyHistogram histogram;
+	ASSERT_EQUAL(histogram.getPrecision(), easyTest::LATENCY_HISTOGRAM_DEFAULT_PRECISION);
+	ASSERT_EQUAL(histogram.getTotalCount(), size_t(0));
+	ASSERT_EQUAL(histogram.getValueAtPercentile(50.0), 0LL);
+
+	//1 to 10000 ns, then one 1 s outlier
+	for (long long value = 1; value <= 10000; ++value)
+		histogram.record(value);
+
+	histogram.record(1000000000LL);
+	ASSERT_EQUAL(histogram.getTotalCount(), size_t(10001));
+	ASSERT_EQUAL(histogram.getMin(), 1LL);
+	ASSERT_EQUAL(histogram.getMax(), 1000000000LL);
+	ASSERT_EQUAL(histogram.getValueAtPercentile(100.0), 1000000000LL);
+
+	//2 significant digits: values are known within 1%
+	const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+	for (int i = 0; i < 4; ++i)
+	{
+		const double expected = percentiles[i] * 100.0;
+		const double value = static_cast<double>(histogram.getValueAtPercentile(percentiles[i]));
+		ASSERT_GREATER_OR_EQUAL(value, expected);
+		ASSERT_LESS_OR_EQUAL(value, expected * 1.01);
+	}
+
+	//Small values are exact, values out of range are clamped
+	easyTest::LatencyHistogram small(1, 1000);
+	small.record(-5);
+	small.record(7);
+	small.record(5000);
+	ASSERT_EQUAL(small.getMin(), 0LL);
+	ASSERT_EQUAL(small.getValueAtPercentile(50.0), 7LL);
+	ASSERT_EQUAL(small.getMax(), 1000LL);
+
+	//Merging histograms with another layout
+	easyTest::LatencyHistogram precise(3);
+	precise.record(500);
+	ASSERT_TRUE(precise.merge(histogram));
+	ASSERT_TRUE(precise.merge(small));
+	ASSERT_EQUAL(precise.getTotalCount(), size_t(10005));
+	ASSERT_EQUAL(precise.getMin(), 0LL);
+	ASSERT_EQUAL(precise.getMax(), 1000000000LL);
+	ASSERT_GREATER_OR_EQUAL(precise.getValueAtPercentile(50.0), 4900LL);
+	ASSERT_LESS_OR_EQUAL(precise.getValueAtPercentile(50.0), 5100LL);
+
+	histogram.setPrecision(easyTest::LATENCY_HISTOGRAM_MAX_PRECISION + 1);
+	ASSERT_EQUAL(histogram.getPrecision(), easyTest::LATENCY_HISTOGRAM_MAX_PRECISION);
+	ASSERT_EQUAL(histogram.getTotalCount(), size_t(0));
+
+	precise.reset();
+	ASSERT_EQUAL(precise.getTotalCount(), size_t(0));
+	ASSERT_EQUAL(precise.getMax(), 0LL);
+	ASSERT_EQUAL(precise.getMean(), 0.0);
+	return true;
+}
+
+TEST_IMPL(Benchmark, latencySerialization)
+{
+	easyTest::LatencyHistogram shardA;
+	easyTest::LatencyHistogram shardB;
+	for (long long value = 100; value < 200; ++value)
+	{
+		shardA.record(value);
+		shardB.record(value * 100);
+	}
+
+	char serializedA[4096];
+	char serializedB[4096];
+	const size_t lengthA = shardA.serialize(serializedA, sizeof(serializedA));
+	ASSERT_LESS_THAN(lengthA, sizeof(serializedA));
+	ASSERT_EQUAL(std::strlen(serializedA), lengthA);
+	ASSERT_LESS_THAN(shardB.serialize(serializedB, sizeof(serializedB)), sizeof(serializedB));
+
+	//Truncated like snprintf()
+	char truncated[8];
+	ASSERT_EQUAL(shardA.serialize(truncated, sizeof(truncated)), lengthA);
+	ASSERT_EQUAL(std::strlen(truncated), sizeof(truncated) - 1);
+
+	//Round trip, then merge of the deserialized shards
+	easyTest::LatencyHistogram merged(1, 1000);
+	ASSERT_TRUE(merged.deserialize(serializedA));
+	ASSERT_EQUAL(merged.getPrecision(), shardA.getPrecision());
+	ASSERT_EQUAL(merged.getMaxValue(), shardA.getMaxValue());
+	ASSERT_EQUAL(merged.getTotalCount(), size_t(100));
+	ASSERT_EQUAL(merged.getValueAtPercentile(90.0), shardA.getValueAtPercentile(90.0));
+	ASSERT_EQUAL(merged.getMean(), shardA.getMean());
+
+	char roundTrip[4096];
+	merged.serialize(roundTrip, sizeof(roundTrip));
+	ASSERT_EQUAL(std::strcmp(roundTrip, serializedA), 0);
+
+	easyTest::LatencyHistogram other;
+	ASSERT_TRUE(other.deserialize(serializedB));
+	ASSERT_TRUE(merged.merge(other));
+	ASSERT_EQUAL(merged.getTotalCount(), size_t(200));
+	ASSERT_EQUAL(merged.getMin(), 100LL);
+	ASSERT_EQUAL(merged.getMax(), 19900LL);
+	ASSERT_LESS_OR_EQUAL(merged.getValueAtPercentile(50.0), 200LL);
+	ASSERT_GREATER_OR_EQUAL(merged.getValueAtPercentile(51.0), 10000LL);
+
+	easyTest::LatencyHistogram empty;
+	char serializedEmpty[64];
+	empty.serialize(serializedEmpty, sizeof(serializedEmpty));
+	ASSERT_TRUE(other.deserialize(serializedEmpty));
+	ASSERT_EQUAL(other.getTotalCount(), size_t(0));
+
+	ASSERT_FALSE(other.deserialize(""));
+	ASSERT_FALSE(other.deserialize("2/1000/1/5/5/5/"));
+	ASSERT_FALSE(other.deserialize("9/1000/0/0/0/0/"));
+	ASSERT_FALSE(other.deserialize("2/1000/2/5/5/10/5:1"));
+	ASSERT_FALSE(other.deserialize("2/1000/1/5/5/5/99999:1"));
+	ASSERT_EQUAL(other.getTotalCount(), size_t(0));
+	ASSERT_TRUE(other.deserialize("2/1000/2/5/5/10/5:2"));
+	ASSERT_EQUAL(other.getValueAtPercentile(50.0), 5LL);
+	return true;
+}
+
+TEST_IMPL(Benchmark, coldCache)
+{
+	using namespace easyTest::stats;
+
+	ASSERT_GREATER_OR_EQUAL(getCacheEvictionSize(), MIN_CACHE_EVICTION_SIZE);
+	ASSERT_GREATER_OR_EQUAL(getCacheEvictionSize(), 2 * getLastLevelCacheSize());
+
+	easyTest::BenchmarkResult result = {};
+	ColdRecorder recorder = {};
+	ASSERT_TRUE(easyTest::BenchmarkState::runCold(this, &ColdRecorder::run, &recorder, result));
+	ASSERT_EQUAL(result.nbIterations, size_t(1));
+	ASSERT_GREATER_OR_EQUAL(result.nbSamples, MIN_BENCHMARK_SAMPLES);
+	ASSERT_LESS_OR_EQUAL(result.nbSamples, easyTest::BENCHMARK_MAX_SAMPLES);
+
+	//The first call is not kept
+	ASSERT_EQUAL(recorder.nbCalls, result.nbSamples + 1);
+	ASSERT_EQUAL(recorder.nbBadCalls, size_t(0));
+
+	ASSERT_FALSE(easyTest::BenchmarkState::runCold(this, &failingBody, nullptr, result));
+	ASSERT_EQUAL(result.nbSamples, size_t(0));
+	ASSERT_FALSE(easyTest::BenchmarkState::runCold(this, nullptr, nullptr, result));
+	return true;
+}
+
+TEST_IMPL(Benchmark, abComparison)
+{
+	using namespace easyTest;
+
+	//B is 1.5 times slower than A in every round
+	double timesA[BENCHMARK_MAX_AB_ROUNDS];
+	double timesB[BENCHMARK_MAX_AB_ROUNDS];
+	for (size_t i = 0; i < 20; ++i)
+	{
+		timesA[i] = 100.0 + i;
+		timesB[i] = 1.5 * timesA[i];
+	}
+
+	ABResult result = {};
+	result.nbRounds = 20;
+	stats::computeABStats(result, timesA, timesB);
+	ASSERT_ALMOST_EQUAL(result.a.medianTime, 109.5, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.b.meanTime, 1.5 * 109.5, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.ratio, 1.5, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.lowRatio, 1.5, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.highRatio, 1.5, 1.0e-9);
+	ASSERT_TRUE(result.verdict == ABVerdict::A_FASTER);
+
+	//Ratios spread around 1: with 20 rounds the interval goes from the 5th
+	//to the 16th lowest ratio
+	for (size_t i = 0; i < 20; ++i)
+	{
+		timesA[i] = 100.0;
+		timesB[i] = 90.0 + i;
+	}
+
+	stats::computeABStats(result, timesA, timesB);
+	ASSERT_ALMOST_EQUAL(result.ratio, 0.995, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.lowRatio, 0.94, 1.0e-9);
+	ASSERT_ALMOST_EQUAL(result.highRatio, 1.05, 1.0e-9);
+	ASSERT_TRUE(result.verdict == ABVerdict::SAME);
+
+	for (size_t i = 0; i < 20; ++i)
+		timesB[i] = 50.0;
+
+	stats::computeABStats(result, timesA, timesB);
+	ASSERT_ALMOST_EQUAL(result.ratio, 0.5, 1.0e-9);
+	ASSERT_TRUE(result.verdict == ABVerdict::B_FASTER);
+
+	ColdRecorder recorder = {};
+	ASSERT_TRUE(BenchmarkState::runAB(this, &ColdRecorder::run, "a", &ColdRecorder::run, "b", &recorder, result));
+	ASSERT_GREATER_OR_EQUAL(result.nbRounds, stats::MIN_BENCHMARK_SAMPLES);
+	ASSERT_LESS_OR_EQUAL(result.nbRounds, BENCHMARK_MAX_AB_ROUNDS);
+	ASSERT_STRING_EQUAL(result.a.name, "a");
+	ASSERT_STRING_EQUAL(result.b.name, "b");
+	ASSERT_GREATER_THAN(result.a.nbIterations, size_t(0));
+	ASSERT_GREATER_THAN(result.b.nbIterations, size_t(0));
+	ASSERT_LESS_OR_EQUAL(result.lowRatio, result.ratio);
+	ASSERT_GREATER_OR_EQUAL(result.highRatio, result.ratio);
+
+	ASSERT_FALSE(BenchmarkState::runAB(this, &ColdRecorder::run, "a", &failingBody, "b", &recorder, result));
+	ASSERT_EQUAL(result.nbRounds, size_t(0));
+	ASSERT_FALSE(BenchmarkState::runAB(this, nullptr, "a", &ColdRecorder::run, "b", &recorder, result));
+	return true;
+}
+
+BENCHMARK_IMPL(Benchmark, sumArray)
+{
+	int values[256];
+	for (int i = 0; i < 256; ++i)
+		values[i] = i;
+
+	state.setBytesPerIteration(sizeof(values));
+	state.setItemsPerIteration(256);
+
+	int sum = 0;
+	while (state.keepRunning())
+	{
+		sum = 0;
+		for (int i = 0; i < 256; ++i)
+			sum += values[i];
+
+		easyTest::doNotOptimize(sum);
+	}
+
+	ASSERT_EQUAL(sum, 255 * 128);
+	return true;
+}
+
+BENCHMARK_RANGE_IMPL(Benchmark, sumRange, 1 << 8, 1 << 16, 4, O_N)
+{
+	const size_t n = state.getRange();
+	int* values = new(std::nothrow) int[n];
+	ASSERT_TRUE(values != nullptr);
+
+	for (size_t i = 0; i < n; ++i)
+		values[i] = static_cast<int>(i & 0xFF);
+
+	while (state.keepRunning())
+	{
+		int sum = 0;
+		for (size_t i = 0; i < n; ++i)
+			sum += values[i];
+
+		easyTest::doNotOptimize(sum);
+	}
+
+	delete[] values;
+	return true;
+}
+
+BENCHMARK_THREADS_IMPL(Benchmark, sharedCounter, 4)
+{
+	if (!state.getThreadIdx())
+		m_sharedCounter = 0;
+
+	while (state.keepRunning())
+		m_sharedCounter.fetch_add(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+BENCHMARK_IMPL(Benchmark, iterationLatencies)
+{
+	int values[64];
+	for (int i = 0; i < 64; ++i)
+		values[i] = i;
+
+	state.recordIterationLatencies();
+	while (state.keepRunning())
+	{
+		int sum = 0;
+		for (int i = 0; i < 64; ++i)
+			sum += values[i];
+
+		easyTest::doNotOptimize(sum);
+	}
+
+	return true;
+}
+
+BENCHMARK_COLD_IMPL(Benchmark, sumColdArray)
+{
+	const int nbValues = static_cast<int>(sizeof(s_coldValues) / sizeof(s_coldValues[0]));
+	for (int i = 0; i < nbValues; ++i)
+		s_coldValues[i] = i & 0xFF;
+
+	state.setBytesPerIteration(sizeof(s_coldValues));
+
+	while (state.keepRunning())
+	{
+		int sum = 0;
+		for (int i = 0; i < nbValues; ++i)
+			sum += s_coldValues[i];
+
+		easyTest::doNotOptimize(sum);
+	}
+
+	return true;
+}
+
+//Same sum as sumArray with two independent accumulators, compared to it by
+//the sumArray_vs_sumArrayPairs A/B benchmark case
+BENCHMARK_IMPL(Benchmark, sumArrayPairs)
+{
+	int values[256];
+	{
+		TIMED_SCOPE("init");
+		for (int i = 0; i < 256; ++i)
+			values[i] = i;
+	}
+
+	state.setBytesPerIteration(sizeof(values));
+	state.setItemsPerIteration(256);
+
+	int sum = 0;
+	while (state.keepRunning())
+	{
+		int sum0 = 0;
+		int sum1 = 0;
+		for (int i = 0; i < 256; i += 2)
+		{
+			sum0 += values[i];
+			sum1 += values[i + 1];
+		}
+
+		sum = sum0 + sum1;
+		easyTest::doNotOptimize(sum);
+	}
+
+	ASSERT_EQUAL(sum, 255 * 128);
+	return true;
+}
+
+BENCHMARK_AB(Benchmark, sumArray, sumArrayPairs);
@@ -7,7 +7,15 @@
  * See: http://opensource.org/licenses/MIT
  */
 
+#include <cstdio>
+#include <cstring>
+#include <new>
+
 #include "../include/easyTest.h"
+#include "../src/compare/SimdCompare.h"
+#include "../src/compare/GoldenFile.h"
+#include "../src/compare/Digest.h"
+#include "TempFile.h"
 
 #ifdef _MSC_VER //Visual C++ compiler
 #pragma warning(disable:4309)
@@ -32,13 +40,25 @@ TEST_SUITE(DataCompare)
 	TEST_CASE(assertStringsDifferent_utf16);
 	TEST_CASE(assertStringsDifferent_utf32);
 
+	TEST_CASE(assertLongStrings_ascii);
+	TEST_CASE(assertLongStrings_wide);
+	TEST_CASE(assertLongStrings_utf16);
+	TEST_CASE(assertLongStrings_utf32);
+
 	TEST_CASE(assertBitwiseEqual);
 	TEST_CASE(assertBitwiseDifferent);
 
 	TEST_CASE(assertSameData);
 	TEST_CASE(assertDifferentData);
+	TEST_CASE(dataDiffReport);
+	TEST_CASE(dataDiffScanner);
+	TEST_CASE(goldenFile);
+	TEST_CASE(dataDigest);
+	TEST_CASE(dataTreeDigest);
 
 private:
+	template<typename T> bool checkLongStrings();
+
 	const char* const asciiStrA = "az";
 	const char asciiStrB[3] = {0x61, 0x7A, 0x00};
 	const char* const asciiStrC = "ab";
@@ -139,6 +159,65 @@ TEST_IMPL(DataCompare, assertStringsDifferent_utf32)
 	return true;
 }
 
+TEST_IMPL(DataCompare, assertLongStrings_ascii)
+{
+	return checkLongStrings<char>();
+}
+
+TEST_IMPL(DataCompare, assertLongStrings_wide)
+{
+	return checkLongStrings<wchar_t>();
+}
+
+TEST_IMPL(DataCompare, assertLongStrings_utf16)
+{
+	return checkLongStrings<char16_t>();
+}
+
+TEST_IMPL(DataCompare, assertLongStrings_utf32)
+{
+	return checkLongStrings<char32_t>();
+}
+
+template<typename T> bool DataCompare::checkLongStrings()
+{
+	//Strings are shifted along the buffers in order to test all alignments
+	//and both vector and scalar comparison paths.
+	const size_t len = 1000;
+	const size_t nbShifts = 17;
+	T bufferA[len + nbShifts] = {};
+	T bufferB[len + nbShifts] = {};
+
+	for (size_t shift = 0; shift < nbShifts; ++shift)
+	{
+		T* strA = bufferA + shift;
+		T* strB = bufferB + nbShifts - 1 - shift;
+		for (size_t i = 0; i < len - 1; ++i)
+			strA[i] = strB[i] = static_cast<T>('a' + i % 26);
+
+		strA[len - 1] = strB[len - 1] = 0;
+
+		ASSERT_STRING_EQUAL(strA, strB);
+		ASSERT_EQUAL(strMismatch(strA, strB), NO_STRING_MISMATCH);
+
+		const size_t mismatchList[] = {0, 1, 15, 16, 17, 500, len - 2};
+		for (size_t idx : mismatchList)
+		{
+			const T c = strB[idx];
+			strB[idx] = static_cast<T>(0x263A);
+			ASSERT_STRING_DIFFERENT(strA, strB);
+			ASSERT_EQUAL(strMismatch(strA, strB), idx);
+			strB[idx] = c;
+		}
+
+		strB[len - 2] = 0;
+		ASSERT_STRING_DIFFERENT(strA, strB);
+		ASSERT_EQUAL(strMismatch(strA, strB), len - 2);
+	}
+
+	return true;
+}
+
 TEST_IMPL(DataCompare, assertBitwiseEqual)
 {
 	ASSERT_EQUAL(static_cast<int>(a), b);
@@ -170,3 +249,250 @@ TEST_IMPL(DataCompare, assertDifferentData)
 	ASSERT_TRUE(!haveDifferentData(bufferA, bufferC, sizeInBytes, "bufferA", "bufferC", SRC_INFO()));
 	return true;
 }
+
+TEST_IMPL(DataCompare, dataDiffReport)
+{
+	using namespace easyTest::compare;
+
+	unsigned char dataA[1000];
+	unsigned char dataB[1000];
+	for (size_t i = 0; i < sizeof(dataA); ++i)
+		dataA[i] = static_cast<unsigned char>(i * 7);
+
+	std::memcpy(dataB, dataA, sizeof(dataB));
+
+	DataDiffReport report;
+	computeDataDiff(report, dataA, dataB, sizeof(dataA));
+	ASSERT_EQUAL(report.sizeInBytes, sizeof(dataA));
+	ASSERT_EQUAL(report.nbMismatchBytes, size_t(0));
+	ASSERT_EQUAL(report.nbRegions, size_t(0));
+
+	//Two close differences are coalesced, a long region is truncated in
+	//its excerpt and the last byte is handled by the scalar tail.
+	dataB[3] ^= 0xFF;
+	dataB[5] ^= 0xFF;
+	for (size_t i = 100; i < 140; ++i)
+		dataB[i] ^= 0x01;
+
+	dataB[999] ^= 0x80;
+
+	computeDataDiff(report, dataA, dataB, sizeof(dataA));
+	ASSERT_EQUAL(report.nbMismatchBytes, size_t(43));
+	ASSERT_EQUAL(report.nbRegions, size_t(3));
+	ASSERT_EQUAL(report.nbReportedRegions, size_t(3));
+
+	ASSERT_EQUAL(report.regions[0].offset, size_t(3));
+	ASSERT_EQUAL(report.regions[0].size, size_t(3));
+	ASSERT_EQUAL(report.regions[0].excerptSize, size_t(3));
+	ASSERT_SAME_DATA(report.regions[0].excerptA, dataA + 3, 3);
+	ASSERT_SAME_DATA(report.regions[0].excerptB, dataB + 3, 3);
+
+	ASSERT_EQUAL(report.regions[1].offset, size_t(100));
+	ASSERT_EQUAL(report.regions[1].size, size_t(40));
+	ASSERT_EQUAL(report.regions[1].excerptSize, DATA_DIFF_EXCERPT_SIZE);
+
+	ASSERT_EQUAL(report.regions[2].offset, size_t(999));
+	ASSERT_EQUAL(report.regions[2].size, size_t(1));
+	ASSERT_EQUAL(report.regions[2].excerptSize, size_t(1));
+
+	//The excerpt of a last region followed by equal bytes holds the region
+	//bytes only
+	std::memcpy(dataB, dataA, sizeof(dataB));
+	dataB[10] ^= 0xFF;
+
+	computeDataDiff(report, dataA, dataB, 100);
+	ASSERT_EQUAL(report.nbRegions, size_t(1));
+	ASSERT_EQUAL(report.regions[0].offset, size_t(10));
+	ASSERT_EQUAL(report.regions[0].size, size_t(1));
+	ASSERT_EQUAL(report.regions[0].excerptSize, size_t(1));
+	ASSERT_SAME_DATA(report.regions[0].excerptB, dataB + 10, 1);
+
+	//Only the first regions are detailed
+	std::memcpy(dataB, dataA, sizeof(dataB));
+	for (size_t i = 0; i < 20; ++i)
+		dataB[i * 50] ^= 0xFF;
+
+	computeDataDiff(report, dataA, dataB, sizeof(dataA));
+	ASSERT_EQUAL(report.nbMismatchBytes, size_t(20));
+	ASSERT_EQUAL(report.nbRegions, size_t(20));
+	ASSERT_EQUAL(report.nbReportedRegions, DATA_DIFF_MAX_REGIONS);
+	ASSERT_EQUAL(report.regions[DATA_DIFF_MAX_REGIONS - 1].offset, (DATA_DIFF_MAX_REGIONS - 1) * 50);
+
+	const unsigned char bytes[3] = {0x00, 0xAB, 0xFF};
+	char hex[HEX_EXCERPT_BUFFER_SIZE];
+	formatHexBytes(hex, sizeof(hex), bytes, sizeof(bytes));
+	ASSERT_STRING_EQUAL(hex, "00 ab ff");
+
+	formatHexBytes(hex, 6, bytes, sizeof(bytes));
+	ASSERT_STRING_EQUAL(hex, "00 ab");
+	return true;
+}
+
+TEST_IMPL(DataCompare, dataDiffScanner)
+{
+	using namespace easyTest::compare;
+
+	unsigned char dataA[1000];
+	unsigned char dataB[1000];
+	for (size_t i = 0; i < sizeof(dataA); ++i)
+		dataA[i] = dataB[i] = static_cast<unsigned char>(i * 13);
+
+	//Regions crossing chunk boundaries must be reported as if the data was
+	//scanned in a single chunk
+	for (size_t i = 60; i < 70; ++i)
+		dataB[i] ^= 0x10;
+
+	for (size_t i = 500; i < 530; i += 4)
+		dataB[i] ^= 0x01;
+
+	dataB[999] ^= 0x02;
+
+	DataDiffReport refReport;
+	computeDataDiff(refReport, dataA, dataB, sizeof(dataA));
+
+	DataDiffReport report;
+	DataDiffScanner scanner(report);
+	const size_t chunkSizes[4] = {64, 3, 440, 493};
+	size_t offset = 0;
+	for (size_t i = 0; i < 4; ++i)
+	{
+		scanner.scan(dataA + offset, dataB + offset, chunkSizes[i]);
+		offset += chunkSizes[i];
+	}
+
+	scanner.finish();
+	ASSERT_EQUAL(offset, sizeof(dataA));
+	ASSERT_EQUAL(report.sizeInBytes, refReport.sizeInBytes);
+	ASSERT_EQUAL(report.nbMismatchBytes, refReport.nbMismatchBytes);
+	ASSERT_EQUAL(report.nbRegions, refReport.nbRegions);
+	ASSERT_EQUAL(report.nbReportedRegions, refReport.nbReportedRegions);
+
+	for (size_t i = 0; i < report.nbReportedRegions; ++i)
+	{
+		ASSERT_EQUAL(report.regions[i].offset, refReport.regions[i].offset);
+		ASSERT_EQUAL(report.regions[i].size, refReport.regions[i].size);
+		ASSERT_EQUAL(report.regions[i].excerptSize, refReport.regions[i].excerptSize);
+		ASSERT_SAME_DATA(report.regions[i].excerptA, refReport.regions[i].excerptA, report.regions[i].excerptSize);
+		ASSERT_SAME_DATA(report.regions[i].excerptB, refReport.regions[i].excerptB, report.regions[i].excerptSize);
+	}
+
+	return true;
+}
+
+TEST_IMPL(DataCompare, goldenFile)
+{
+	using namespace easyTest::compare;
+
+	//The golden file must not exist yet, only its unique name is kept
+	const test::TempFile goldenFile("DataCompare.golden");
+	const char* const goldenPath = goldenFile.getPath();
+	ASSERT_TRUE(goldenPath != nullptr);
+	std::remove(goldenPath);
+
+	unsigned char data[300];
+	for (size_t i = 0; i < sizeof(data); ++i)
+		data[i] = static_cast<unsigned char>(i);
+
+	size_t goldenSize = 0;
+	DataDiffReport report;
+	ASSERT_TRUE(matchGoldenFile(data, sizeof(data), goldenPath, goldenSize, report) == GoldenStatus::CANNOT_READ);
+
+	//No other test suite uses golden files, so the update mode can be
+	//switched here without disturbing concurrent tests
+	const bool bUpdateMode = isGoldenUpdateMode();
+	setGoldenUpdateMode(true);
+	const GoldenStatus status = matchGoldenFile(data, sizeof(data), goldenPath, goldenSize, report);
+	setGoldenUpdateMode(bUpdateMode);
+	ASSERT_TRUE(status == GoldenStatus::UPDATED);
+
+	ASSERT_TRUE(matchGoldenFile(data, sizeof(data), goldenPath, goldenSize, report) == GoldenStatus::MATCH);
+	ASSERT_EQUAL(goldenSize, sizeof(data));
+	ASSERT_MATCHES_GOLDEN(data, sizeof(data), goldenPath);
+
+	ASSERT_TRUE(matchGoldenFile(data, sizeof(data) - 1, goldenPath, goldenSize, report) == GoldenStatus::SIZE_MISMATCH);
+	ASSERT_EQUAL(goldenSize, sizeof(data));
+
+	data[10] ^= 0xFF;
+	data[250] ^= 0xFF;
+	ASSERT_TRUE(matchGoldenFile(data, sizeof(data), goldenPath, goldenSize, report) == GoldenStatus::DATA_MISMATCH);
+	ASSERT_EQUAL(report.nbMismatchBytes, size_t(2));
+	ASSERT_EQUAL(report.nbRegions, size_t(2));
+	ASSERT_EQUAL(report.regions[1].offset, size_t(250));
+	ASSERT_EQUAL(report.regions[1].excerptB[0], static_cast<unsigned char>(250));
+	return true;
+}
+
+TEST_IMPL(DataCompare, dataDigest)
+{
+	using namespace easyTest::compare;
+
+	//Reference XXH64 digests (seed 0)
+	ASSERT_EQUAL(computeDigest(nullptr, 0), uint64_t(0xEF46DB3751D8E999));
+	ASSERT_EQUAL(computeDigest("a", 1), uint64_t(0xD24EC4F1A98C6E5B));
+	ASSERT_EQUAL(computeDigest("abc", 3), uint64_t(0x44BC2CF5AD770999));
+
+	const char* const text = "Nobody inspects the spammish repetition";
+	const size_t textSize = std::strlen(text);
+	ASSERT_EQUAL(computeDigest(text, textSize), uint64_t(0xFBCEA83C8A378BF1));
+
+	ASSERT_DATA_DIGEST(text, textSize, "fbcea83c8a378bf1");
+	ASSERT_DATA_DIGEST(text, textSize, "0xFBCEA83C8A378BF1");
+	ASSERT_DATA_TREE_DIGEST(text, textSize, "fbcea83c8a378bf1");
+
+	//Streaming by odd-sized pieces gives the same digest
+	DigestHasher hasher;
+	for (size_t i = 0; i < textSize; i += 5)
+		hasher.update(text + i, (textSize - i < 5) ? textSize - i : 5);
+
+	ASSERT_EQUAL(hasher.getDigest(), uint64_t(0xFBCEA83C8A378BF1));
+
+	char hex[DIGEST_BUFFER_SIZE];
+	formatDigest(hex, sizeof(hex), uint64_t(0x0123456789ABCDEF));
+	ASSERT_STRING_EQUAL(hex, "0123456789abcdef");
+
+	uint64_t digest = 0;
+	ASSERT_TRUE(parseDigest("1f", digest));
+	ASSERT_EQUAL(digest, uint64_t(0x1F));
+	ASSERT_FALSE(parseDigest("", digest));
+	ASSERT_FALSE(parseDigest("0x", digest));
+	ASSERT_FALSE(parseDigest("12g4", digest));
+	ASSERT_FALSE(parseDigest("0123456789abcdef0", digest));
+	ASSERT_FALSE(parseDigest(nullptr, digest));
+	return true;
+}
+
+TEST_IMPL(DataCompare, dataTreeDigest)
+{
+	using namespace easyTest::compare;
+
+	//Several leaves and a partial last leaf
+	const size_t sizeInBytes = 5 * DIGEST_TREE_LEAF_SIZE / 2;
+	unsigned char* data = new(std::nothrow) unsigned char[sizeInBytes];
+	ASSERT_TRUE(data);
+
+	for (size_t i = 0; i < sizeInBytes; ++i)
+		data[i] = static_cast<unsigned char>((i * 31) ^ (i >> 12));
+
+	//The tree digest is the digest of all little-endian leaf digests, it
+	//never depends on the number of threads
+	unsigned char leafDigests[3 * 8];
+	for (size_t leaf = 0; leaf < 3; ++leaf)
+	{
+		const size_t offset = leaf * DIGEST_TREE_LEAF_SIZE;
+		const size_t size = (sizeInBytes - offset < DIGEST_TREE_LEAF_SIZE) ? sizeInBytes - offset : DIGEST_TREE_LEAF_SIZE;
+		uint64_t d = computeDigest(data + offset, size);
+		for (size_t i = 0; i < 8; ++i, d >>= 8)
+			leafDigests[leaf * 8 + i] = static_cast<unsigned char>(d);
+	}
+
+	const uint64_t treeDigest = computeDigest(leafDigests, sizeof(leafDigests));
+	const uint64_t digest1 = computeTreeDigest(data, sizeInBytes, 1);
+	const uint64_t digest2 = computeTreeDigest(data, sizeInBytes, 2);
+	const uint64_t digest8 = computeTreeDigest(data, sizeInBytes, 8);
+	delete[] data;
+
+	ASSERT_EQUAL(digest1, treeDigest);
+	ASSERT_EQUAL(digest2, treeDigest);
+	ASSERT_EQUAL(digest8, treeDigest);
+	return true;
+}
@@ -0,0 +1,378 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../include/easyTest.h"
+#include "../src/stats/PerfCounters.h"
+#include "../src/stats/Chrono.h"
+#include "../src/stats/CodeTimer.h"
+#include "../src/stats/AllocTracker.h"
+#include "../src/stats/ResourceUsage.h"
+#include "../src/stats/IoUsage.h"
+#include "../src/stats/BenchEnvironment.h"
+#include "../src/stats/Profiler.h"
+#include "TempFile.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+TEST_SUITE(Measurement)
+{
+	TEST_CASE(perfCounters);
+	TEST_CASE(realTimeClock);
+	TEST_CASE(timerOverhead);
+	TEST_CASE(allocTracking);
+	TEST_CASE(nestedAllocTrackers);
+	TEST_CASE(resourceUsage);
+	TEST_CASE(ioUsage);
+	TEST_CASE(benchEnvironment);
+	TEST_CASE(threadProfiler);
+};
+
+TEST_IMPL(Measurement, perfCounters)
+{
+	using easyTest::stats::PerfCounter;
+
+	//Counters may be unavailable (virtual machines, permissions), then all
+	//values must be -1
+	easyTest::stats::PerfCounters counters;
+	ASSERT_TRUE(counters.start());
+	ASSERT_FALSE(counters.start());
+	ASSERT_TRUE(counters.isRunning());
+	ASSERT_EQUAL(counters.getValue(PerfCounter::CYCLES), -1LL);
+
+	int value = 0;
+	for (int i = 0; i < 1000; ++i)
+		easyTest::doNotOptimize(value += i);
+
+	counters.stop();
+	ASSERT_FALSE(counters.isRunning());
+
+	for (int i = 0; i < static_cast<int>(PerfCounter::COUNT); ++i)
+		ASSERT_GREATER_OR_EQUAL(counters.getValue(static_cast<PerfCounter>(i)), -1LL);
+
+	if (counters.getValue(PerfCounter::INSTRUCTIONS) >= 0)
+		ASSERT_GREATER_THAN(counters.getValue(PerfCounter::INSTRUCTIONS), 1000LL);
+
+	if (!counters.isAvailable())
+	{
+		ASSERT_EQUAL(counters.getValue(PerfCounter::PAGE_FAULTS), -1LL);
+		ASSERT_LESS_THAN(counters.getIPC(), 0.0);
+	}
+
+	return true;
+}
+
+TEST_IMPL(Measurement, realTimeClock)
+{
+	using namespace easyTest::stats;
+
+	//The clock is shared by all worker-threads, so it is never switched
+	//here: selecting an unavailable TSC must leave it unchanged
+	const RealTimeClock clock = getRealTimeClock();
+	if (!isTscClockAvailable())
+	{
+		ASSERT_FALSE(setRealTimeClock(RealTimeClock::TSC));
+		ASSERT_TRUE(getRealTimeClock() == clock);
+	}
+
+	Chrono chrono(Chrono::Type::REAL_TIME);
+	long long previous = chrono.tick();
+	ASSERT_GREATER_OR_EQUAL(previous, 0LL);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		const long long now = chrono.tick();
+		ASSERT_GREATER_OR_EQUAL(now, previous);
+		previous = now;
+	}
+
+	return true;
+}
+
+TEST_IMPL(Measurement, timerOverhead)
+{
+	easyTest::stats::CodeTimer timer;
+	ASSERT_TRUE(timer.setElapsedTimes(5000, -1, 300));
+	ASSERT_EQUAL(timer.getElapsedRealTime(), 5000LL);
+	ASSERT_EQUAL(timer.getElapsedProcessTime(), 0LL);
+
+	easyTest::stats::CodeTimer overhead;
+	ASSERT_TRUE(overhead.setElapsedTimes(1000, 100, 500));
+	timer.subtract(overhead);
+	ASSERT_EQUAL(timer.getElapsedRealTime(), 4000LL);
+	ASSERT_EQUAL(timer.getElapsedProcessTime(), 0LL);
+	ASSERT_EQUAL(timer.getElapsedThreadTime(), 0LL);
+
+	ASSERT_TRUE(timer.start());
+	ASSERT_FALSE(timer.setElapsedTimes(1, 1, 1));
+	timer.subtract(overhead);
+	timer.stop();
+	ASSERT_GREATER_OR_EQUAL(timer.getElapsedRealTime(), 0LL);
+	return true;
+}
+
+TEST_IMPL(Measurement, allocTracking)
+{
+	//Nothing is counted without allocation hooks
+	if (!easyTest::stats::isAllocTrackingAvailable())
+	{
+		ASSERT_FALSE(easyTest::stats::setAllocTrackingEnabled(true));
+		return true;
+	}
+
+	easyTest::stats::AllocTracker tracker;
+	tracker.start();
+
+	int* values = new int[256];
+	easyTest::doNotOptimize(values);
+	void* pBlock = std::malloc(100);
+	easyTest::doNotOptimize(pBlock);
+	std::free(pBlock);
+	delete[] values;
+
+	tracker.stop();
+
+	//malloc is only counted when built with malloc hooks, not new hooks
+	ASSERT_GREATER_OR_EQUAL(tracker.getNbAllocs(), static_cast<size_t>(1));
+	ASSERT_GREATER_OR_EQUAL(tracker.getNbBytes(), 256 * sizeof(int));
+	ASSERT_GREATER_OR_EQUAL(tracker.getPeakLiveBytes(), static_cast<long long>(256 * sizeof(int)));
+
+	ASSERT_NO_ALLOC
+	{
+		int local[16] = {};
+		easyTest::doNotOptimize(local);
+	}
+
+	easyTest::NoAllocScope scope;
+	while (scope.next())
+	{
+		if (!scope.isChecking())
+		{
+			int* pValue = new int(1);
+			easyTest::doNotOptimize(pValue);
+			delete pValue;
+		}
+	}
+
+	ASSERT_EQUAL(scope.getNbAllocs(), static_cast<size_t>(1));
+	return true;
+}
+
+TEST_IMPL(Measurement, nestedAllocTrackers)
+{
+	if (!easyTest::stats::isAllocTrackingAvailable())
+		return true;
+
+	easyTest::stats::AllocTracker outer;
+	easyTest::stats::AllocTracker inner;
+	outer.start();
+
+	char* pLarge = new char[4096];
+	easyTest::doNotOptimize(pLarge);
+	delete[] pLarge;
+
+	//The inner tracker starts after the outer peak
+	inner.start();
+	char* pSmall = new char[64];
+	easyTest::doNotOptimize(pSmall);
+	delete[] pSmall;
+	inner.stop();
+
+	outer.stop();
+
+	ASSERT_GREATER_OR_EQUAL(inner.getPeakLiveBytes(), 64LL);
+	ASSERT_LESS_THAN(inner.getPeakLiveBytes(), 4096LL);
+	ASSERT_GREATER_OR_EQUAL(outer.getPeakLiveBytes(), 4096LL);
+	return true;
+}
+
+TEST_IMPL(Measurement, resourceUsage)
+{
+	using easyTest::stats::ResourceCounter;
+
+	easyTest::stats::ResourceUsage usage;
+	ASSERT_TRUE(usage.start());
+	ASSERT_FALSE(usage.start());
+	ASSERT_EQUAL(usage.getValue(ResourceCounter::USER_TIME), -1LL);
+
+	//Fresh pages of a large block are faulted in on first access
+	const size_t sizeInBytes = 4 * 1024 * 1024;
+	unsigned char* pBlock = new unsigned char[sizeInBytes];
+	for (size_t i = 0; i < sizeInBytes; i += 4096)
+		pBlock[i] = static_cast<unsigned char>(i);
+
+	easyTest::doNotOptimize(pBlock);
+	delete[] pBlock;
+
+	usage.stop();
+	ASSERT_FALSE(usage.isRunning());
+
+	for (int i = 0; i < static_cast<int>(ResourceCounter::COUNT); ++i)
+		ASSERT_GREATER_OR_EQUAL(usage.getValue(static_cast<ResourceCounter>(i)), -1LL);
+
+#ifdef __linux__
+	ASSERT_GREATER_THAN(usage.getValue(ResourceCounter::MINOR_FAULTS), 0LL);
+	ASSERT_GREATER_OR_EQUAL(usage.getValue(ResourceCounter::VOLUNTARY_SWITCHES), 0LL);
+#endif //__linux__
+
+	ASSERT_GREATER_OR_EQUAL(usage.getValue(ResourceCounter::USER_TIME), 0LL);
+	return true;
+}
+
+TEST_IMPL(Measurement, ioUsage)
+{
+	using easyTest::stats::IoCounter;
+
+	easyTest::stats::IoUsage io;
+	ASSERT_TRUE(io.start());
+	ASSERT_FALSE(io.start());
+	ASSERT_EQUAL(io.getTotalChars(), -1LL);
+	io.stop();
+
+	//Reading the accounting file is not counted
+	if (io.isAvailable())
+	{
+		ASSERT_EQUAL(io.getValue(IoCounter::READ_SYSCALLS), 0LL);
+		ASSERT_EQUAL(io.getTotalChars(), 0LL);
+	}
+
+	const test::TempFile file("Measurement.io");
+	const char* const path = file.getPath();
+	ASSERT_TRUE(path != nullptr);
+
+	unsigned char data[4096] = {};
+
+	ASSERT_TRUE(io.start());
+	std::FILE* pFile = std::fopen(path, "wb");
+	ASSERT_TRUE(pFile != nullptr);
+	for (int i = 0; i < 16; ++i)
+		std::fwrite(data, 1, sizeof(data), pFile);
+
+	std::fclose(pFile);
+	io.stop();
+
+	if (!io.isAvailable())
+	{
+		for (int i = 0; i < static_cast<int>(IoCounter::COUNT); ++i)
+			ASSERT_EQUAL(io.getValue(static_cast<IoCounter>(i)), -1LL);
+
+		return true;
+	}
+
+	ASSERT_GREATER_OR_EQUAL(io.getValue(IoCounter::WRITTEN_CHARS), static_cast<long long>(16 * sizeof(data)));
+	ASSERT_GREATER_THAN(io.getValue(IoCounter::WRITE_SYSCALLS), 0LL);
+	ASSERT_EQUAL(io.getTotalChars(), io.getValue(IoCounter::READ_CHARS) + io.getValue(IoCounter::WRITTEN_CHARS));
+	return true;
+}
+
+TEST_IMPL(Measurement, benchEnvironment)
+{
+	using easyTest::stats::EnvironmentWarning;
+
+	easyTest::stats::BenchEnvironment env;
+	easyTest::stats::collectBenchEnvironment(env);
+	ASSERT_GREATER_OR_EQUAL(env.nbCpus, 1u);
+	ASSERT_TRUE(env.kernel[0] != '\0');
+	ASSERT_GREATER_OR_EQUAL(env.turbo, -1);
+	ASSERT_LESS_OR_EQUAL(env.turbo, 1);
+	ASSERT_TRUE(env.noise < 0.0);
+	ASSERT_FALSE(env.bPriorityRaised);
+	ASSERT_FALSE(easyTest::stats::hasEnvironmentWarning(env, EnvironmentWarning::NOISE));
+
+	env.noise = easyTest::stats::measureNoise();
+	ASSERT_GREATER_OR_EQUAL(env.noise, 0.0);
+
+	std::snprintf(env.governor, sizeof(env.governor), "performance");
+	env.turbo = 0;
+	env.loadAverage = 0.0;
+	env.noise = 0.0;
+	for (int i = 0; i < static_cast<int>(EnvironmentWarning::COUNT); ++i)
+		ASSERT_FALSE(easyTest::stats::hasEnvironmentWarning(env, static_cast<EnvironmentWarning>(i)));
+
+	std::snprintf(env.governor, sizeof(env.governor), "powersave");
+	env.turbo = 1;
+	env.loadAverage = easyTest::stats::LOAD_AVERAGE_WARNING_THRESHOLD;
+	env.noise = 2.0 * easyTest::stats::NOISE_WARNING_THRESHOLD;
+	for (int i = 0; i < static_cast<int>(EnvironmentWarning::COUNT); ++i)
+		ASSERT_TRUE(easyTest::stats::hasEnvironmentWarning(env, static_cast<EnvironmentWarning>(i)));
+
+	//Unavailable values never raise warnings
+	env.governor[0] = '\0';
+	env.turbo = -1;
+	env.loadAverage = -1.0;
+	env.noise = -1.0;
+	for (int i = 0; i < static_cast<int>(EnvironmentWarning::COUNT); ++i)
+		ASSERT_FALSE(easyTest::stats::hasEnvironmentWarning(env, static_cast<EnvironmentWarning>(i)));
+
+	return true;
+}
+
+TEST_IMPL(Measurement, threadProfiler)
+{
+	using namespace easyTest::stats;
+
+	const test::TempFile file("Measurement.profile");
+	const char* const path = file.getPath();
+	ASSERT_TRUE(path != nullptr);
+
+	const bool bWasEnabled = isProfilingEnabled();
+	if (!setProfilingEnabled(true))
+		return true;
+
+	bool bStarted = false;
+	bool bStartedTwice = true;
+	bool bWritten = false;
+	{
+		//A local profiler never hands its stacks over to the profile of the
+		//runner. When the runner profiles the test cases, this thread
+		//already has a profiler and the local one is not available.
+		ThreadProfiler profiler(true);
+		if (!profiler.isAvailable())
+		{
+			setProfilingEnabled(bWasEnabled);
+			return true;
+		}
+
+		bStarted = profiler.startCase();
+		bStartedTwice = profiler.startCase();
+
+#ifdef __linux__
+		//Samples are taken right away, whatever the CPU time of the thread
+		for (int i = 0; i < 3; ++i)
+			std::raise(SIGPROF);
+#endif //__linux__
+
+		profiler.stopCase("ProfiledSuite", "raiseSignal");
+		bWritten = profiler.writeProfile(path);
+	}
+
+	setProfilingEnabled(bWasEnabled);
+	ASSERT_TRUE(bStarted);
+	ASSERT_FALSE(bStartedTwice);
+	ASSERT_TRUE(bWritten);
+
+	std::FILE* pFile = std::fopen(path, "r");
+	ASSERT_TRUE(pFile != nullptr);
+
+	size_t nbSamples = 0;
+	char line[4096];
+	while (std::fgets(line, sizeof(line), pFile))
+	{
+		const char* pCount = std::strrchr(line, ' ');
+		if (!std::strncmp(line, "ProfiledSuite::raiseSignal;", 27) && pCount)
+			nbSamples += std::strtoul(pCount + 1, nullptr, 10);
+	}
+
+	std::fclose(pFile);
+	ASSERT_GREATER_OR_EQUAL(nbSamples, size_t(3));
+	return true;
+}
@@ -0,0 +1,117 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../include/easyTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+TEST_SUITE(Metrics)
+{
+	TEST_CASE(timedScopes);
+	TEST_CASE(caseMetrics);
+};
+
+TEST_IMPL(Metrics, timedScopes)
+{
+	using namespace easyTest;
+
+	const ScopeTimings& timings = getScopeTimings();
+	ASSERT_EQUAL(timings.getNbScopes(), size_t(0));
+
+	{
+		TIMED_SCOPE("outer");
+		for (int i = 0; i < 3; ++i)
+		{
+			TIMED_SCOPE("inner");
+			volatile int sum = 0;
+			for (int j = 0; j < 100000; ++j)
+				sum += j;
+		}
+	}
+
+	ASSERT_EQUAL(timings.getNbScopes(), size_t(2));
+	const ScopeTiming& outer = timings.getScope(0);
+	const ScopeTiming& inner = timings.getScope(1);
+	ASSERT_STRING_EQUAL(outer.pSite->getName(), "outer");
+	ASSERT_STRING_EQUAL(inner.pSite->getName(), "inner");
+	ASSERT_EQUAL(outer.nbCalls, size_t(1));
+	ASSERT_EQUAL(inner.nbCalls, size_t(3));
+	ASSERT_GREATER_THAN(inner.realTime, 0LL);
+	ASSERT_GREATER_OR_EQUAL(outer.realTime, inner.realTime);
+
+	//Sites are told apart by address, and are no more recorded once the
+	//table is full
+	static const TimedScopeSite s_sites[MAX_TIMED_SCOPES + 1] = {
+		{"site"}, {"site"}, {"site"}, {"site"},
+		{"site"}, {"site"}, {"site"}, {"site"},
+		{"site"}, {"site"}, {"site"}, {"site"},
+		{"site"}, {"site"}, {"site"}, {"site"},
+		{"site"}};
+
+	ScopeTimings table;
+	for (size_t i = 0; i < MAX_TIMED_SCOPES; ++i)
+	{
+		ASSERT_TRUE(table.find(&s_sites[i]) != nullptr);
+		ASSERT_EQUAL(table.getNbScopes(), i + 1);
+	}
+
+	ASSERT_TRUE(table.find(&s_sites[0]) == &table.getScope(0));
+	ASSERT_TRUE(table.find(&s_sites[MAX_TIMED_SCOPES]) == nullptr);
+	{
+		const TimedScope scope(table, s_sites[MAX_TIMED_SCOPES]);
+	}
+
+	ASSERT_EQUAL(table.getNbScopes(), MAX_TIMED_SCOPES);
+	table.reset();
+	ASSERT_EQUAL(table.getNbScopes(), size_t(0));
+	return true;
+}
+
+TEST_IMPL(Metrics, caseMetrics)
+{
+	using namespace easyTest;
+
+	const CaseMetrics& metrics = getMetrics();
+	ASSERT_EQUAL(metrics.getNbMetrics(), size_t(0));
+
+	ASSERT_TRUE(RECORD_METRIC("compressed_ratio", 0.25));
+	ASSERT_TRUE(RECORD_METRIC("rows_per_sec", 1000));
+	ASSERT_TRUE(RECORD_METRIC("compressed_ratio", 0.5));
+	ASSERT_TRUE(RECORD_METRIC("bytes read/s", 42));
+	ASSERT_FALSE(RECORD_METRIC("", 1.0));
+	ASSERT_FALSE(RECORD_METRIC("infinite", 1.0 / std::atof("0")));
+
+	//Names are sanitized and the last value is kept
+	ASSERT_EQUAL(metrics.getNbMetrics(), size_t(3));
+	ASSERT_STRING_EQUAL(metrics.getMetric(0).name, "compressed_ratio");
+	ASSERT_ALMOST_EQUAL(metrics.getMetric(0).value, 0.5, 1e-12);
+	ASSERT_ALMOST_EQUAL(metrics.getMetric(1).value, 1000.0, 1e-12);
+	ASSERT_STRING_EQUAL(metrics.getMetric(2).name, "bytes_read/s");
+
+	CaseMetrics table;
+	char name[MAX_METRIC_NAME_SIZE + 8];
+	for (size_t i = 0; i < MAX_CASE_METRICS; ++i)
+	{
+		std::snprintf(name, sizeof(name), "metric%zu", i);
+		ASSERT_TRUE(table.record(name, static_cast<double>(i)));
+	}
+
+	ASSERT_FALSE(table.record("oneTooMany", 1.0));
+	ASSERT_TRUE(table.record("metric0", 2.0));
+	ASSERT_EQUAL(table.getNbMetrics(), MAX_CASE_METRICS);
+
+	table.reset();
+	std::memset(name, 'm', sizeof(name) - 1);
+	name[sizeof(name) - 1] = '\0';
+	ASSERT_TRUE(table.record(name, 1.0));
+	ASSERT_EQUAL(std::strlen(table.getMetric(0).name), MAX_METRIC_NAME_SIZE - 1);
+	return true;
+}
@@ -0,0 +1,208 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#include "../include/easyTest.h"
+#include "../src/TestRunner.h"
+#include "../src/ITestListener.h"
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+	//Test suite run by a nested runner, it is not added to the test suites
+	//list so that the main runner never executes it
+	class CountedAsserts final : public easyTest::SpecTestSuite<CountedAsserts>
+	{
+		TEST_CASE(threeAsserts);
+		TEST_CASE(failedExpect);
+	};
+
+	class CountedAssertsReg final : public easyTest::TestSuiteRegistrar
+	{
+	public:
+		//threeAsserts and failedExpect
+		virtual size_t getTestCaseCount() const override final
+		{
+			return 2;
+		}
+
+		virtual easyTest::TestSuite* createTestSuite(easyTest::ITestListener*, unsigned int) const override final
+		{
+			return new(std::nothrow) CountedAsserts();
+		}
+
+		virtual void deleteTestSuite(easyTest::TestSuite* p) const override final
+		{
+			delete p;
+		}
+	};
+
+	//Test suite with a latency budget which cannot be met, run through an
+	//unlisted TestSuiteReg so that its failures reach the nested listener
+	class OverBudget final : public easyTest::SpecTestSuite<OverBudget>
+	{
+		TEST_CASE(zeroBudget);
+	};
+
+	//Ignores every notification of a nested run
+	class NullListener : public easyTest::ITestListener
+	{
+	public:
+		virtual void onEvent(const easyTest::TestEvent&) override {}
+		virtual void onTrace(unsigned int, const easyTest::SrcInfo&, const char*, std::va_list&) override final {}
+		virtual void onUnaryAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*) override final {}
+		virtual void onBinaryAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*, const char*) override final {}
+		virtual void onStringAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*, const char*, size_t, const char*, const char*) override final {}
+		virtual void onDataAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*, const char*, const easyTest::compare::DataDiffReport&) override final {}
+		virtual void onGoldenAssertFailure(unsigned int, const easyTest::SrcInfo&, const char*, const char*, easyTest::compare::GoldenStatus, size_t, size_t, const easyTest::compare::DataDiffReport*) override final {}
+		virtual void onDigestAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*, const char*, const char*) override final {}
+		virtual void onLatencyAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType, const char*, long long, double, size_t, size_t) override {}
+		virtual void onBaselineComparison(const easyTest::BaselineComparison&) override final {}
+		virtual void onRuntimeError(unsigned int, easyTest::RTErrorType, const char*) override final {}
+	};
+
+	//Keeps the assert counts sent with the finish events of a run
+	class AssertCountListener final : public NullListener
+	{
+	public:
+		size_t nbThreeAsserts = 0;
+		size_t nbFailedExpect = 0;
+		size_t nbSuiteAsserts = 0;
+		size_t nbRunnerAsserts = 0;
+
+		virtual void onEvent(const easyTest::TestEvent& event) override final
+		{
+			switch (event.type)
+			{
+			case easyTest::TestEventType::TESTCASE_FINISH:
+				if (!std::strcmp(event.testCaseFinish.testCaseName, "threeAsserts"))
+					nbThreeAsserts = event.testCaseFinish.nbAsserts;
+				else if (!std::strcmp(event.testCaseFinish.testCaseName, "failedExpect"))
+					nbFailedExpect = event.testCaseFinish.nbAsserts;
+				break;
+
+			case easyTest::TestEventType::TESTSUITE_FINISH:
+				nbSuiteAsserts = event.testSuiteFinish.nbAsserts;
+				break;
+
+			case easyTest::TestEventType::TESTRUNNER_FINISH:
+				nbRunnerAsserts = event.testRunnerFinish.nbAsserts;
+				break;
+
+			default:
+				break;
+			}
+		}
+	};
+
+	//Keeps the latency failures and the test case result of a run
+	class LatencyFailureListener final : public NullListener
+	{
+	public:
+		size_t nbFailures = 0;
+		easyTest::AssertType type = easyTest::AssertType::P99_BELOW;
+		long long maxTime = -1;
+		double measuredTime = 0.0;
+		size_t nbRuns = 0;
+		size_t nbOutliers = 0;
+		bool bCaseFinished = false;
+		bool bCaseSuccess = true;
+
+		virtual void onEvent(const easyTest::TestEvent& event) override final
+		{
+			if (event.type == easyTest::TestEventType::TESTCASE_FINISH)
+			{
+				bCaseFinished = true;
+				bCaseSuccess = event.testCaseFinish.bSuccess;
+			}
+		}
+
+		virtual void onLatencyAssertFailure(unsigned int, const easyTest::SrcInfo&, easyTest::AssertType assertType, const char*, long long maxTimeNs, double measuredTimeNs, size_t nbBodyRuns, size_t nbBodyOutliers) override final
+		{
+			nbFailures++;
+			type = assertType;
+			maxTime = maxTimeNs;
+			measuredTime = measuredTimeNs;
+			nbRuns = nbBodyRuns;
+			nbOutliers = nbBodyOutliers;
+		}
+	};
+}
+
+TEST_IMPL(CountedAsserts, threeAsserts)
+{
+	ASSERT_TRUE(true);
+	ASSERT_EQUAL(1, 1);
+	EXPECT_FALSE(false);
+	return true;
+}
+
+TEST_IMPL(CountedAsserts, failedExpect)
+{
+	//Failed asserts are counted too
+	EXPECT_EQUAL(1, 2);
+	ASSERT_TRUE(true);
+	return true;
+}
+
+TEST_IMPL(OverBudget, zeroBudget)
+{
+	//No outlier rejection so that every run is kept
+	setLatencyOptions(1, 7, 0.0);
+
+	//The body lasts far more than the clock resolution
+	int value = 0;
+	EXPECT_MEDIAN_BELOW(for (int i = 0; i < 10000; ++i) easyTest::doNotOptimize(value += i), 0LL);
+	return true;
+}
+
+TEST_SUITE(Runner)
+{
+	TEST_CASE(assertCounts);
+	TEST_CASE(latencyFailure);
+};
+
+TEST_IMPL(Runner, assertCounts)
+{
+	CountedAssertsReg suiteReg;
+	const easyTest::TestSuiteRegistrar* suiteList[] = {&suiteReg};
+	AssertCountListener listener;
+
+	easyTest::TestRunner runner;
+	ASSERT_TRUE(runner.startTestSuites(suiteList, 1, 1, &listener));
+	ASSERT_EQUAL(runner.waitTestsTermination(), size_t(1));
+
+	ASSERT_EQUAL(listener.nbThreeAsserts, size_t(3));
+	ASSERT_EQUAL(listener.nbFailedExpect, size_t(2));
+	ASSERT_EQUAL(listener.nbSuiteAsserts, size_t(5));
+	ASSERT_EQUAL(listener.nbRunnerAsserts, size_t(5));
+	return true;
+}
+
+TEST_IMPL(Runner, latencyFailure)
+{
+	easyTest::TestSuiteReg<OverBudget> suiteReg;
+	const easyTest::TestSuiteRegistrar* suiteList[] = {&suiteReg};
+	LatencyFailureListener listener;
+
+	easyTest::TestRunner runner;
+	ASSERT_TRUE(runner.startTestSuites(suiteList, 1, 1, &listener));
+	ASSERT_EQUAL(runner.waitTestsTermination(), size_t(1));
+
+	ASSERT_TRUE(listener.bCaseFinished);
+	ASSERT_FALSE(listener.bCaseSuccess);
+	ASSERT_EQUAL(listener.nbFailures, size_t(1));
+	ASSERT_TRUE(listener.type == easyTest::AssertType::MEDIAN_BELOW);
+	ASSERT_EQUAL(listener.maxTime, 0LL);
+	ASSERT_GREATER_THAN(listener.measuredTime, 0.0);
+	ASSERT_EQUAL(listener.nbRuns, size_t(7));
+	ASSERT_EQUAL(listener.nbOutliers, size_t(0));
+	return true;
+}
@@ -0,0 +1,81 @@
+/**
+ * EasyTest++
+ *
+ * Copyright (c) 2015, Loïc Le Page
+ *
+ * This project is released under the MIT license.
+ * See: http://opensource.org/licenses/MIT
+ */
+
+#ifndef _TEMPFILE_H_
+#define _TEMPFILE_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <unistd.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#error Unsupported platform: currently supported platforms are\
+       Linux and Windows
+#endif //__linux__
+
+namespace test
+{
+	//Empty file with a unique name in the temporary directory of the system
+	//(TMPDIR or /tmp under Linux), removed with the instance so that a
+	//failed assert never leaves it behind
+	class TempFile final
+	{
+	public:
+		explicit TempFile(const char* prefix)
+		{
+#ifdef __linux__
+			const char* dir = std::getenv("TMPDIR");
+			if (!dir || !dir[0])
+				dir = "/tmp";
+
+			const int length = std::snprintf(m_path, sizeof(m_path), "%s/%s.XXXXXX", dir, prefix);
+			if ((length <= 0) || (static_cast<size_t>(length) >= sizeof(m_path)))
+			{
+				m_path[0] = '\0';
+				return;
+			}
+
+			const int fd = mkstemp(m_path);
+			if (fd == -1)
+				m_path[0] = '\0';
+			else
+				close(fd);
+#elif defined(_WIN32)
+			char dir[MAX_PATH + 1];
+			const DWORD length = GetTempPathA(sizeof(dir), dir);
+			if (!length || (length >= sizeof(dir)) || !GetTempFileNameA(dir, prefix, 0, m_path))
+				m_path[0] = '\0';
+#endif //__linux__
+		}
+
+		~TempFile()
+		{
+			if (m_path[0])
+				std::remove(m_path);
+		}
+
+		//nullptr if the file cannot be created
+		const char* getPath() const
+		{
+			return m_path[0] ? m_path : nullptr;
+		}
+
+	private:
+		TempFile(const TempFile&) = delete;
+		TempFile& operator=(const TempFile&) = delete;
+
+		char m_path[4096];
+	};
+}
+
+#endif //_TEMPFILE_H_